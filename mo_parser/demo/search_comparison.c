@@ -46,12 +46,26 @@ int main(int argc, char* argv[])
 {
     if (argc < 2)
     {
-        fprintf(stderr, "Usage: %s <mo_file>\n", argv[0]);
+        fprintf(stderr, "Usage: %s <mo_file> [LINEAR|BINARY|HASH|GETTEXT|AUTO|MPH|EYTZINGER]\n", argv[0]);
         return 1;
     }
     
+    mo_options_t options;
+    mo_options_init(&options);
+    if (argc > 2)
+    {
+        static const char* names[] = { "LINEAR", "BINARY", "HASH", "GETTEXT", "AUTO", "MPH", "EYTZINGER" };
+        for (int i = 0; i < (int)(sizeof(names)/sizeof(names[0])); i++)
+        {
+            if (strcmp(argv[2], names[i]) == 0)
+            {
+                options.search_method = (mo_search_method_t)(MO_SEARCH_LINEAR + i);
+            }
+        }
+    }
+    
     mo_context_t* ctx = NULL;
-    mo_error_t err = mo_context_create(argv[1], &ctx);
+    mo_error_t err = mo_context_create_ex(argv[1], &options, &ctx);
     
     if (err != MO_SUCCESS)
     {
@@ -117,6 +131,22 @@ int main(int argc, char* argv[])
     printf("Time for %d lookups: %.3f seconds\n", 
            num_tests * sizeof(test_strings)/sizeof(test_strings[0]), total_time);
     
+    /* 测试批量查找 */
+    printf("\nTesting batch lookups...\n");
+    const size_t batch_size = sizeof(test_strings)/sizeof(test_strings[0]);
+    const char* batch_out[sizeof(test_strings)/sizeof(test_strings[0])];
+    start = clock();
+    
+    for (int i = 0; i < num_tests; i++)
+    {
+        mo_translate_batch(ctx, test_strings, NULL, batch_out, batch_size);
+    }
+    
+    end = clock();
+    total_time = ((double)(end - start)) / CLOCKS_PER_SEC;
+    printf("Time for %d batched lookups: %.3f seconds\n", 
+           (int)(num_tests * batch_size), total_time);
+    
     /* 测试随机字符串查找（模拟未命中情况） */
     printf("\nTesting random strings (mostly misses)...\n");
     srand(time(NULL));
@@ -146,15 +176,11 @@ int main(int argc, char* argv[])
                stats.total_lookups > 0 ? 
                (float)stats.cache_hits / stats.total_lookups * 100.0f : 0.0f);
         printf("  Cache misses: %u\n", stats.cache_misses);
-        #ifdef MO_SEARCH_METHOD_HASH
         printf("  Hash collisions: %u\n", stats.hash_collisions);
-        #endif
-        #if defined(MO_SEARCH_METHOD_LINEAR) || defined(MO_SEARCH_METHOD_BINARY)
         printf("  Comparisons: %u (avg: %.1f per lookup)\n", 
                stats.comparisons,
                stats.total_lookups > 0 ? 
                (float)stats.comparisons / stats.total_lookups : 0.0f);
-        #endif
     }
     #endif
     
@@ -0,0 +1,148 @@
+/**
+ * @file test_common.h
+ * @brief 测试程序共用的辅助函数：在内存中生成MO文件、比较翻译结果
+ */
+
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 测试目录条目：原始字符串与翻译均可包含NUL分隔的多个形式 */
+typedef struct {
+    const char* original;
+    size_t original_len;
+    const char* translation;
+    size_t translation_len;
+} entry_t;
+
+#define ENTRY(o, t) { o, sizeof(o) - 1, t, sizeof(t) - 1 }
+#define COUNT(a) (sizeof(a) / sizeof(a[0]))
+
+/**
+ * @brief hashpjw（与msgfmt写入哈希表时使用的算法相同）
+ */
+static inline uint32_t hash_pjw(const char* str, size_t len)
+{
+    uint32_t hash = 0;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash = (hash << 4) + (uint8_t)str[i];
+        uint32_t g = hash & 0xF0000000u;
+        if (g != 0)
+        {
+            hash ^= g >> 24;
+            hash ^= g;
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief 在内存中生成小端MO文件
+ *
+ * @param[in] entries 条目，按给定顺序写入字符串表
+ * @param[in] count 条目数
+ * @param[in] hash_table 是否按msgfmt的方式写入哈希表
+ * @param[out] size 文件大小
+ * @return uint8_t* 以malloc分配的文件数据，由调用者释放
+ */
+static inline uint8_t* build_mo(const entry_t* entries, size_t count, bool hash_table,
+                                size_t* size)
+{
+    uint32_t header_size = 28;
+    uint32_t table_size = (uint32_t)count * 8;
+    uint32_t offset = header_size + table_size * 2;
+    uint32_t hash_size = 0;
+    uint32_t hash_offset = 0;
+    size_t total = offset;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        total += entries[i].original_len + 1 + entries[i].translation_len + 1;
+    }
+
+    /* 哈希表放在字符串之后，4字节对齐，大小为不小于4n/3的素数 */
+    if (hash_table)
+    {
+        hash_offset = (uint32_t)((total + 3) & ~(size_t)3);
+        hash_size = 7;
+        while (hash_size * 3 < count * 4)
+        {
+            hash_size += 2;
+        }
+        for (uint32_t d = 3; d * d <= hash_size; d += 2)
+        {
+            if (hash_size % d == 0)
+            {
+                hash_size += 2;
+                d = 1;
+            }
+        }
+        total = hash_offset + (size_t)hash_size * 4;
+    }
+
+    uint8_t* data = calloc(1, total);
+    uint32_t* words = (uint32_t*)data;
+    words[0] = 0x950412de;
+    words[1] = 0;
+    words[2] = (uint32_t)count;
+    words[3] = header_size;
+    words[4] = header_size + table_size;
+    words[5] = hash_size;
+    words[6] = hash_offset;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t* orig = (uint32_t*)(data + header_size) + i * 2;
+        orig[0] = (uint32_t)entries[i].original_len;
+        orig[1] = offset;
+        memcpy(data + offset, entries[i].original, entries[i].original_len);
+        offset += (uint32_t)entries[i].original_len + 1;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t* trans = (uint32_t*)(data + header_size + table_size) + i * 2;
+        trans[0] = (uint32_t)entries[i].translation_len;
+        trans[1] = offset;
+        memcpy(data + offset, entries[i].translation, entries[i].translation_len);
+        offset += (uint32_t)entries[i].translation_len + 1;
+    }
+
+    /* 键为msgid（复数条目取单数部分），表项存放序号加1 */
+    uint32_t* table = (uint32_t*)(data + hash_offset);
+    for (size_t i = 0; i < count && hash_table; i++)
+    {
+        uint32_t hash = hash_pjw(entries[i].original, strlen(entries[i].original));
+        uint32_t index = hash % hash_size;
+        uint32_t incr = 1 + hash % (hash_size - 2);
+        while (table[index] != 0)
+        {
+            index = index >= hash_size - incr ? index - (hash_size - incr) : index + incr;
+        }
+        table[index] = (uint32_t)i + 1;
+    }
+
+    *size = total;
+    return data;
+}
+
+/**
+ * @brief 比较翻译结果，不同时输出说明
+ * @return int 不同时返回1，用于累加失败次数
+ */
+static inline int check(const char* what, const char* got, const char* expected)
+{
+    if (strcmp(got, expected) != 0)
+    {
+        fprintf(stderr, "FAIL %s: got '%s', expected '%s'\n", what, got, expected);
+        return 1;
+    }
+    return 0;
+}
+
+#endif /* TEST_COMMON_H */
@@ -1,7 +1,252 @@
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "mo_parser.h"
+#include "i18n_utils.h"
+#include "test_common.h"
+
+/**
+ * @brief 固定的I18N_T调用点（每次调用使用同一个缓存槽位）
+ */
+static const char* translate_title(void)
+{
+    return I18N_T("Title");
+}
+
+/* 前缀枚举的检查状态 */
+typedef struct {
+    mo_context_t* ctx;
+    const char* last;       /**< 上一个枚举到的键 */
+    size_t last_len;
+    int unordered;          /**< 相邻两个键不是升序的次数 */
+    int mismatched;         /**< 翻译与单条查找结果不一致的次数 */
+} prefix_check_t;
+
+static bool check_prefix_entry(const char* original, size_t original_len,
+                               const char* translation, void* user_data)
+{
+    prefix_check_t* check = (prefix_check_t*)user_data;
+    
+    if (check->last)
+    {
+        size_t n = check->last_len < original_len ? check->last_len : original_len;
+        int cmp = memcmp(check->last, original, n);
+        if (cmp > 0 || (cmp == 0 && check->last_len >= original_len))
+        {
+            check->unordered++;
+        }
+    }
+    if (mo_translate_n(check->ctx, original, original_len) != translation)
+    {
+        check->mismatched++;
+    }
+    check->last = original;
+    check->last_len = original_len;
+    return true;
+}
+
+static bool stop_after_first(const char* original, size_t original_len,
+                             const char* translation, void* user_data)
+{
+    (void)original;
+    (void)original_len;
+    (void)translation;
+    (void)user_data;
+    return false;
+}
+
+/* 分页读取的回调：从打开的文件中读取 */
+static bool read_file(void* user_data, size_t offset, void* buffer, size_t size)
+{
+    FILE* file = (FILE*)user_data;
+    return fseek(file, (long)offset, SEEK_SET) == 0 && fread(buffer, 1, size, file) == size;
+}
+
+/* 分页枚举到的翻译与完整载入的上下文（check->ctx）一致 */
+static bool check_paged_entry(const char* original, size_t original_len,
+                              const char* translation, void* user_data)
+{
+    prefix_check_t* check = (prefix_check_t*)user_data;
+    if (strcmp(mo_translate_n(check->ctx, original, original_len), translation) != 0)
+    {
+        check->mismatched++;
+    }
+    return true;
+}
+
+/* 哈希值写入MPH段和生成的C表，在任何主机上都必须与这些值相同 */
+static int check_hash_vectors(void)
+{
+    static const struct {
+        const char* str;
+        uint32_t hash;
+    } vectors[] = {
+        { "", 0x832d92a4u },
+        { "Title", 0xfe0e87edu },
+        { "Duty-cycle", 0x83135f7bu },
+        { "New screen", 0xe034883du },
+        { "1Frequency1 with a long tail", 0xe4669b01u },
+    };
+    int failures = 0;
+    
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+    {
+        mo_key_t key = mo_key_make(vectors[i].str, strlen(vectors[i].str));
+        if (key.hash != vectors[i].hash)
+        {
+            fprintf(stderr, "Hash of '%s' is 0x%08x, expected 0x%08x\n",
+                    vectors[i].str, key.hash, vectors[i].hash);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/* 哈希段的哈希版本与库不符时不能使用该段，回退为GETTEXT后结果不变 */
+static int check_mph_version(const char* filename, const char* const* strings, size_t count)
+{
+    static const uint32_t magic = 0x3248504D;   /* "MPH2"，段尾最后一个字 */
+    mo_options_t options;
+    mo_context_t* mph = NULL;
+    mo_context_t* stale = NULL;
+    uint8_t* data = NULL;
+    uint32_t word = 0;
+    long size = 0;
+    int failures = 0;
+    FILE* file = fopen(filename, "rb");
+    
+    if (!file || fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 64 ||
+        fseek(file, 0, SEEK_SET) != 0 || !(data = (uint8_t*)malloc((size_t)size)) ||
+        fread(data, 1, (size_t)size, file) != (size_t)size)
+    {
+        if (file)
+        {
+            fclose(file);
+        }
+        free(data);
+        return 1;
+    }
+    fclose(file);
+    
+    memcpy(&word, data + size - 4, sizeof(word));
+    if (word != magic)
+    {
+        /* 不带哈希段（或与主机字节序相反）的文件不检查 */
+        free(data);
+        return 0;
+    }
+    
+    mo_options_init(&options);
+    options.search_method = MO_SEARCH_MPH;
+    if (mo_context_create_ex(filename, &options, &mph) != MO_SUCCESS ||
+        strcmp(mo_get_search_method(mph), "MPH") != 0)
+    {
+        fprintf(stderr, "%s: perfect hash section not used\n", filename);
+        failures++;
+    }
+    
+    /* 段尾倒数第二个字为哈希版本 */
+    word = 1;
+    memcpy(data + size - 8, &word, sizeof(word));
+    if (mo_context_create_from_memory_ex(data, (size_t)size, &options, &stale) != MO_SUCCESS ||
+        strcmp(mo_get_search_method(stale), "GETTEXT") != 0)
+    {
+        fprintf(stderr, "%s: stale perfect hash section was not rejected\n", filename);
+        failures++;
+    }
+    for (size_t i = 0; mph && stale && i < count; i++)
+    {
+        if (strcmp(mo_translate(mph, strings[i]), mo_translate(stale, strings[i])) != 0)
+        {
+            fprintf(stderr, "%s: fallback mismatch for '%s'\n", filename, strings[i]);
+            failures++;
+        }
+    }
+    
+    mo_context_free(stale);
+    mo_context_free(mph);
+    free(data);
+    return failures;
+}
+
+/* 分页读取的回调：从内存中的MO文件读取 */
+typedef struct {
+    const uint8_t* data;
+    size_t size;
+} memory_file_t;
+
+static bool read_memory(void* user_data, size_t offset, void* buffer, size_t size)
+{
+    const memory_file_t* file = (const memory_file_t*)user_data;
+    if (offset > file->size || size > file->size - offset)
+    {
+        return false;
+    }
+    memcpy(buffer, file->data + offset, size);
+    return true;
+}
+
+/* 原文远长于页和结果缓冲区时，分页目录逐页计算哈希值，仍能找到条目 */
+static int check_paged_long_keys(void)
+{
+    enum { LONG_LEN = 5000 };
+    char* long_key = (char*)malloc(LONG_LEN + 1);
+    char* long_plural = (char*)malloc(LONG_LEN + sizeof("\0files"));
+    mo_paged_options_t options;
+    mo_context_t* paged = NULL;
+    memory_file_t file;
+    int failures = 0;
+    
+    if (!long_key || !long_plural)
+    {
+        free(long_key);
+        free(long_plural);
+        return 1;
+    }
+    memset(long_key, 'k', LONG_LEN);
+    long_key[LONG_LEN] = '\0';
+    memset(long_plural, 'p', LONG_LEN);
+    memcpy(long_plural + LONG_LEN, "\0files", sizeof("\0files"));
+    
+    entry_t entries[] = {
+        ENTRY("", "Content-Type: text/plain; charset=UTF-8\n"
+                  "Plural-Forms: nplurals=2; plural=(n != 1);\n"),
+        { long_key, LONG_LEN, "long", 4 },
+        { long_plural, LONG_LEN + 6, "one\0many", 8 },
+        ENTRY("Title", "title"),
+    };
+    file.data = build_mo(entries, COUNT(entries), false, &file.size);
+    
+    mo_paged_options_init(&options);
+    options.read = read_memory;
+    options.user_data = &file;
+    options.size = file.size;
+    options.page_size = 16;
+    options.page_count = 2;
+    options.result_size = 32;
+    if (mo_context_create_paged(&options, &paged) != MO_SUCCESS)
+    {
+        fprintf(stderr, "Failed to create paged context with long keys\n");
+        failures++;
+    }
+    else
+    {
+        failures += check("paged long msgid", mo_translate(paged, long_key), "long");
+        failures += check("paged long singular",
+                          mo_translate_cp(paged, NULL, long_plural, "files", 1), "one");
+        failures += check("paged long plural",
+                          mo_translate_cp(paged, NULL, long_plural, "files", 3), "many");
+        failures += check("paged short msgid", mo_translate(paged, "Title"), "title");
+    }
+    
+    mo_context_free(paged);
+    free((void*)file.data);
+    free(long_plural);
+    free(long_key);
+    return failures;
+}
 
 int main(int argc, char* argv[])
 {
@@ -14,6 +259,11 @@ int main(int argc, char* argv[])
     }
     else
     {
+        if (check_hash_vectors() != 0 || check_paged_long_keys() != 0)
+        {
+            exit = 1;
+        }
+    
         /* 测试查找 */
         static const char* test_strings[] = {
             "Frequency",
@@ -55,11 +305,325 @@ int main(int argc, char* argv[])
             {
                 printf("Loaded MO file with %u strings\n", mo_get_string_count(ctx));
                 printf("Search method is %s\n", mo_get_search_method(ctx));
+                /* 头部在加载时解析为元数据，不再作为普通条目参与查找 */
+                const mo_metadata_t* metadata = mo_get_metadata(ctx);
+                printf("Language '%s', charset '%s', nplurals %u\n",
+                       mo_get_language(ctx), mo_get_charset(ctx), metadata->nplurals);
+                if (strcmp(mo_get_charset(ctx), "UTF-8") != 0 || mo_get_language(ctx)[0] == '\0' ||
+                    strcmp(mo_get_plural_forms(ctx), metadata->plural_forms) != 0 ||
+                    strcmp(mo_translate(ctx, ""), "") != 0 ||
+                    strcmp(mo_translate_cp(ctx, NULL, "", NULL, 0), "") != 0)
+                {
+                    fprintf(stderr, "Header metadata mismatch\n");
+                    exit = 1;
+                }
                 for (int i = 0; i < sizeof(test_strings)/sizeof(test_strings[0]); i++)
                 {
                     const char* translated = mo_translate(ctx, test_strings[i]);
                     printf("'%s' -> '%s'\n", test_strings[i], translated);
                 }
+                /* 翻译键在各策略的上下文之间共用，每换一个上下文重新绑定 */
+                mo_key_t keys[sizeof(test_strings)/sizeof(test_strings[0])];
+                for (int i = 0; i < sizeof(test_strings)/sizeof(test_strings[0]); i++)
+                {
+                    keys[i] = mo_key_make(test_strings[i], strlen(test_strings[i]));
+                }
+                /* 各查找策略的结果必须一致 */
+                static const mo_search_method_t methods[] = {
+                    MO_SEARCH_LINEAR,
+                    MO_SEARCH_BINARY,
+                    MO_SEARCH_HASH,
+                    MO_SEARCH_GETTEXT,
+                    MO_SEARCH_MPH,
+                    MO_SEARCH_EYTZINGER,
+                    MO_SEARCH_AUTO,
+                };
+                size_t all_count = 0;
+                size_t prefix_count = 0;
+                for (int m = 0; m < sizeof(methods)/sizeof(methods[0]); m++)
+                {
+                    mo_options_t options;
+                    mo_context_t* other = NULL;
+                    
+                    mo_options_init(&options);
+                    options.search_method = methods[m];
+                    if (mo_context_create_ex(argv[arg_idx], &options, &other) != MO_SUCCESS)
+                    {
+                        fprintf(stderr, "Failed to load MO file with method %d\n", (int)methods[m]);
+                        exit = 1;
+                        continue;
+                    }
+                    for (int i = 0; i < sizeof(test_strings)/sizeof(test_strings[0]); i++)
+                    {
+                        if (strcmp(mo_translate(ctx, test_strings[i]),
+                                   mo_translate(other, test_strings[i])) != 0)
+                        {
+                            fprintf(stderr, "Mismatch for '%s' with method %s\n",
+                                    test_strings[i], mo_get_search_method(other));
+                            exit = 1;
+                        }
+                    }
+                    if (strcmp(mo_get_language(other), mo_get_language(ctx)) != 0 ||
+                        strcmp(mo_translate(other, ""), "") != 0)
+                    {
+                        fprintf(stderr, "Header handled differently with method %s\n",
+                                mo_get_search_method(other));
+                        exit = 1;
+                    }
+                    /* 批量查找与单条查找结果一致 */
+                    const char* batch[sizeof(test_strings)/sizeof(test_strings[0])];
+                    mo_translate_batch(other, test_strings, NULL, batch,
+                                       sizeof(test_strings)/sizeof(test_strings[0]));
+                    for (int i = 0; i < sizeof(test_strings)/sizeof(test_strings[0]); i++)
+                    {
+                        if (batch[i] != mo_translate(other, test_strings[i]))
+                        {
+                            fprintf(stderr, "Batch mismatch for '%s' with method %s\n",
+                                    test_strings[i], mo_get_search_method(other));
+                            exit = 1;
+                        }
+                    }
+                    /* 按键查找（首次解析并绑定，第二次使用绑定）与单条查找结果一致 */
+                    for (int round = 0; round < 2; round++)
+                    {
+                        for (int i = 0; i < sizeof(test_strings)/sizeof(test_strings[0]); i++)
+                        {
+                            if (mo_translate_key(other, &keys[i]) != mo_translate(other, test_strings[i]))
+                            {
+                                fprintf(stderr, "Key mismatch for '%s' with method %s\n",
+                                        test_strings[i], mo_get_search_method(other));
+                                exit = 1;
+                            }
+                        }
+                    }
+                    /* 前缀枚举：各策略枚举到的条目数一致，有序索引按字节序枚举 */
+                    prefix_check_t check = { other, NULL, 0, 0, 0 };
+                    size_t count = mo_foreach_prefix(other, NULL, 0, check_prefix_entry, &check);
+                    size_t count_f = mo_foreach_prefix(other, "F", 1, check_prefix_entry,
+                                                       &(prefix_check_t){ other, NULL, 0, 0, 0 });
+                    if (m == 0)
+                    {
+                        all_count = count;
+                        prefix_count = count_f;
+                    }
+                    if (count != all_count || count_f != prefix_count || check.mismatched != 0 ||
+                        (mo_foreach_prefix(other, NULL, 0, stop_after_first, NULL) != (count ? 1 : 0)) ||
+                        ((methods[m] == MO_SEARCH_BINARY || methods[m] == MO_SEARCH_EYTZINGER) &&
+                         check.unordered != 0))
+                    {
+                        fprintf(stderr, "Prefix enumeration mismatch with method %s\n",
+                                mo_get_search_method(other));
+                        exit = 1;
+                    }
+                    /* 延迟建立索引：创建后立即可查，后台索引发布前后结果都与同步建立时一致 */
+                    mo_context_t* lazy = NULL;
+                    options.lazy_index = true;
+                    if (mo_context_create_ex(argv[arg_idx], &options, &lazy) != MO_SUCCESS)
+                    {
+                        fprintf(stderr, "Failed to load MO file lazily with method %d\n", (int)methods[m]);
+                        exit = 1;
+                    }
+                    for (int round = 0; lazy && round < 2; round++)
+                    {
+                        for (int i = 0; i < sizeof(test_strings)/sizeof(test_strings[0]); i++)
+                        {
+                            if (strcmp(mo_translate(lazy, test_strings[i]),
+                                       mo_translate(other, test_strings[i])) != 0)
+                            {
+                                fprintf(stderr, "Lazy mismatch for '%s' with method %s (%s)\n",
+                                        test_strings[i], mo_get_search_method(other),
+                                        mo_get_search_method(lazy));
+                                exit = 1;
+                            }
+                        }
+                        /* 第二轮在索引发布后进行 */
+                        for (int wait = 0; round == 0 && wait < 5000 &&
+                             strcmp(mo_get_search_method(lazy), mo_get_search_method(other)) != 0; wait++)
+                        {
+                            struct timespec delay = { 0, 1000000 };
+                            nanosleep(&delay, NULL);
+                        }
+                    }
+                    if (lazy && strcmp(mo_get_search_method(lazy), mo_get_search_method(other)) != 0)
+                    {
+                        fprintf(stderr, "Lazy index for method %s was not published\n",
+                                mo_get_search_method(other));
+                        exit = 1;
+                    }
+                    if (lazy && strcmp(mo_get_language(lazy), mo_get_language(other)) != 0)
+                    {
+                        fprintf(stderr, "Lazy index for method %s lost the header metadata\n",
+                                mo_get_search_method(other));
+                        exit = 1;
+                    }
+                    mo_context_free(lazy);
+                    printf("Search method %s: consistent\n", mo_get_search_method(other));
+                    mo_memory_usage_t usage;
+                    if (mo_get_memory_usage(other, &usage))
+                    {
+                        printf("  Memory: context=%zu, data=%zu (%s), index=%zu, heap=%zu\n",
+                               usage.context_bytes, usage.data_bytes,
+                               usage.data_on_heap ? "heap" : "mapped",
+                               usage.index_bytes, usage.heap_bytes);
+                    }
+                    mo_context_free(other);
+                }
+                if (check_mph_version(argv[arg_idx], test_strings,
+                                      sizeof(test_strings)/sizeof(test_strings[0])) != 0)
+                {
+                    exit = 1;
+                }
+                /* Bloom过滤器：不漏掉任何条目，未命中的查找多数由过滤器直接判定 */
+                static const mo_search_method_t bloom_methods[] = {
+                    MO_SEARCH_LINEAR,
+                    MO_SEARCH_BINARY,
+                    MO_SEARCH_HASH,
+                };
+                for (int m = 0; m < sizeof(bloom_methods)/sizeof(bloom_methods[0]); m++)
+                {
+                    mo_options_t options;
+                    mo_context_t* bloom = NULL;
+                    
+                    mo_options_init(&options);
+                    options.search_method = bloom_methods[m];
+                    options.bloom_filter = true;
+                    if (mo_context_create_ex(argv[arg_idx], &options, &bloom) != MO_SUCCESS)
+                    {
+                        fprintf(stderr, "Failed to load MO file with a Bloom filter\n");
+                        exit = 1;
+                        continue;
+                    }
+                    prefix_check_t check = { bloom, NULL, 0, 0, 0 };
+                    int mismatched = 0;
+                    for (int i = 0; i < sizeof(test_strings)/sizeof(test_strings[0]); i++)
+                    {
+                        mismatched += strcmp(mo_translate(bloom, test_strings[i]),
+                                             mo_translate(ctx, test_strings[i])) != 0;
+                    }
+                    if (mismatched != 0 || strcmp(mo_translate(bloom, ""), "") != 0 ||
+                        mo_foreach_prefix(bloom, NULL, 0, check_prefix_entry, &check) != all_count ||
+                        check.mismatched != 0)
+                    {
+                        fprintf(stderr, "Bloom filter mismatch with method %s\n",
+                                mo_get_search_method(bloom));
+                        exit = 1;
+                    }
+                    mo_stats_t bloom_stats;
+                    if (mo_get_stats(bloom, &bloom_stats))
+                    {
+                        printf("Bloom filter with %s: %u of %u lookups missed, %u rejected by the filter\n",
+                               mo_get_search_method(bloom), bloom_stats.lookup_misses,
+                               bloom_stats.total_lookups, bloom_stats.bloom_rejects);
+                        if (bloom_stats.lookup_misses == 0 ||
+                            bloom_stats.bloom_rejects > bloom_stats.lookup_misses)
+                        {
+                            fprintf(stderr, "Miss counters are inconsistent\n");
+                            exit = 1;
+                        }
+                    }
+                    mo_context_free(bloom);
+                }
+                
+                /* 分页读取：页缓存远小于文件，结果与完整载入的上下文一致 */
+                FILE* file = fopen(argv[arg_idx], "rb");
+                mo_paged_options_t paged_options;
+                mo_context_t* paged = NULL;
+                mo_paged_options_init(&paged_options);
+                paged_options.read = read_file;
+                paged_options.user_data = file;
+                paged_options.page_size = 64;
+                paged_options.page_count = 4;
+                if (file && fseek(file, 0, SEEK_END) == 0)
+                {
+                    paged_options.size = (size_t)ftell(file);
+                }
+                if (!file || mo_context_create_paged(&paged_options, &paged) != MO_SUCCESS)
+                {
+                    fprintf(stderr, "Failed to open MO file in paged mode\n");
+                    exit = 1;
+                }
+                else
+                {
+                    prefix_check_t paged_check = { ctx, NULL, 0, 0, 0 };
+                    int mismatched = 0;
+                    for (int i = 0; i < sizeof(test_strings)/sizeof(test_strings[0]); i++)
+                    {
+                        if (strcmp(mo_translate(paged, test_strings[i]),
+                                   mo_translate(ctx, test_strings[i])) != 0 ||
+                            strcmp(mo_translate_key(paged, &keys[i]),
+                                   mo_translate(ctx, test_strings[i])) != 0)
+                        {
+                            mismatched++;
+                        }
+                    }
+                    if (mismatched != 0 ||
+                        strcmp(mo_translate(paged, ""), "") != 0 ||
+                        strcmp(mo_get_language(paged), mo_get_language(ctx)) != 0 ||
+                        strcmp(mo_translate_cp(paged, NULL, "%d file", "%d files", 5),
+                               mo_translate_cp(ctx, NULL, "%d file", "%d files", 5)) != 0 ||
+                        mo_foreach_prefix(paged, NULL, 0, check_paged_entry, &paged_check) != all_count ||
+                        mo_foreach_prefix(paged, "F", 1, check_paged_entry, &paged_check) != prefix_count ||
+                        paged_check.mismatched != 0)
+                    {
+                        fprintf(stderr, "Paged context mismatch\n");
+                        exit = 1;
+                    }
+                    
+                    /* 返回的翻译会被后续查找覆盖：I18N_T的槽位不能保存它，批量查找被拒绝 */
+                    i18n_set_context(paged);
+                    for (int round = 0; round < 64 && mismatched == 0; round++)
+                    {
+                        if (strcmp(translate_title(), mo_translate(ctx, "Title")) != 0)
+                        {
+                            fprintf(stderr, "I18N_T kept a paged result after %d rounds\n", round);
+                            mismatched++;
+                        }
+                        for (int i = 0; i < sizeof(test_strings)/sizeof(test_strings[0]); i++)
+                        {
+                            mo_translate(paged, test_strings[i]);
+                        }
+                    }
+                    i18n_set_context(NULL);
+                    
+                    const char* batch[sizeof(test_strings)/sizeof(test_strings[0])];
+                    size_t batch_count = sizeof(test_strings)/sizeof(test_strings[0]);
+                    if (mo_translate_batch(paged, test_strings, NULL, batch, batch_count) != 0)
+                    {
+                        fprintf(stderr, "Batch lookup on a paged context was not rejected\n");
+                        mismatched++;
+                    }
+                    for (size_t i = 0; i < batch_count; i++)
+                    {
+                        if (batch[i] != test_strings[i])
+                        {
+                            mismatched++;
+                        }
+                    }
+                    if (mismatched != 0)
+                    {
+                        exit = 1;
+                    }
+                    
+                    mo_stats_t paged_stats;
+                    if (mo_get_stats(paged, &paged_stats) &&
+                        (paged_stats.page_hits == 0 || paged_stats.page_misses == 0))
+                    {
+                        fprintf(stderr, "Page cache counters were not updated\n");
+                        exit = 1;
+                    }
+                    mo_memory_usage_t usage;
+                    if (mo_get_memory_usage(paged, &usage))
+                    {
+                        printf("Search method %s: consistent, index=%zu, heap=%zu\n",
+                               mo_get_search_method(paged), usage.index_bytes, usage.heap_bytes);
+                    }
+                }
+                mo_context_free(paged);
+                if (file)
+                {
+                    fclose(file);
+                }
+                
                 /* 复数形式测试 */
                 const char* plural = mo_translate_cp(ctx, NULL, "%d file", "%d files", 5);
                 printf("Plural: 5 files -> '%s'\n", plural);
@@ -75,12 +639,8 @@ int main(int argc, char* argv[])
                            stats.total_lookups > 0 ? 
                            (float)stats.cache_hits / stats.total_lookups * 100.0f : 0.0f);
                     printf("  Cache misses: %u\n", stats.cache_misses);
-                    #ifdef MO_SEARCH_METHOD_HASH
                     printf("  Hash collisions: %u\n", stats.hash_collisions);
-                    #endif
-                    #if defined(MO_SEARCH_METHOD_LINEAR) || defined(MO_SEARCH_METHOD_BINARY)
                     printf("  Comparisons: %u\n", stats.comparisons);
-                    #endif
                 }
 #endif
                 mo_context_free(ctx);
@@ -89,5 +649,5 @@ int main(int argc, char* argv[])
             }
         }
     }
-    return 0;
+    return exit;
 }
@@ -0,0 +1,126 @@
+/**
+ * @file test_mo_catalog.c
+ * @brief 编译进程序的翻译目录测试：结果必须与从文件加载的目录一致
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mo_parser.h"
+#include "i18n_utils.h"
+#include "zh_CN_catalog.h"
+#include "ja_JP_catalog.h"
+#include "zh_CN_po_catalog.h"
+
+static const char* s_test_strings[] = {
+    "Frequency",
+    "Duty-cycle",
+    "Title",
+    "New screen",
+    "Button",
+    "Help",
+    "Save",
+    "Open",
+    "Exit",
+    "Frequency1",
+    "1Frequency",
+    "Welcome",
+    "About",
+    "",
+};
+
+/**
+ * @brief 比较静态目录与文件目录的查找结果
+ */
+static int check_catalog(mo_context_t* catalog, const char* filename)
+{
+    mo_context_t* ctx = NULL;
+    int failures = 0;
+    
+    if (mo_context_create(filename, &ctx) != MO_SUCCESS)
+    {
+        fprintf(stderr, "Failed to load %s\n", filename);
+        return 1;
+    }
+    
+    if (mo_get_string_count(catalog) != mo_get_string_count(ctx) ||
+        strcmp(mo_get_search_method(catalog), "MPH") != 0)
+    {
+        fprintf(stderr, "%s: catalog has %u strings, method %s\n", filename,
+                mo_get_string_count(catalog), mo_get_search_method(catalog));
+        failures++;
+    }
+    
+    /* 头部元数据随目录一起生成 */
+    const mo_metadata_t* expected_metadata = mo_get_metadata(ctx);
+    const mo_metadata_t* metadata = mo_get_metadata(catalog);
+    if (strcmp(metadata->language, expected_metadata->language) != 0 ||
+        strcmp(metadata->charset, expected_metadata->charset) != 0 ||
+        strcmp(metadata->po_revision_date, expected_metadata->po_revision_date) != 0 ||
+        metadata->nplurals != expected_metadata->nplurals)
+    {
+        fprintf(stderr, "%s: catalog metadata differs (language '%s')\n", filename,
+                metadata->language);
+        failures++;
+    }
+    
+    i18n_set_context(catalog);
+    for (size_t i = 0; i < sizeof(s_test_strings) / sizeof(s_test_strings[0]); i++)
+    {
+        const char* expected = mo_translate(ctx, s_test_strings[i]);
+        const char* actual = I18N_T(s_test_strings[i]);
+        
+        if (strcmp(expected, actual) != 0)
+        {
+            fprintf(stderr, "%s: '%s' -> '%s', expected '%s'\n",
+                    filename, s_test_strings[i], actual, expected);
+            failures++;
+        }
+    }
+    
+    for (unsigned long n = 0; n < 3; n++)
+    {
+        if (strcmp(mo_translate_cp(ctx, NULL, "%d file", "%d files", n),
+                   mo_translate_cp(catalog, NULL, "%d file", "%d files", n)) != 0)
+        {
+            fprintf(stderr, "%s: plural mismatch for n=%lu\n", filename, n);
+            failures++;
+        }
+    }
+    
+    printf("%s: %u strings, %s\n", filename, mo_get_string_count(catalog),
+           failures ? "FAILED" : "consistent");
+    
+    /* 静态目录不需要释放，调用mo_context_free也不会有副作用 */
+    mo_context_free(catalog);
+    mo_context_free(ctx);
+    return failures;
+}
+
+int main(int argc, char* argv[])
+{
+    int failures = 0;
+    
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <zh_CN.mo> <ja_JP.mo>\n", argv[0]);
+        return 1;
+    }
+    
+    /* 未设置目录时I18N_T返回原文 */
+    i18n_set_context(NULL);
+    if (strcmp(I18N_T("Frequency"), "Frequency") != 0)
+    {
+        failures++;
+    }
+    
+    failures += check_catalog(&mo_catalog_zh_CN, argv[1]);
+    failures += check_catalog(&mo_catalog_ja_JP, argv[2]);
+    
+    /* 直接从.po文件生成的目录与msgfmt编译的.mo文件一致 */
+    failures += check_catalog(&mo_catalog_zh_CN_po, argv[1]);
+    
+    i18n_set_context(&mo_catalog_zh_CN);
+    printf("I18N_T(\"Frequency\") -> '%s'\n", I18N_T("Frequency"));
+    
+    return failures ? 1 : 0;
+}
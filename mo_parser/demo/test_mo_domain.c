@@ -0,0 +1,173 @@
+/**
+ * @file test_mo_domain.c
+ * @brief 多文本域目录集合测试：语言回退链与合并索引
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mo_domain.h"
+#include "test_common.h"
+
+/* app/zh：被app/zh_CN覆盖的条目和只有zh提供的条目 */
+static const entry_t s_app_zh[] = {
+    ENTRY("", "Content-Type: text/plain; charset=UTF-8\n"),
+    ENTRY("Frequency", "频率(zh)"),
+    ENTRY("Only in zh", "仅zh"),
+};
+
+/* lib/zh_CN：与app重复的条目、lib独有的条目和复数条目 */
+static const entry_t s_lib_zh_CN[] = {
+    ENTRY("", "Content-Type: text/plain; charset=UTF-8\n"
+              "Plural-Forms: nplurals=1; plural=0;\n"),
+    ENTRY("Frequency", "库频率"),
+    ENTRY("Library only", "库"),
+    ENTRY("%d file\0%d files", "%d个文件"),
+};
+
+/* 重载后的app/zh：与s_app_zh的翻译不同 */
+static const entry_t s_app_zh_reloaded[] = {
+    ENTRY("", "Content-Type: text/plain; charset=UTF-8\n"),
+    ENTRY("Frequency", "频率(新)"),
+};
+
+/**
+ * @brief 将内存中的目录加入集合
+ */
+static mo_error_t add_memory(mo_domain_set_t* set, const char* domain, const char* locale,
+                             const entry_t* entries, size_t count)
+{
+    mo_context_t* ctx = NULL;
+    size_t size = 0;
+    uint8_t* data = build_mo(entries, count, false, &size);
+    mo_error_t err = mo_context_create_from_memory(data, size, &ctx);
+    
+    free(data);
+    if (err == MO_SUCCESS)
+    {
+        err = mo_domain_set_add(set, domain, locale, ctx);
+        if (err != MO_SUCCESS)
+        {
+            mo_context_free(ctx);
+        }
+    }
+    return err;
+}
+
+/**
+ * @brief 将目录写入文件（先写临时文件再重命名，已映射的旧文件不受影响）
+ */
+static int write_mo(const char* filename, const entry_t* entries, size_t count)
+{
+    char temp[1024];
+    size_t size = 0;
+    uint8_t* data = build_mo(entries, count, false, &size);
+    
+    snprintf(temp, sizeof(temp), "%s.tmp", filename);
+    FILE* file = fopen(temp, "wb");
+    int ok = file && fwrite(data, 1, size, file) == size;
+    
+    if (file && fclose(file) != 0)
+    {
+        ok = 0;
+    }
+    free(data);
+    return ok && rename(temp, filename) == 0;
+}
+
+/**
+ * @brief 加入前重载过的目录：合并索引应使用重载后的条目，而不是句柄已释放的字符串表
+ */
+static int check_reloaded(const char* filename)
+{
+    mo_domain_set_t* set = NULL;
+    mo_context_t* ctx = NULL;
+    int failures = 0;
+    
+    if (!write_mo(filename, s_app_zh, COUNT(s_app_zh)) ||
+        mo_context_create(filename, &ctx) != MO_SUCCESS ||
+        !write_mo(filename, s_app_zh_reloaded, COUNT(s_app_zh_reloaded)) ||
+        mo_context_reload(ctx) != MO_SUCCESS ||
+        mo_domain_set_create(&set) != MO_SUCCESS ||
+        mo_domain_set_set_locale(set, "zh") != MO_SUCCESS ||
+        mo_domain_set_add(set, "app", "zh", ctx) != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL: could not add a reloaded catalog\n");
+        mo_context_free(ctx);
+        mo_domain_set_free(set);
+        remove(filename);
+        return 1;
+    }
+    
+    failures += check("reloaded catalog", mo_domain_translate(set, NULL, "Frequency"), "频率(新)");
+    failures += check("dropped entry", mo_domain_translate(set, NULL, "Only in zh"), "Only in zh");
+    
+    mo_domain_set_free(set);
+    remove(filename);
+    return failures;
+}
+
+int main(int argc, char* argv[])
+{
+    mo_domain_set_t* set = NULL;
+    mo_context_t* file_ctx = NULL;
+    int failures = 0;
+    
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <zh_CN.mo> [scratch.mo]\n", argv[0]);
+        return 1;
+    }
+    
+    if (mo_context_create(argv[1], &file_ctx) != MO_SUCCESS ||
+        mo_domain_set_create(&set) != MO_SUCCESS ||
+        mo_domain_set_add_file(set, "app", "zh_CN", argv[1], NULL) != MO_SUCCESS ||
+        add_memory(set, "app", "zh", s_app_zh, COUNT(s_app_zh)) != MO_SUCCESS ||
+        add_memory(set, "lib", "zh_CN", s_lib_zh_CN, COUNT(s_lib_zh_CN)) != MO_SUCCESS)
+    {
+        fprintf(stderr, "Failed to set up domain set\n");
+        return 1;
+    }
+    
+    /* 回退链：zh_CN.UTF-8 → zh_CN → zh */
+    if (mo_domain_set_set_locale(set, "zh_CN.UTF-8") != MO_SUCCESS)
+    {
+        fprintf(stderr, "Failed to set locale\n");
+        return 1;
+    }
+    failures += check("app/zh_CN wins", mo_domain_translate(set, NULL, "Frequency"),
+                      mo_translate(file_ctx, "Frequency"));
+    failures += check("explicit domain", mo_domain_translate(set, "lib", "Frequency"), "库频率");
+    failures += check("fallback to zh", mo_domain_translate(set, NULL, "Only in zh"), "仅zh");
+    failures += check("second domain", mo_domain_translate(set, NULL, "Library only"), "库");
+    failures += check("other domain only", mo_domain_translate(set, "app", "Library only"),
+                      "Library only");
+    failures += check("missing", mo_domain_translate(set, NULL, "Missing"), "Missing");
+    failures += check("unknown domain", mo_domain_translate(set, "none", "Frequency"), "Frequency");
+    failures += check("plural", mo_domain_translate_cp(set, NULL, NULL, "%d file", "%d files", 5),
+                      "%d个文件");
+    failures += check("plural missing",
+                      mo_domain_translate_cp(set, "app", NULL, "%d file", "%d files", 5),
+                      "%d files");
+    
+    /* 只设置zh时跳过zh_CN目录 */
+    mo_domain_set_set_locale(set, "zh");
+    failures += check("zh only", mo_domain_translate(set, NULL, "Frequency"), "频率(zh)");
+    failures += check("zh_CN skipped", mo_domain_translate(set, NULL, "Library only"),
+                      "Library only");
+    
+    /* C语言环境不翻译 */
+    mo_domain_set_set_locale(set, "C");
+    failures += check("C locale", mo_domain_translate(set, NULL, "Frequency"), "Frequency");
+    
+    mo_domain_set_free(set);
+    mo_context_free(file_ctx);
+    
+    if (argc > 2)
+    {
+        failures += check_reloaded(argv[2]);
+    }
+    
+    printf("Domain set tests: %s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,286 @@
+/**
+ * @file test_mo_plural.c
+ * @brief Plural-Forms解析、msgstr[n]选择与字符集转换测试
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mo_parser.h"
+#include "test_common.h"
+
+#define BYTES(s) s, sizeof(s) - 1
+
+static const entry_t s_entries[] = {
+    ENTRY("", "Language: ru\n"
+              "Content-Type: text/plain; charset=UTF-8\n"
+              "Plural-Forms: nplurals=3; plural=(n%10==1 && n%100!=11 ? 0 : "
+              "n%10>=2 && n%10<=4 && (n%100<10 || n%100>=20) ? 1 : 2);\n"),
+    ENTRY("%d file\0%d files", "%d файл\0%d файла\0%d файлов"),
+    ENTRY("Open", "Открыть"),
+    ENTRY("menu\004Open", "Открыть меню"),
+    ENTRY("menu\004%d item\0%d items", "%d пункт\0%d пункта\0%d пунктов"),
+};
+
+#define ENTRY_COUNT COUNT(s_entries)
+
+static bool count_entry(const char* original, size_t original_len,
+                        const char* translation, void* user_data)
+{
+    (void)original;
+    (void)original_len;
+    (void)translation;
+    (*(int*)user_data)++;
+    return true;
+}
+
+/**
+ * @brief 加载非UTF-8目录：翻译在加载时转换为UTF-8，keep_charset时保留原始字节
+ */
+static int check_charset(const char* charset, const char* open, size_t open_len,
+                         const char* files, size_t files_len,
+                         const char* open_utf8, const char* file_utf8, const char* files_utf8)
+{
+    char header[128];
+    int failures = 0;
+    size_t size = 0;
+    mo_context_t* ctx = NULL;
+    mo_options_t options;
+    
+    snprintf(header, sizeof(header),
+             "Language: xx\nContent-Type: text/plain; charset=%s\n", charset);
+    entry_t entries[] = {
+        { "", 0, header, strlen(header) },
+        { "Open", 4, open, open_len },
+        { "%d file\0%d files", sizeof("%d file\0%d files") - 1, files, files_len },
+    };
+    uint8_t* data = build_mo(entries, COUNT(entries), true, &size);
+    
+    if (mo_context_create_from_memory(data, size, &ctx) != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL %s: cannot load\n", charset);
+        free(data);
+        return 1;
+    }
+    if (strcmp(mo_get_charset(ctx), charset) == 0)
+    {
+        /* 平台不支持的字符集保留原始字节 */
+        printf("%s: not supported on this platform, skipped\n", charset);
+    }
+    else
+    {
+        failures += check(charset, mo_get_charset(ctx), "UTF-8");
+        failures += check(charset, mo_translate(ctx, "Open"), open_utf8);
+        failures += check(charset, mo_translate_cp(ctx, NULL, "%d file", "%d files", 1), file_utf8);
+        failures += check(charset, mo_translate_cp(ctx, NULL, "%d file", "%d files", 2), files_utf8);
+        failures += check(charset, mo_get_language(ctx), "xx");
+        printf("%s: converted to UTF-8\n", charset);
+    }
+    mo_context_free(ctx);
+    
+    mo_options_init(&options);
+    options.keep_charset = true;
+    ctx = NULL;
+    if (mo_context_create_from_memory_ex(data, size, &options, &ctx) != MO_SUCCESS ||
+        strcmp(mo_get_charset(ctx), charset) != 0 ||
+        memcmp(mo_translate(ctx, "Open"), open, open_len + 1) != 0)
+    {
+        fprintf(stderr, "FAIL %s: keep_charset did not return the original bytes\n", charset);
+        failures++;
+    }
+    mo_context_free(ctx);
+    free(data);
+    return failures;
+}
+
+/**
+ * @brief 按给定的plural表达式加载目录，返回n=5时选中的翻译
+ */
+static int check_plural_expr(const char* what, const char* expr, const char* expected)
+{
+    size_t header_len = strlen(expr) + 128;
+    char* header = malloc(header_len);
+    size_t size = 0;
+    mo_context_t* ctx = NULL;
+    int failures = 0;
+    
+    snprintf(header, header_len, "Content-Type: text/plain; charset=UTF-8\n"
+             "Plural-Forms: nplurals=2; plural=%s;\n", expr);
+    entry_t entries[] = {
+        { "", 0, header, strlen(header) },
+        ENTRY("%d file\0%d files", "one\0other"),
+    };
+    uint8_t* data = build_mo(entries, COUNT(entries), true, &size);
+    
+    if (mo_context_create_from_memory(data, size, &ctx) != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL %s: cannot load\n", what);
+        failures++;
+    }
+    else
+    {
+        failures += check(what, mo_translate_cp(ctx, NULL, "%d file", "%d files", 5), expected);
+    }
+    mo_context_free(ctx);
+    free(data);
+    free(header);
+    return failures;
+}
+
+/**
+ * @brief 嵌套过深的plural表达式按无法解析处理（使用默认规则），加载不会耗尽调用栈
+ */
+static int check_deep_nesting(void)
+{
+    const size_t depth = 50000;
+    char* expr = malloc(depth * 2 + 2);
+    int failures = 0;
+    
+    failures += check_plural_expr("shallow nesting", "!!((n != 1))", "other");
+    failures += check_plural_expr("negated", "!(n != 1)", "one");
+    
+    memset(expr, '(', depth);
+    expr[depth] = 'n';
+    memset(expr + depth + 1, ')', depth);
+    expr[depth * 2 + 1] = '\0';
+    failures += check_plural_expr("deep parentheses", expr, "other");
+    
+    /* 奇数个'!'：若被当作合法表达式，n=5时会选中"one" */
+    memset(expr, '!', depth - 1);
+    expr[depth - 1] = 'n';
+    expr[depth] = '\0';
+    failures += check_plural_expr("deep negation", expr, "other");
+    
+    free(expr);
+    return failures;
+}
+
+int main(void)
+{
+    static const mo_search_method_t methods[] = {
+        MO_SEARCH_LINEAR,
+        MO_SEARCH_BINARY,
+        MO_SEARCH_HASH,
+        MO_SEARCH_GETTEXT,
+        MO_SEARCH_MPH,
+        MO_SEARCH_EYTZINGER,
+    };
+    static const struct {
+        unsigned long n;
+        const char* file;
+        const char* item;
+    } s_cases[] = {
+        { 0,   "%d файлов", "%d пунктов" },
+        { 1,   "%d файл",   "%d пункт" },
+        { 2,   "%d файла",  "%d пункта" },
+        { 4,   "%d файла",  "%d пункта" },
+        { 5,   "%d файлов", "%d пунктов" },
+        { 11,  "%d файлов", "%d пунктов" },
+        { 12,  "%d файлов", "%d пунктов" },
+        { 21,  "%d файл",   "%d пункт" },
+        { 22,  "%d файла",  "%d пункта" },
+        { 111, "%d файлов", "%d пунктов" },
+        { 1001, "%d файл",  "%d пункт" },
+    };
+    int failures = 0;
+    size_t size = 0;
+    
+    /* 超过4KB的带上下文的键 */
+    entry_t entries[ENTRY_COUNT + 1];
+    size_t long_context_len = 5000;
+    char* long_context = malloc(long_context_len + 1);
+    char* long_key = malloc(long_context_len + sizeof("\004Open"));
+    memset(long_context, 'x', long_context_len);
+    long_context[long_context_len] = '\0';
+    memcpy(long_key, long_context, long_context_len);
+    memcpy(long_key + long_context_len, "\004Open", sizeof("\004Open"));
+    memcpy(entries, s_entries, sizeof(s_entries));
+    entries[ENTRY_COUNT] = (entry_t){ long_key, strlen(long_key), "Открыть (long)",
+                                      strlen("Открыть (long)") };
+    
+    uint8_t* data = build_mo(entries, ENTRY_COUNT + 1, true, &size);
+    
+    for (size_t m = 0; m < sizeof(methods) / sizeof(methods[0]); m++)
+    {
+        mo_options_t options;
+        mo_context_t* ctx = NULL;
+        
+        mo_options_init(&options);
+        options.search_method = methods[m];
+        if (mo_context_create_from_memory_ex(data, size, &options, &ctx) != MO_SUCCESS)
+        {
+            fprintf(stderr, "Failed to create context\n");
+            free(data);
+            return 1;
+        }
+        
+        for (size_t i = 0; i < sizeof(s_cases) / sizeof(s_cases[0]); i++)
+        {
+            failures += check("plural", 
+                              mo_translate_cp(ctx, NULL, "%d file", "%d files", s_cases[i].n),
+                              s_cases[i].file);
+            failures += check("context plural",
+                              mo_translate_cp(ctx, "menu", "%d item", "%d items", s_cases[i].n),
+                              s_cases[i].item);
+        }
+        
+        /* 复数条目可以仅用单数形式查找，得到msgstr[0] */
+        failures += check("singular", mo_translate(ctx, "%d file"), "%d файл");
+        failures += check("context", mo_translate_cp(ctx, "menu", "Open", NULL, 0), "Открыть меню");
+        failures += check("context fallback", mo_translate_cp(ctx, "toolbar", "Open", NULL, 0), "Открыть");
+        failures += check("context boundary", mo_translate_cp(ctx, "menu", "Ope", NULL, 0), "Ope");
+        failures += check("context prefix", mo_translate_cp(ctx, "men", "Open", NULL, 0), "Открыть");
+        failures += check("long context",
+                          mo_translate_cp(ctx, long_context, "Open", NULL, 0), "Открыть (long)");
+        failures += check("untranslated singular",
+                          mo_translate_cp(ctx, NULL, "%d dir", "%d dirs", 1), "%d dir");
+        failures += check("untranslated plural",
+                          mo_translate_cp(ctx, NULL, "%d dir", "%d dirs", 7), "%d dirs");
+        
+        /* 头部字段在加载时解析，Plural-Forms保留原文 */
+        failures += check("language", mo_get_language(ctx), "ru");
+        failures += check("plural forms", mo_get_plural_forms(ctx),
+                          "nplurals=3; plural=(n%10==1 && n%100!=11 ? 0 : "
+                          "n%10>=2 && n%10<=4 && (n%100<10 || n%100>=20) ? 1 : 2);");
+        if (mo_get_metadata(ctx)->nplurals != 3)
+        {
+            fprintf(stderr, "%s: expected nplurals=3\n", mo_get_search_method(ctx));
+            failures++;
+        }
+        
+        /* 按上下文前缀枚举，带分隔符的前缀不会匹配到更长的上下文 */
+        int menu_entries = 0;
+        if (mo_foreach_prefix(ctx, "menu\004", 5, count_entry, &menu_entries) != 2 ||
+            menu_entries != 2)
+        {
+            fprintf(stderr, "%s: expected 2 entries in context 'menu', got %d\n",
+                    mo_get_search_method(ctx), menu_entries);
+            failures++;
+        }
+        
+        printf("%s: plural checks done\n", mo_get_search_method(ctx));
+        mo_context_free(ctx);
+    }
+    
+    free(data);
+    free(long_context);
+    free(long_key);
+    
+    /* 嵌套过深的plural表达式 */
+    failures += check_deep_nesting();
+    
+    /* 非UTF-8目录 */
+    failures += check_charset("ISO-8859-1", BYTES("Ouvrir \xe9t\xe9"),
+                              BYTES("%d fichier\0%d fichiers \xe0"),
+                              "Ouvrir \xc3\xa9t\xc3\xa9", "%d fichier", "%d fichiers \xc3\xa0");
+    failures += check_charset("windows-1252", BYTES("\x80 \x93Open\x94"),
+                              BYTES("%d file\0%d files\x85"),
+                              "\xe2\x82\xac \xe2\x80\x9cOpen\xe2\x80\x9d", "%d file",
+                              "%d files\xe2\x80\xa6");
+    failures += check_charset("GBK", BYTES("\xb4\xf2\xbf\xaa"),
+                              BYTES("%d \xb4\xf2\xbf\xaa\0%d \xb9\xd8\xb1\xd5"),
+                              "\xe6\x89\x93\xe5\xbc\x80", "%d \xe6\x89\x93\xe5\xbc\x80",
+                              "%d \xe5\x85\xb3\xe9\x97\xad");
+    printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,268 @@
+/**
+ * @file test_mo_po.c
+ * @brief 直接加载.po文件测试：与msgfmt的输出一致、语法细节、重载与解析速度
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mo_parser.h"
+#include "test_common.h"
+
+/* 按顺序记录枚举到的条目 */
+typedef struct {
+    char text[64][256];
+    int count;
+} entry_list_t;
+
+static const char s_syntax_po[] =
+    "# 测试用目录\n"
+    "msgid \"\"\n"
+    "msgstr \"\"\n"
+    "\"Language: de\\n\"\n"
+    "\"Content-Type: text/plain; charset=UTF-8\\n\"\n"
+    "\"Plural-Forms: nplurals=2; plural=(n != 1);\\n\"\n"
+    "\n"
+    "#: src/main.c:1\n"
+    "msgid \"\"\n"
+    "\"Hello, \"\n"
+    "\"world\"\n"
+    "msgstr \"Hallo, \" \n"
+    "  \"Welt\"\n"
+    "\n"
+    "msgid \"Tab\\tQuote\\\"\"\n"
+    "msgstr \"A\\nB\\x41\\101\\\\\"\n"
+    "\n"
+    "msgctxt \"menu\"\n"
+    "msgid \"Open\"\n"
+    "msgstr \"Menü öffnen\"\r\n"
+    "\r\n"
+    "msgid \"Open\"\n"
+    "msgstr \"Datei öffnen\"\n"
+    "\n"
+    "msgid \"%d file\"\n"
+    "msgid_plural \"%d files\"\n"
+    "msgstr[0] \"%d Datei\"\n"
+    "msgstr[1] \"%d Dateien\"\n"
+    "\n"
+    "#, fuzzy, c-format\n"
+    "msgid \"Fuzzy\"\n"
+    "msgstr \"Unscharf\"\n"
+    "\n"
+    "msgid \"Empty\"\n"
+    "msgstr \"\"\n"
+    "\n"
+    "#~ msgid \"Old\"\n"
+    "#~ msgstr \"Alt\"\n";
+
+static bool record_entry(const char* original, size_t original_len,
+                         const char* translation, void* user_data)
+{
+    entry_list_t* list = (entry_list_t*)user_data;
+    if (list->count < 64)
+    {
+        snprintf(list->text[list->count++], sizeof(list->text[0]), "%.*s=%s",
+                 (int)original_len, original, translation);
+    }
+    return true;
+}
+
+static int write_file(const char* filename, const char* text, size_t len)
+{
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        return 1;
+    }
+    size_t written = fwrite(text, 1, len, file);
+    fclose(file);
+    return written == len ? 0 : 1;
+}
+
+/**
+ * @brief .po文件与msgfmt生成的MO文件加载后完全一致
+ */
+static int check_same_catalog(const char* po_file, const char* mo_file)
+{
+    static entry_list_t po_entries;
+    static entry_list_t mo_entries;
+    mo_options_t options;
+    mo_context_t* po = NULL;
+    mo_context_t* mo = NULL;
+    int failures = 0;
+    
+    mo_options_init(&options);
+    options.search_method = MO_SEARCH_BINARY;
+    if (mo_context_create_from_po(po_file, &options, &po) != MO_SUCCESS ||
+        mo_context_create_ex(mo_file, &options, &mo) != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL loading %s / %s\n", po_file, mo_file);
+        mo_context_free(po);
+        mo_context_free(mo);
+        return 1;
+    }
+    
+    po_entries.count = 0;
+    mo_entries.count = 0;
+    mo_foreach_prefix(po, NULL, 0, record_entry, &po_entries);
+    mo_foreach_prefix(mo, NULL, 0, record_entry, &mo_entries);
+    if (mo_get_string_count(po) != mo_get_string_count(mo) || po_entries.count != mo_entries.count)
+    {
+        fprintf(stderr, "FAIL %s: %u strings, expected %u\n", po_file,
+                mo_get_string_count(po), mo_get_string_count(mo));
+        failures++;
+    }
+    for (int i = 0; i < po_entries.count && i < mo_entries.count; i++)
+    {
+        failures += check(po_file, po_entries.text[i], mo_entries.text[i]);
+    }
+    failures += check("language", mo_get_language(po), mo_get_language(mo));
+    failures += check("plural forms", mo_get_plural_forms(po), mo_get_plural_forms(mo));
+    
+    printf("%s: %u strings, same as %s\n", po_file, mo_get_string_count(po), mo_file);
+    mo_context_free(po);
+    mo_context_free(mo);
+    return failures;
+}
+
+/**
+ * @brief 续行、转义、msgctxt、复数、fuzzy/未翻译/废弃条目与重载
+ */
+static int check_syntax(const char* filename)
+{
+    mo_context_t* ctx = NULL;
+    int failures = 0;
+    
+    if (write_file(filename, s_syntax_po, sizeof(s_syntax_po) - 1) != 0 ||
+        mo_context_create_from_po(filename, NULL, &ctx) != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL loading %s\n", filename);
+        return 1;
+    }
+    
+    /* 头部和5个已翻译的条目 */
+    if (mo_get_string_count(ctx) != 6)
+    {
+        fprintf(stderr, "FAIL string count %u, expected 6\n", mo_get_string_count(ctx));
+        failures++;
+    }
+    failures += check("language", mo_get_language(ctx), "de");
+    failures += check("continued", mo_translate(ctx, "Hello, world"), "Hallo, Welt");
+    failures += check("escapes", mo_translate(ctx, "Tab\tQuote\""), "A\nBAA\\");
+    failures += check("msgctxt", mo_translate_cp(ctx, "menu", "Open", NULL, 0), "Menü öffnen");
+    failures += check("no msgctxt", mo_translate(ctx, "Open"), "Datei öffnen");
+    failures += check("plural 1", mo_translate_cp(ctx, NULL, "%d file", "%d files", 1), "%d Datei");
+    failures += check("plural 5", mo_translate_cp(ctx, NULL, "%d file", "%d files", 5), "%d Dateien");
+    failures += check("fuzzy", mo_translate(ctx, "Fuzzy"), "Fuzzy");
+    failures += check("untranslated", mo_translate(ctx, "Empty"), "Empty");
+    failures += check("obsolete", mo_translate(ctx, "Old"), "Old");
+    
+    /* 重载时重新解析.po文件 */
+    static const char updated[] = "msgid \"Open\"\nmsgstr \"Öffnen\"\n";
+    if (write_file(filename, updated, sizeof(updated) - 1) != 0 ||
+        mo_context_reload(ctx) != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL reloading %s\n", filename);
+        failures++;
+    }
+    failures += check("reloaded", mo_translate(ctx, "Open"), "Öffnen");
+    mo_context_free(ctx);
+    
+    /* 语法错误：msgstr之前缺少msgid、未闭合的引号、未知的转义 */
+    static const char* broken[] = {
+        "msgstr \"x\"\n",
+        "msgid \"a\nmsgstr \"b\"\n",
+        "msgid \"a\\q\"\nmsgstr \"b\"\n",
+        "msgid \"a\"\n",
+        "msgid \"a\"\nmsgstr \"b\"\nmsgid \"a\"\nmsgstr \"c\"\n",
+    };
+    for (size_t i = 0; i < sizeof(broken) / sizeof(broken[0]); i++)
+    {
+        ctx = NULL;
+        if (write_file(filename, broken[i], strlen(broken[i])) != 0 ||
+            mo_context_create_from_po(filename, NULL, &ctx) != MO_ERROR_INVALID_FORMAT)
+        {
+            fprintf(stderr, "FAIL broken .po #%zu was accepted\n", i);
+            mo_context_free(ctx);
+            failures++;
+        }
+    }
+    
+    printf("Syntax checks: %s\n", failures ? "FAILED" : "passed");
+    return failures;
+}
+
+/**
+ * @brief 生成较大的.po文件并报告解析速度（仅输出，不作为失败条件）
+ */
+static int report_speed(const char* filename)
+{
+    const int entries = 50000;
+    size_t capacity = (size_t)entries * 96;
+    char* text = (char*)malloc(capacity);
+    size_t len = 0;
+    mo_context_t* ctx = NULL;
+    int failures = 0;
+    
+    if (!text)
+    {
+        return 1;
+    }
+    len += (size_t)snprintf(text, capacity, "msgid \"\"\nmsgstr \"Content-Type: text/plain; charset=UTF-8\\n\"\n\n");
+    for (int i = 0; i < entries; i++)
+    {
+        len += (size_t)snprintf(text + len, capacity - len,
+                                "#: src/file.c:%d\nmsgid \"Message number %d\"\nmsgstr \"Nachricht Nummer %d\"\n\n",
+                                i, i, i);
+    }
+    if (write_file(filename, text, len) != 0)
+    {
+        free(text);
+        return 1;
+    }
+    free(text);
+    
+    clock_t start = clock();
+    mo_error_t result = mo_context_create_from_po(filename, NULL, &ctx);
+    double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+    if (result != MO_SUCCESS || mo_get_string_count(ctx) != (uint32_t)entries + 1)
+    {
+        fprintf(stderr, "FAIL loading generated .po: %s\n", mo_error_string(result));
+        failures++;
+    }
+    else
+    {
+        failures += check("generated", mo_translate(ctx, "Message number 4242"), "Nachricht Nummer 4242");
+        printf("Loaded %.1f MB .po with %d entries in %.1f ms (%.0f MB/s incl. index)\n",
+               len / 1e6, entries, seconds * 1e3, seconds > 0 ? len / 1e6 / seconds : 0.0);
+    }
+    mo_context_free(ctx);
+    return failures;
+}
+
+int main(int argc, char* argv[])
+{
+    int failures = 0;
+    
+    if (argc < 4 || argc % 2 != 0)
+    {
+        fprintf(stderr, "Usage: %s <scratch.po> <file.po> <file.mo> [<file.po> <file.mo> ...]\n", argv[0]);
+        return 1;
+    }
+    
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        failures += check_same_catalog(argv[i], argv[i + 1]);
+    }
+    failures += check_syntax(argv[1]);
+    failures += report_speed(argv[1]);
+    
+    if (failures)
+    {
+        fprintf(stderr, "%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("All .po tests passed\n");
+    return 0;
+}
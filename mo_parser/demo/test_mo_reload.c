@@ -0,0 +1,367 @@
+/**
+ * @file test_mo_reload.c
+ * @brief 热重载测试：并发查找期间反复替换目录文件
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "mo_parser.h"
+#include "i18n_utils.h"
+
+#define THREAD_COUNT 4
+#define RELOAD_ROUNDS 50
+#define SHORT_LIVED_THREADS 512     /**< 超过读者槽位数量，退出的线程须归还槽位 */
+#define RELOAD_TIME_LIMIT 10        /**< 并发重载全部轮次的时间上限（秒） */
+
+static const char* s_test_strings[] = {
+    "Frequency",
+    "Duty-cycle",
+    "Title",
+    "Help",
+};
+
+#define TEST_STRING_COUNT (sizeof(s_test_strings)/sizeof(s_test_strings[0]))
+
+/* 两个目录中的预期翻译（复制保存，与目录的生命周期无关） */
+static char s_expected[2][TEST_STRING_COUNT][256];
+
+static atomic_bool s_stop;
+
+typedef struct {
+    mo_context_t* ctx;
+    long lookups;
+    int errors;
+} thread_arg_t;
+
+/* 监视回调通知 */
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_cond = PTHREAD_COND_INITIALIZER;
+static int s_reloads;
+static mo_error_t s_reload_result;
+
+/**
+ * @brief 复制文件（先写临时文件再重命名，模拟部署新目录）
+ */
+static int replace_file(const char* source, const char* target)
+{
+    char temp[1024];
+    char buffer[4096];
+    size_t n;
+    int ok = 1;
+    
+    snprintf(temp, sizeof(temp), "%s.tmp", target);
+    FILE* in = fopen(source, "rb");
+    FILE* out = fopen(temp, "wb");
+    if (!in || !out)
+    {
+        ok = 0;
+    }
+    while (ok && (n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+    {
+        ok = fwrite(buffer, 1, n, out) == n;
+    }
+    if (in)
+    {
+        fclose(in);
+    }
+    if (out && fclose(out) != 0)
+    {
+        ok = 0;
+    }
+    return ok && rename(temp, target) == 0;
+}
+
+/**
+ * @brief 读取目录中的预期翻译
+ */
+static int load_expected(const char* filename, int which)
+{
+    mo_context_t* ctx = NULL;
+    
+    if (mo_context_create(filename, &ctx) != MO_SUCCESS)
+    {
+        return 0;
+    }
+    for (size_t i = 0; i < TEST_STRING_COUNT; i++)
+    {
+        snprintf(s_expected[which][i], sizeof(s_expected[which][i]), "%s",
+                 mo_translate(ctx, s_test_strings[i]));
+    }
+    mo_context_free(ctx);
+    return 1;
+}
+
+static void* worker(void* param)
+{
+    thread_arg_t* arg = (thread_arg_t*)param;
+    
+    while (!atomic_load(&s_stop))
+    {
+        size_t idx = (size_t)arg->lookups % TEST_STRING_COUNT;
+    
+        /* 在读取区间内使用翻译结果，保证比较期间目录不被释放 */
+        mo_read_begin();
+        const char* translated = mo_translate(arg->ctx, s_test_strings[idx]);
+        if (strcmp(translated, s_expected[0][idx]) != 0 &&
+            strcmp(translated, s_expected[1][idx]) != 0)
+        {
+            arg->errors++;
+        }
+        mo_read_end();
+        arg->lookups++;
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief 只查找一次就退出的线程
+ */
+static void* short_lived(void* param)
+{
+    thread_arg_t* arg = (thread_arg_t*)param;
+    
+    mo_read_begin();
+    if (strcmp(mo_translate(arg->ctx, s_test_strings[0]), s_expected[0][0]) != 0 &&
+        strcmp(mo_translate(arg->ctx, s_test_strings[0]), s_expected[1][0]) != 0)
+    {
+        arg->errors++;
+    }
+    mo_read_end();
+    return NULL;
+}
+
+static void on_reload(mo_context_t* context, mo_error_t result, void* user_data)
+{
+    (void)context;
+    (void)user_data;
+    pthread_mutex_lock(&s_mutex);
+    s_reloads++;
+    s_reload_result = result;
+    pthread_cond_signal(&s_cond);
+    pthread_mutex_unlock(&s_mutex);
+}
+
+/**
+ * @brief 等待监视线程完成一次重载，最多等待约2秒
+ */
+static int wait_reload(int previous)
+{
+    struct timespec deadline;
+    int reloaded;
+    
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 2;
+    pthread_mutex_lock(&s_mutex);
+    while (s_reloads == previous &&
+           pthread_cond_timedwait(&s_cond, &s_mutex, &deadline) == 0)
+    {
+    }
+    reloaded = s_reloads != previous && s_reload_result == MO_SUCCESS;
+    pthread_mutex_unlock(&s_mutex);
+    return reloaded;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* sources[2];
+    const char* target;
+    mo_context_t* ctx = NULL;
+    mo_watch_t* watch = NULL;
+    pthread_t threads[THREAD_COUNT];
+    thread_arg_t args[THREAD_COUNT];
+    int failures = 0;
+    
+    if (argc < 4)
+    {
+        fprintf(stderr, "Usage: %s <first.mo> <second.mo> <work_file>\n", argv[0]);
+        return 1;
+    }
+    sources[0] = argv[1];
+    sources[1] = argv[2];
+    target = argv[3];
+    
+    if (!load_expected(sources[0], 0) || !load_expected(sources[1], 1) ||
+        strcmp(s_expected[0][0], s_expected[1][0]) == 0)
+    {
+        fprintf(stderr, "Need two MO files with different translations\n");
+        return 1;
+    }
+    
+    if (!replace_file(sources[0], target) || mo_context_create(target, &ctx) != MO_SUCCESS)
+    {
+        fprintf(stderr, "Failed to load MO file: %s\n", target);
+        return 1;
+    }
+    
+    /* 不能重载的上下文 */
+    if (mo_context_reload(NULL) != MO_ERROR_INVALID_CONTEXT)
+    {
+        fprintf(stderr, "FAIL: reload(NULL) should be rejected\n");
+        failures++;
+    }
+    
+    /* 翻译键的绑定在重载后失效 */
+    mo_key_t key = mo_key_make(s_test_strings[0], strlen(s_test_strings[0]));
+    if (strcmp(mo_translate_key(ctx, &key), s_expected[0][0]) != 0 ||
+        !replace_file(sources[1], target) || mo_context_reload(ctx) != MO_SUCCESS ||
+        strcmp(mo_translate_key(ctx, &key), s_expected[1][0]) != 0 ||
+        !replace_file(sources[0], target) || mo_context_reload(ctx) != MO_SUCCESS ||
+        strcmp(mo_translate_key(ctx, &key), s_expected[0][0]) != 0)
+    {
+        fprintf(stderr, "FAIL: key binding survived a reload\n");
+        failures++;
+    }
+    
+    /* I18N_T的调用点缓存在重载后失效（循环中是同一个调用点） */
+    i18n_set_context(ctx);
+    for (int round = 0; round < 4; round++)
+    {
+        int which = round % 2;
+        if (strcmp(I18N_T("Frequency"), s_expected[which][0]) != 0 ||
+            !replace_file(sources[!which], target) || mo_context_reload(ctx) != MO_SUCCESS)
+        {
+            fprintf(stderr, "FAIL: I18N_T slot survived a reload\n");
+            failures++;
+            break;
+        }
+    }
+    i18n_set_context(NULL);
+    if (strcmp(I18N_T("Frequency"), "Frequency") != 0)
+    {
+        fprintf(stderr, "FAIL: I18N_T without a context\n");
+        failures++;
+    }
+    
+    /* 大量短生命周期的线程：退出时归还读者槽位，之后的读者仍有独立槽位，
+       重载不会因等待共享计数归零而长时间阻塞 */
+    for (int i = 0; i < SHORT_LIVED_THREADS; i++)
+    {
+        pthread_t thread;
+        args[0].ctx = ctx;
+        args[0].errors = 0;
+        if (pthread_create(&thread, NULL, short_lived, &args[0]) != 0)
+        {
+            break;
+        }
+        pthread_join(thread, NULL);
+        failures += args[0].errors;
+    }
+    
+    /* 并发查找期间反复替换并重载 */
+    struct timespec started;
+    struct timespec finished;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    for (int i = 0; i < THREAD_COUNT; i++)
+    {
+        args[i].ctx = ctx;
+        args[i].lookups = 0;
+        args[i].errors = 0;
+        pthread_create(&threads[i], NULL, worker, &args[i]);
+    }
+    
+    for (int round = 0; round < RELOAD_ROUNDS; round++)
+    {
+        int which = (round + 1) % 2;
+        if (!replace_file(sources[which], target) || mo_context_reload(ctx) != MO_SUCCESS)
+        {
+            fprintf(stderr, "FAIL: reload round %d\n", round);
+            failures++;
+            break;
+        }
+        if (strcmp(mo_translate(ctx, s_test_strings[0]), s_expected[which][0]) != 0)
+        {
+            fprintf(stderr, "FAIL: round %d did not publish the new catalog\n", round);
+            failures++;
+        }
+    }
+    
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+    if (finished.tv_sec - started.tv_sec > RELOAD_TIME_LIMIT)
+    {
+        fprintf(stderr, "FAIL: %d reloads took %ld seconds\n", RELOAD_ROUNDS,
+                (long)(finished.tv_sec - started.tv_sec));
+        failures++;
+    }
+    
+    atomic_store(&s_stop, true);
+    for (int i = 0; i < THREAD_COUNT; i++)
+    {
+        pthread_join(threads[i], NULL);
+        printf("Thread %d: %ld lookups, %d errors\n", i, args[i].lookups, args[i].errors);
+        failures += args[i].errors;
+    }
+    
+    /* 加载失败时保留原目录（原地覆盖会破坏正在映射的文件，同样以重命名替换） */
+    const char* before = s_expected[RELOAD_ROUNDS % 2][0];
+    char broken_name[1024];
+    snprintf(broken_name, sizeof(broken_name), "%s.broken", target);
+    FILE* broken = fopen(broken_name, "wb");
+    if (broken)
+    {
+        fputs("not a catalog", broken);
+        fclose(broken);
+    }
+    if (!replace_file(broken_name, target) || mo_context_reload(ctx) == MO_SUCCESS ||
+        strcmp(mo_translate(ctx, s_test_strings[0]), before) != 0)
+    {
+        fprintf(stderr, "FAIL: broken file replaced the catalog\n");
+        failures++;
+    }
+    
+    /* 监视文件并在替换后自动重载 */
+    if (mo_watch_start(ctx, on_reload, NULL, &watch) != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL: mo_watch_start\n");
+        failures++;
+    }
+    else
+    {
+        for (int which = 0; which < 2; which++)
+        {
+            int previous;
+            pthread_mutex_lock(&s_mutex);
+            previous = s_reloads;
+            pthread_mutex_unlock(&s_mutex);
+    
+            if (!replace_file(sources[which], target) || !wait_reload(previous) ||
+                strcmp(mo_translate(ctx, s_test_strings[0]), s_expected[which][0]) != 0)
+            {
+                fprintf(stderr, "FAIL: watch did not reload %s\n", sources[which]);
+                failures++;
+            }
+        }
+        mo_watch_stop(watch);
+    }
+    
+    mo_context_free(ctx);
+    
+    /* 后台仍在建立索引时重载：等索引发布后再替换，两份共用数据的目录一起释放 */
+    mo_options_t options;
+    mo_options_init(&options);
+    options.search_method = MO_SEARCH_HASH;
+    options.lazy_index = true;
+    ctx = NULL;
+    if (!replace_file(sources[0], target) || mo_context_create_ex(target, &options, &ctx) != MO_SUCCESS ||
+        strcmp(mo_translate(ctx, s_test_strings[0]), s_expected[0][0]) != 0 ||
+        !replace_file(sources[1], target) || mo_context_reload(ctx) != MO_SUCCESS ||
+        strcmp(mo_translate(ctx, s_test_strings[0]), s_expected[1][0]) != 0 ||
+        strcmp(mo_get_search_method(ctx), "HASH") != 0)
+    {
+        fprintf(stderr, "FAIL: reload of a lazily indexed catalog\n");
+        failures++;
+    }
+    mo_context_free(ctx);
+    unlink(broken_name);
+    unlink(target);
+    
+    printf("Reload tests: %s\n", failures ? "FAILED" : "passed");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,215 @@
+/**
+ * @file test_mo_threads.c
+ * @brief 多线程共享同一上下文并发查找测试
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "mo_parser.h"
+
+#define THREAD_COUNT 8
+#define ROUNDS 200000
+#define LARGE_ENTRIES 120000
+
+static const char* s_test_strings[] = {
+    "Frequency",
+    "Duty-cycle",
+    "Title",
+    "New screen",
+    "Button",
+    "Close",
+    "Help",
+    "Save",
+};
+
+#define TEST_STRING_COUNT (sizeof(s_test_strings)/sizeof(s_test_strings[0]))
+
+typedef struct {
+    mo_context_t* ctx;
+    const char* expected[TEST_STRING_COUNT];
+    int errors;
+} thread_arg_t;
+
+static void* worker(void* param)
+{
+    thread_arg_t* arg = (thread_arg_t*)param;
+    
+    for (int i = 0; i < ROUNDS; i++)
+    {
+        size_t idx = (size_t)i % TEST_STRING_COUNT;
+        const char* translated = mo_translate(arg->ctx, s_test_strings[idx]);
+        if (translated != arg->expected[idx])
+        {
+            arg->errors++;
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief 生成一个大目录（无内嵌哈希表），条目按乱序写入
+ */
+static uint8_t* build_large_mo(size_t* size)
+{
+    uint32_t n = LARGE_ENTRIES;
+    uint32_t strings = 28 + n * 16;
+    uint32_t offset;
+    uint8_t* data = malloc(strings + (size_t)n * 48);
+    uint32_t* header = (uint32_t*)data;
+    
+    header[0] = 0x950412de;
+    header[1] = 0;
+    header[2] = n;
+    header[3] = 28;
+    header[4] = 28 + n * 8;
+    header[5] = 0;
+    header[6] = 0;
+    
+    offset = strings;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t id = (uint32_t)(((uint64_t)i * 2654435761u) % n);
+        uint32_t* orig = (uint32_t*)(data + 28 + i * 8);
+        uint32_t* trans = (uint32_t*)(data + 28 + n * 8 + i * 8);
+        
+        orig[0] = (uint32_t)sprintf((char*)data + offset, "entry %u", id);
+        orig[1] = offset;
+        offset += orig[0] + 1;
+        trans[0] = (uint32_t)sprintf((char*)data + offset, "translation %u", id);
+        trans[1] = offset;
+        offset += trans[0] + 1;
+    }
+    
+    *size = offset;
+    return data;
+}
+
+/**
+ * @brief 多线程建立的索引与单线程建立的查找结果一致
+ */
+static int check_parallel_build(void)
+{
+    static const mo_search_method_t methods[] = {
+        MO_SEARCH_BINARY,
+        MO_SEARCH_HASH,
+        MO_SEARCH_EYTZINGER,
+    };
+    size_t size = 0;
+    uint8_t* data = build_large_mo(&size);
+    int errors = 0;
+    
+    for (size_t m = 0; m < sizeof(methods)/sizeof(methods[0]); m++)
+    {
+        mo_options_t options;
+        mo_context_t* serial = NULL;
+        mo_context_t* parallel = NULL;
+        char key[32];
+        char expected[32];
+        
+        mo_options_init(&options);
+        options.search_method = methods[m];
+        options.build_threads = 4;
+        if (mo_context_create_from_memory_ex(data, size, &options, &parallel) != MO_SUCCESS)
+        {
+            fprintf(stderr, "Failed to create context with 4 build threads\n");
+            errors++;
+            continue;
+        }
+        options.build_threads = 0;
+        mo_context_create_from_memory_ex(data, size, &options, &serial);
+        
+        for (uint32_t id = 0; id < LARGE_ENTRIES + 100; id++)
+        {
+            snprintf(key, sizeof(key), "entry %u", id);
+            snprintf(expected, sizeof(expected), id < LARGE_ENTRIES ? "translation %u" : "entry %u", id);
+            /* 键放在同一个缓冲区中，改用不经过查找缓存（按指针识别键）的接口 */
+            if (strcmp(mo_translate_cp(parallel, NULL, key, NULL, 0), expected) != 0 ||
+                strcmp(mo_translate_cp(serial, NULL, key, NULL, 0), expected) != 0)
+            {
+                errors++;
+            }
+        }
+        
+        printf("%s: parallel build of %d entries, %d errors\n",
+               mo_get_search_method(parallel), LARGE_ENTRIES, errors);
+        mo_context_free(serial);
+        mo_context_free(parallel);
+    }
+    
+    free(data);
+    return errors;
+}
+
+int main(int argc, char* argv[])
+{
+    static const mo_search_method_t methods[] = {
+        MO_SEARCH_LINEAR,
+        MO_SEARCH_BINARY,
+        MO_SEARCH_HASH,
+        MO_SEARCH_GETTEXT,
+        MO_SEARCH_MPH,
+        MO_SEARCH_EYTZINGER,
+    };
+    int exit = 0;
+    
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s <mo_file>\n", argv[0]);
+        return 1;
+    }
+    
+    for (size_t m = 0; m < sizeof(methods)/sizeof(methods[0]); m++)
+    {
+        mo_options_t options;
+        mo_context_t* ctx = NULL;
+        pthread_t threads[THREAD_COUNT];
+        thread_arg_t args[THREAD_COUNT];
+        
+        mo_options_init(&options);
+        options.search_method = methods[m];
+        if (mo_context_create_ex(argv[1], &options, &ctx) != MO_SUCCESS)
+        {
+            fprintf(stderr, "Failed to load MO file: %s\n", argv[1]);
+            return 1;
+        }
+        
+        /* 单线程结果作为基准，翻译指针在上下文生命周期内保持不变 */
+        for (int t = 0; t < THREAD_COUNT; t++)
+        {
+            args[t].ctx = ctx;
+            args[t].errors = 0;
+            for (size_t i = 0; i < TEST_STRING_COUNT; i++)
+            {
+                args[t].expected[i] = mo_translate(ctx, s_test_strings[i]);
+            }
+            pthread_create(&threads[t], NULL, worker, &args[t]);
+        }
+        
+        int errors = 0;
+        for (int t = 0; t < THREAD_COUNT; t++)
+        {
+            pthread_join(threads[t], NULL);
+            errors += args[t].errors;
+        }
+        
+        printf("%s: %d threads x %d lookups, %d errors\n",
+               mo_get_search_method(ctx), THREAD_COUNT, ROUNDS, errors);
+        if (errors != 0)
+        {
+            exit = 1;
+        }
+        
+        mo_context_free(ctx);
+    }
+    
+    if (check_parallel_build() != 0)
+    {
+        exit = 1;
+    }
+    
+    return exit;
+}
@@ -0,0 +1,384 @@
+/**
+ * @file test_mo_writer.c
+ * @brief MO文件编译器测试：与msgfmt的输出一致、内嵌哈希表可用、字符串按热度排列
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mo_writer.h"
+#include "test_common.h"
+
+/* 按顺序记录枚举到的条目 */
+typedef struct {
+    char original[64][128];
+    char translation[64][256];
+    int count;
+} entry_list_t;
+
+static bool record_entry(const char* original, size_t original_len,
+                         const char* translation, void* user_data)
+{
+    entry_list_t* list = (entry_list_t*)user_data;
+    if (list->count < 64)
+    {
+        snprintf(list->original[list->count], sizeof(list->original[0]), "%.*s",
+                 (int)original_len, original);
+        snprintf(list->translation[list->count], sizeof(list->translation[0]), "%s", translation);
+        list->count++;
+    }
+    return true;
+}
+
+/**
+ * @brief 读入整个文件
+ */
+static uint8_t* read_file(const char* filename, size_t* size)
+{
+    FILE* file = fopen(filename, "rb");
+    uint8_t* data = NULL;
+    long len;
+    
+    if (!file)
+    {
+        return NULL;
+    }
+    if (fseek(file, 0, SEEK_END) == 0 && (len = ftell(file)) > 0 && fseek(file, 0, SEEK_SET) == 0)
+    {
+        data = (uint8_t*)malloc((size_t)len);
+        if (data && fread(data, 1, (size_t)len, file) != (size_t)len)
+        {
+            free(data);
+            data = NULL;
+        }
+        *size = (size_t)len;
+    }
+    fclose(file);
+    return data;
+}
+
+/**
+ * @brief 是否为不小于3的素数（与哈希表大小的要求相同）
+ */
+static bool is_prime(uint32_t n)
+{
+    bool prime = n >= 3;
+    for (uint32_t d = 2; prime && d <= n / d; d++)
+    {
+        prime = n % d != 0;
+    }
+    return prime;
+}
+
+/**
+ * @brief 检查文件布局：字符串表按原文排序、哈希表大小为不小于条目数4/3（取整）的
+ *        第一个素数p或其后p/8范围内的素数，字符串区中第一个条目是first_hot（为NULL时不检查）
+ */
+static int check_layout(const char* filename, const char* first_hot)
+{
+    size_t size = 0;
+    uint8_t* data = read_file(filename, &size);
+    int failures = 0;
+    
+    if (!data || size < sizeof(mo_header_t))
+    {
+        fprintf(stderr, "FAIL reading %s\n", filename);
+        free(data);
+        return 1;
+    }
+    
+    mo_header_t header;
+    memcpy(&header, data, sizeof(header));
+    const mo_string_entry_t* orig = (const mo_string_entry_t*)(data + header.orig_table_offset);
+    uint32_t first = 0;
+    for (uint32_t i = 0; i < header.num_strings; i++)
+    {
+        if (i > 0 && strcmp((const char*)data + orig[i - 1].offset, (const char*)data + orig[i].offset) >= 0)
+        {
+            fprintf(stderr, "FAIL %s: entries %u and %u are not sorted\n", filename, i - 1, i);
+            failures++;
+        }
+        if (orig[i].offset < orig[first].offset)
+        {
+            first = i;
+        }
+    }
+    
+    uint32_t hash_size = header.hash_table_size;
+    uint32_t smallest = (uint32_t)((uint64_t)header.num_strings * 4 / 3);
+    while (!is_prime(smallest))
+    {
+        smallest++;
+    }
+    if (!is_prime(hash_size) || hash_size < smallest || hash_size > smallest + smallest / 8)
+    {
+        fprintf(stderr, "FAIL %s: hash table size %u for %u strings\n", filename,
+                hash_size, header.num_strings);
+        failures++;
+    }
+    
+    if (first_hot && header.num_strings > 0)
+    {
+        failures += check("first string", (const char*)data + orig[first].offset, first_hot);
+    }
+    
+    free(data);
+    return failures;
+}
+
+/**
+ * @brief mo_msgfmt由.po生成的目录与msgfmt的输出内容一致，并且直接使用内嵌哈希表
+ */
+static int check_same_catalog(const char* written_file, const char* mo_file)
+{
+    static entry_list_t entries;
+    mo_options_t options;
+    mo_context_t* written = NULL;
+    mo_context_t* mo = NULL;
+    int failures = 0;
+    
+    mo_options_init(&options);
+    options.search_method = MO_SEARCH_GETTEXT;
+    if (mo_context_create_ex(written_file, &options, &written) != MO_SUCCESS ||
+        mo_context_create_ex(mo_file, &options, &mo) != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL loading %s / %s\n", written_file, mo_file);
+        mo_context_free(written);
+        mo_context_free(mo);
+        return 1;
+    }
+    
+    failures += check("search method", mo_get_search_method(written), "GETTEXT");
+    if (mo_get_string_count(written) != mo_get_string_count(mo))
+    {
+        fprintf(stderr, "FAIL %s: %u strings, expected %u\n", written_file,
+                mo_get_string_count(written), mo_get_string_count(mo));
+        failures++;
+    }
+    
+    entries.count = 0;
+    mo_foreach_prefix(mo, NULL, 0, record_entry, &entries);
+    for (int i = 0; i < entries.count; i++)
+    {
+        failures += check(entries.original[i], mo_translate(written, entries.original[i]),
+                          entries.translation[i]);
+    }
+    failures += check("missing", mo_translate(written, "No such message"), "No such message");
+    failures += check("language", mo_get_language(written), mo_get_language(mo));
+    failures += check("plural forms", mo_get_plural_forms(written), mo_get_plural_forms(mo));
+    failures += check_layout(written_file, "Title");
+    
+    printf("%s: %u strings, same as %s\n", written_file, mo_get_string_count(written), mo_file);
+    mo_context_free(written);
+    mo_context_free(mo);
+    return failures;
+}
+
+/**
+ * @brief 逐条加入：msgctxt、复数、未翻译条目、常用条目、重复键与无效参数
+ */
+static int check_api(const char* filename)
+{
+    static const char* header[] = {
+        "Language: de\nContent-Type: text/plain; charset=UTF-8\n"
+        "Plural-Forms: nplurals=2; plural=(n != 1);\n"
+    };
+    static const char* open_menu[] = { "Menü öffnen" };
+    static const char* open_file[] = { "Datei öffnen" };
+    static const char* files[] = { "%d Datei", "%d Dateien" };
+    static const char* empty[] = { "" };
+    mo_writer_t* writer = NULL;
+    mo_context_t* ctx = NULL;
+    mo_options_t options;
+    int failures = 0;
+    
+    if (mo_writer_create(&writer) != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL creating writer\n");
+        return 1;
+    }
+    
+    /* 常用条目可以先于条目标记，不存在的键被忽略 */
+    if (mo_writer_add_hot(writer, NULL, "Not in catalog") != MO_SUCCESS ||
+        mo_writer_add_hot(writer, "menu", "Open") != MO_SUCCESS ||
+        mo_writer_add(writer, NULL, "Open", NULL, open_file, 1) != MO_SUCCESS ||
+        mo_writer_add(writer, NULL, "", NULL, header, 1) != MO_SUCCESS ||
+        mo_writer_add(writer, "menu", "Open", NULL, open_menu, 1) != MO_SUCCESS ||
+        mo_writer_add(writer, NULL, "%d file", "%d files", files, 2) != MO_SUCCESS ||
+        mo_writer_add(writer, NULL, "Empty", NULL, empty, 1) != MO_SUCCESS ||
+        mo_writer_add_hot(writer, NULL, "%d file") != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL adding entries\n");
+        failures++;
+    }
+    if (mo_writer_count(writer) != 4)
+    {
+        fprintf(stderr, "FAIL writer count %u, expected 4\n", mo_writer_count(writer));
+        failures++;
+    }
+    
+    /* 无效参数 */
+    if (mo_writer_add(writer, NULL, NULL, NULL, open_file, 1) != MO_ERROR_INVALID_CONTEXT ||
+        mo_writer_add(writer, NULL, "x", NULL, files, 2) != MO_ERROR_INVALID_CONTEXT ||
+        mo_writer_add(writer, NULL, "x", "xs", files, 0) != MO_ERROR_INVALID_CONTEXT ||
+        mo_writer_save(NULL, filename) != MO_ERROR_INVALID_CONTEXT)
+    {
+        fprintf(stderr, "FAIL invalid arguments were accepted\n");
+        failures++;
+    }
+    
+    if (mo_writer_save(writer, filename) != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL saving %s\n", filename);
+        mo_writer_free(writer);
+        return failures + 1;
+    }
+    failures += check_layout(filename, "menu\004Open");
+    
+    /* 各策略加载结果相同，GETTEXT直接使用写入的哈希表 */
+    static const mo_search_method_t methods[] = { MO_SEARCH_GETTEXT, MO_SEARCH_BINARY, MO_SEARCH_HASH };
+    for (size_t m = 0; m < sizeof(methods) / sizeof(methods[0]); m++)
+    {
+        mo_options_init(&options);
+        options.search_method = methods[m];
+        if (mo_context_create_ex(filename, &options, &ctx) != MO_SUCCESS)
+        {
+            fprintf(stderr, "FAIL loading %s\n", filename);
+            failures++;
+            continue;
+        }
+        if (methods[m] == MO_SEARCH_GETTEXT)
+        {
+            failures += check("search method", mo_get_search_method(ctx), "GETTEXT");
+        }
+        failures += check("language", mo_get_language(ctx), "de");
+        failures += check("msgctxt", mo_translate_cp(ctx, "menu", "Open", NULL, 0), "Menü öffnen");
+        failures += check("no msgctxt", mo_translate(ctx, "Open"), "Datei öffnen");
+        failures += check("plural 1", mo_translate_cp(ctx, NULL, "%d file", "%d files", 1), "%d Datei");
+        failures += check("plural 5", mo_translate_cp(ctx, NULL, "%d file", "%d files", 5), "%d Dateien");
+        failures += check("untranslated", mo_translate(ctx, "Empty"), "Empty");
+        mo_context_free(ctx);
+        ctx = NULL;
+    }
+    
+    /* 重复的键：写出失败且不留下输出文件 */
+    remove(filename);
+    if (mo_writer_add(writer, NULL, "Open", NULL, open_menu, 1) != MO_SUCCESS ||
+        mo_writer_save(writer, filename) != MO_ERROR_INVALID_FORMAT)
+    {
+        fprintf(stderr, "FAIL duplicate key was accepted\n");
+        failures++;
+    }
+    FILE* left = fopen(filename, "rb");
+    if (left)
+    {
+        fprintf(stderr, "FAIL incomplete output was left behind\n");
+        fclose(left);
+        failures++;
+    }
+    
+    mo_writer_free(writer);
+    printf("Writer API checks: %s\n", failures ? "FAILED" : "passed");
+    return failures;
+}
+
+/**
+ * @brief 大目录：重新写出已加载的目录后全部条目都能经内嵌哈希表找到
+ */
+static int check_large(const char* filename)
+{
+    const uint32_t entries = 20000;
+    mo_writer_t* writer = NULL;
+    mo_writer_t* copy = NULL;
+    mo_context_t* ctx = NULL;
+    mo_options_t options;
+    char key[64];
+    char value[64];
+    int failures = 0;
+    
+    if (mo_writer_create(&writer) != MO_SUCCESS || mo_writer_create(&copy) != MO_SUCCESS)
+    {
+        mo_writer_free(writer);
+        return 1;
+    }
+    for (uint32_t i = 0; i < entries; i++)
+    {
+        const char* msgstr[] = { value };
+        snprintf(key, sizeof(key), "Message number %u", i);
+        snprintf(value, sizeof(value), "Nachricht Nummer %u", i);
+        if (mo_writer_add(writer, NULL, key, NULL, msgstr, 1) != MO_SUCCESS)
+        {
+            failures++;
+            break;
+        }
+        if (i % 1000 == 0)
+        {
+            mo_writer_add_hot(writer, NULL, key);
+        }
+    }
+    
+    /* 经已加载的目录再写出一次，结果应完全相同 */
+    mo_options_init(&options);
+    options.search_method = MO_SEARCH_GETTEXT;
+    if (failures || mo_writer_save(writer, filename) != MO_SUCCESS ||
+        mo_context_create_ex(filename, &options, &ctx) != MO_SUCCESS ||
+        mo_writer_add_catalog(copy, ctx) != MO_SUCCESS)
+    {
+        fprintf(stderr, "FAIL writing %u generated entries\n", entries);
+        mo_context_free(ctx);
+        mo_writer_free(writer);
+        mo_writer_free(copy);
+        return failures + 1;
+    }
+    failures += check("search method", mo_get_search_method(ctx), "GETTEXT");
+    for (uint32_t i = 0; i < entries; i++)
+    {
+        snprintf(key, sizeof(key), "Message number %u", i);
+        snprintf(value, sizeof(value), "Nachricht Nummer %u", i);
+        if (strcmp(mo_translate(ctx, key), value) != 0)
+        {
+            fprintf(stderr, "FAIL generated entry %u not found\n", i);
+            failures++;
+            break;
+        }
+    }
+    failures += check("generated missing", mo_translate(ctx, "Message number x"), "Message number x");
+    failures += check_layout(filename, "Message number 0");
+    if (mo_writer_count(copy) != entries)
+    {
+        fprintf(stderr, "FAIL copied %u entries, expected %u\n", mo_writer_count(copy), entries);
+        failures++;
+    }
+    
+    printf("Generated catalog: %u entries found through the embedded hash table\n", entries);
+    mo_context_free(ctx);
+    mo_writer_free(writer);
+    mo_writer_free(copy);
+    return failures;
+}
+
+int main(int argc, char* argv[])
+{
+    int failures = 0;
+    
+    if (argc < 2 || argc % 2 != 0)
+    {
+        fprintf(stderr, "Usage: %s <scratch.mo> [<written.mo> <msgfmt.mo> ...]\n", argv[0]);
+        return 1;
+    }
+    
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        failures += check_same_catalog(argv[i], argv[i + 1]);
+    }
+    failures += check_api(argv[1]);
+    failures += check_large(argv[1]);
+    
+    if (failures)
+    {
+        fprintf(stderr, "%d failure(s)\n", failures);
+        return 1;
+    }
+    printf("All writer tests passed\n");
+    return 0;
+}
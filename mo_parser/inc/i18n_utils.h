@@ -5,19 +5,84 @@
 //===========================================================//
 #include <stdint.h>
 #include <stddef.h>
+#include "mo_parser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 //===========================================================//
 //= Macro definition.                                       =//
 //===========================================================//
-#define I18N_T(T)       (T)
+/*
+ * 按当前翻译目录翻译，未设置目录或未找到翻译时返回原文。
+ * 每个调用点展开出一个静态缓存槽位，记住上次的翻译结果和当时的目录代号；
+ * 目录未切换、未重载时只需比较代号和原文指针，不计算哈希也不经过上下文的查找缓存。
+ * 不支持语句表达式和lambda的编译器退化为直接调用mo_translate。
+ */
+#if defined(__cplusplus)
+#define I18N_T(T)       ([](const char* i18n_text_) -> const char* {            \
+                            static i18n_slot_t i18n_slot_;                     \
+                            return i18n_translate_slot(&i18n_slot_, i18n_text_); \
+                        }(T))
+#elif defined(__GNUC__)
+#define I18N_T(T)       __extension__ ({                                       \
+                            static i18n_slot_t i18n_slot_;                     \
+                            i18n_translate_slot(&i18n_slot_, (T));             \
+                        })
+#else
+#define I18N_T(T)       mo_translate(i18n_get_context(), (T))
+#endif
+/* 仅标记需要翻译的常量文本，不做翻译（供提取工具使用） */
 #define I18N_CT(T)      (T)
 
 //===========================================================//
 //= Data type declare.                                      =//
 //===========================================================//
+/**
+ * @brief I18N_T调用点的缓存槽位（静态零初始化，内部以原子方式访问，不要直接读写）
+ */
+typedef struct {
+    uint32_t seq;               /**< 版本号，奇数表示正在写入 */
+    uint32_t generation;        /**< 翻译时目录的代号，0表示无效 */
+    const char* original;       /**< 原文指针 */
+    const char* translation;    /**< 翻译结果 */
+} i18n_slot_t;
 
 //===========================================================//
 //= Function declare.                                       =//
 //===========================================================//
+/**
+ * @brief 设置I18N_T使用的翻译目录
+ *
+ * @param[in] context 翻译目录，可以是mo_context_create创建的上下文，也可以是
+ *                    mo_gen_c生成并编译进程序的目录（如&mo_catalog_zh_CN），
+ *                    NULL表示不翻译
+ * @note 切换目录后，调用者须保证旧目录在所有线程结束使用前不被释放。
+ */
+void i18n_set_context(mo_context_t* context);
+
+/**
+ * @brief 获取I18N_T使用的翻译目录
+ *
+ * @return mo_context_t* 当前翻译目录，未设置时返回NULL
+ */
+mo_context_t* i18n_get_context(void);
+
+/**
+ * @brief 使用调用点缓存槽位翻译（供I18N_T使用）
+ *
+ * @param[in,out] slot 调用点的缓存槽位
+ * @param[in] text 原文
+ * @return const char* 翻译结果
+ * @note 槽位记录原文指针，同一调用点传入不同的字符串时仍然正确，只是每次都要重新查找。
+ *       返回的字符串与mo_translate相同，目录重载后失效。分页读取的目录返回的翻译
+ *       位于会被覆盖的结果缓冲区中，不记入槽位，每次调用都重新查找。
+ */
+const char* i18n_translate_slot(i18n_slot_t* slot, const char* text);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif // _INCLUDE_I18N_UTILS_H_
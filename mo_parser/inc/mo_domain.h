@@ -0,0 +1,114 @@
+/**
+ * @file mo_domain.h
+ * @brief 多文本域翻译目录集合 - 语言回退链与合并索引
+ * @copyright MIT License
+ *
+ * 将多个文本域（如"app"、"libfoo"）在多个语言（如"zh_CN"、"zh"）下的目录
+ * 加入同一个集合。设置语言后按回退链（zh_CN.UTF-8 → zh_CN → zh → C）为每个
+ * 文本域选出最具体的翻译，并把所有文本域合并为一个索引：无论有多少个文本域
+ * 和候选语言，每次查找只探测一次索引，未翻译的字符串也只需一次查找即可确定。
+ */
+
+#ifndef MO_DOMAIN_H
+#define MO_DOMAIN_H
+
+#include "mo_parser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief 目录集合句柄 */
+typedef struct mo_domain_set mo_domain_set_t;
+
+/**
+ * @brief 创建空的目录集合
+ *
+ * @param[out] set 输出的集合句柄
+ * @return mo_error_t 错误代码
+ */
+mo_error_t mo_domain_set_create(mo_domain_set_t** set);
+
+/**
+ * @brief 释放目录集合及其中的所有目录
+ *
+ * @param[in] set 集合句柄
+ */
+void mo_domain_set_free(mo_domain_set_t* set);
+
+/**
+ * @brief 向集合加入一个目录
+ *
+ * @param[in] set 集合句柄
+ * @param[in] domain 文本域名称，按首次加入的顺序决定不指定文本域查找时的优先级
+ * @param[in] locale 目录的语言（如"zh_CN"、"zh"）
+ * @param[in] context 目录上下文，成功时所有权转移给集合，失败时仍由调用者释放
+ * @return mo_error_t 错误代码
+ *
+ * @note 已设置语言时会重建合并索引，建议先加入全部目录再调用mo_domain_set_set_locale。
+ *       合并索引直接引用目录加入时的当前条目（加入前重载过的上下文使用重载后的目录），
+ *       加入集合的目录不能再调用mo_context_reload或mo_watch_start。
+ */
+mo_error_t mo_domain_set_add(mo_domain_set_t* set, const char* domain,
+                             const char* locale, mo_context_t* context);
+
+/**
+ * @brief 从文件加载目录并加入集合
+ *
+ * @param[in] set 集合句柄
+ * @param[in] domain 文本域名称
+ * @param[in] locale 目录的语言
+ * @param[in] filename MO文件路径
+ * @param[in] options 创建选项，NULL表示使用默认选项
+ * @return mo_error_t 错误代码
+ */
+mo_error_t mo_domain_set_add_file(mo_domain_set_t* set, const char* domain,
+                                  const char* locale, const char* filename,
+                                  const mo_options_t* options);
+
+/**
+ * @brief 设置当前语言并重建合并索引
+ *
+ * @param[in] set 集合句柄
+ * @param[in] locale 语言名称，格式为language[_territory][.codeset][@modifier]；
+ *                   "C"、"POSIX"或NULL表示不翻译
+ * @return mo_error_t 错误代码
+ *
+ * @note 回退链依次为完整名称、去掉编码的名称、language_territory和language。
+ *       重建索引期间不能并发查找；索引建立后查找只读，多个线程可以并发调用。
+ */
+mo_error_t mo_domain_set_set_locale(mo_domain_set_t* set, const char* locale);
+
+/**
+ * @brief 在集合中翻译字符串
+ *
+ * @param[in] set 集合句柄
+ * @param[in] domain 文本域名称，NULL表示按加入顺序在所有文本域中查找
+ * @param[in] original 原始字符串
+ * @return const char* 翻译后的字符串，未找到时返回原始字符串
+ */
+const char* mo_domain_translate(const mo_domain_set_t* set, const char* domain,
+                                const char* original);
+
+/**
+ * @brief 在集合中翻译字符串（带上下文和复数形式）
+ *
+ * @param[in] set 集合句柄
+ * @param[in] domain 文本域名称，NULL表示按加入顺序在所有文本域中查找
+ * @param[in] context_str 上下文字符串（可为NULL）
+ * @param[in] singular 单数形式字符串
+ * @param[in] plural 复数形式字符串（可为NULL）
+ * @param[in] n 数量值
+ * @return const char* 翻译后的字符串
+ *
+ * @note 复数形式按提供该翻译的目录自身的Plural-Forms选择，规则与mo_translate_cp相同。
+ */
+const char* mo_domain_translate_cp(const mo_domain_set_t* set, const char* domain,
+                                   const char* context_str, const char* singular,
+                                   const char* plural, unsigned long n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MO_DOMAIN_H */
@@ -18,6 +18,20 @@
 extern "C" {
 #endif
 
+/**
+ * @brief 按n字节对齐结构体字段
+ * @note 32位平台上uint64_t通常只按4字节对齐，而64位原子访问要求自然对齐。
+ */
+#if defined(__cplusplus) && __cplusplus >= 201103L
+#define MO_ALIGNAS(n) alignas(n)
+#elif defined(_MSC_VER) && !defined(__clang__)
+#define MO_ALIGNAS(n) __declspec(align(n))
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define MO_ALIGNAS(n) _Alignas(n)
+#else
+#define MO_ALIGNAS(n) __attribute__((aligned(n)))
+#endif
+
 /** @brief MO文件解析器上下文句柄 */
 typedef struct mo_context mo_context_t;
 
@@ -65,8 +79,77 @@ typedef struct {
     uint32_t cache_misses;       /**< 缓存未命中次数 */
     uint32_t hash_collisions;    /**< 哈希冲突次数（仅哈希表模式） */
     uint32_t comparisons;        /**< 比较次数（仅线性和二分模式） */
+    uint32_t page_hits;          /**< 页缓存命中次数（仅分页读取的目录） */
+    uint32_t page_misses;        /**< 页缓存未命中、经回调读取的次数（仅分页读取的目录） */
+    uint32_t lookup_misses;      /**< 未找到翻译的查找次数，与total_lookups之比即未命中率 */
+    uint32_t bloom_rejects;      /**< 其中由Bloom过滤器直接判定、未访问索引的次数 */
 } mo_stats_t;
 
+/**
+ * @brief 内存占用明细（字节）
+ *
+ * 条目直接引用目录数据中的字符串表，不再复制；每条目的额外开销即index_bytes / 字符串数量。
+ */
+typedef struct {
+    size_t context_bytes;       /**< 上下文结构（含查找缓存）及头部字段的副本 */
+    size_t data_bytes;          /**< 目录数据（映射的文件、堆上的副本或编译进程序的常量，含转码后的翻译） */
+    bool data_on_heap;          /**< 目录数据是否复制到了堆内存 */
+    size_t index_bytes;         /**< 查找策略在堆上建立的索引 */
+    size_t heap_bytes;          /**< 堆内存合计：上下文、索引及堆上的目录数据 */
+} mo_memory_usage_t;
+
+/**
+ * @brief 目录头部（msgid为空的条目）中的常用字段
+ *
+ * 加载时解析一次，字段值已去掉首尾空白；头部缺少的字段为空字符串，不为NULL。
+ */
+typedef struct {
+    const char* project_id_version; /**< Project-Id-Version */
+    const char* po_revision_date;   /**< PO-Revision-Date */
+    const char* last_translator;    /**< Last-Translator */
+    const char* language_team;      /**< Language-Team */
+    const char* language;           /**< Language，如"zh_CN" */
+    const char* content_type;       /**< Content-Type，如"text/plain; charset=UTF-8" */
+    const char* charset;            /**< 翻译结果的字符集：Content-Type中的charset参数，
+                                         加载时已转换为UTF-8的目录为"UTF-8" */
+    const char* plural_forms;       /**< Plural-Forms原文 */
+    uint32_t nplurals;              /**< 复数形式数量，Plural-Forms缺失或无法解析时为默认规则的2 */
+} mo_metadata_t;
+
+/**
+ * @brief 查找策略
+ */
+typedef enum {
+    MO_SEARCH_DEFAULT = 0,   /**< 使用编译时默认策略（CMake选项MO_SEARCH_METHOD） */
+    MO_SEARCH_LINEAR,        /**< 线性查找，无索引 */
+    MO_SEARCH_BINARY,        /**< 排序后二分查找 */
+    MO_SEARCH_HASH,          /**< 加载时构建哈希表 */
+    MO_SEARCH_GETTEXT,       /**< 使用MO文件内嵌的哈希表，缺失时回退为HASH */
+    MO_SEARCH_AUTO,          /**< 根据目录规模自动选择 */
+    MO_SEARCH_MPH,           /**< 使用离线构建的最小完美哈希，缺失时回退为GETTEXT */
+    MO_SEARCH_EYTZINGER,     /**< 按Eytzinger顺序存放带键前缀的有序索引，支持前缀枚举 */
+    MO_SEARCH_PAGED          /**< 分页读取的目录（由mo_context_create_paged创建，不能通过选项选择） */
+} mo_search_method_t;
+
+/**
+ * @brief 上下文创建选项
+ * @note 使用前须调用mo_options_init初始化，以便兼容后续新增的字段。
+ */
+typedef struct {
+    mo_search_method_t search_method; /**< 查找策略 */
+    bool lazy_index;                  /**< 延迟建立索引：创建后立即可用，索引在后台线程中建立 */
+    uint32_t build_threads;           /**< 校验条目和建立索引时最多使用的线程数，0和1表示单线程 */
+    bool keep_charset;                /**< 不转换编码，按头部声明的字符集原样返回翻译 */
+    bool bloom_filter;                /**< 为全部查找键建立分块Bloom过滤器，多数未命中的查找只访问一条缓存行 */
+} mo_options_t;
+
+/**
+ * @brief 初始化创建选项为默认值
+ * 
+ * @param[out] options 选项结构体指针
+ */
+void mo_options_init(mo_options_t* options);
+
 /**
  * @brief 从文件加载MO文件并创建解析上下文
  * 
@@ -74,11 +157,34 @@ typedef struct {
  * @param[out] context 输出的上下文句柄指针
  * @return mo_error_t 错误代码
  * 
- * @note 此函数会将整个MO文件映射到内存中，以提高访问速度。
- *       使用完成后必须调用mo_context_free释放资源。
+ * @note 此函数以只读方式将MO文件映射到内存（mmap/MapViewOfFile），文件数据
+ *       不会被复制，同一文件在多个进程间共享页缓存。平台不支持映射时回退为
+ *       读取整个文件。使用完成后必须调用mo_context_free释放资源。
  */
 mo_error_t mo_context_create(const char* filename, mo_context_t** context);
 
+/**
+ * @brief 从文件加载MO文件并创建解析上下文（带创建选项）
+ * 
+ * @param[in] filename MO文件路径
+ * @param[in] options 创建选项，NULL表示使用默认选项
+ * @param[out] context 输出的上下文句柄指针
+ * @return mo_error_t 错误代码
+ * 
+ * @note 查找策略按上下文选择，同一进程中的不同上下文可以使用不同的策略。
+ *       设置lazy_index后，需要建立索引的策略（BINARY、HASH、EYTZINGER，以及回退到
+ *       HASH的GETTEXT/MPH）不在创建时建立索引：上下文先使用文件内嵌的哈希表
+ *       （没有时线性扫描）查找，索引在后台线程中建立完成后原子替换，查找结果不变。
+ *       只需翻译少量字符串的短命进程可以省去建立索引的时间。
+ *       build_threads大于1时，大目录的条目校验、哈希计算和排序分块并行执行，
+ *       建立的索引与单线程建立的完全相同。
+ *       设置bloom_filter后，加载时为全部查找键建立分块Bloom过滤器（每键16位，
+ *       每个键的各位落在同一条64字节缓存行中），查找先检查过滤器，未通过的键
+ *       不访问索引直接返回原文。适合未翻译字符串较多的场合（如调试构建）。
+ */
+mo_error_t mo_context_create_ex(const char* filename, const mo_options_t* options,
+                                mo_context_t** context);
+
 /**
  * @brief 从内存数据创建MO解析上下文
  * 
@@ -92,6 +198,88 @@ mo_error_t mo_context_create(const char* filename, mo_context_t** context);
 mo_error_t mo_context_create_from_memory(const uint8_t* data, size_t size, 
                                         mo_context_t** context);
 
+/**
+ * @brief 从内存数据创建MO解析上下文（带创建选项）
+ * 
+ * @param[in] data MO文件数据指针
+ * @param[in] size 数据大小（字节）
+ * @param[in] options 创建选项，NULL表示使用默认选项
+ * @param[out] context 输出的上下文句柄指针
+ * @return mo_error_t 错误代码
+ */
+mo_error_t mo_context_create_from_memory_ex(const uint8_t* data, size_t size,
+                                           const mo_options_t* options,
+                                           mo_context_t** context);
+
+/**
+ * @brief 直接加载.po文件并创建解析上下文（无需msgfmt）
+ * 
+ * @param[in] filename .po文件路径
+ * @param[in] options 创建选项，NULL表示使用默认选项
+ * @param[out] context 输出的上下文句柄指针
+ * @return mo_error_t 错误代码，语法错误时返回MO_ERROR_INVALID_FORMAT（启用日志时报告行号）
+ * 
+ * @note 单遍解析：字符串解开转义后直接写入一块缓冲区，排列方式与MO文件相同，支持
+ *       续行、转义序列、msgctxt和msgid_plural/msgstr[n]。与msgfmt相同，fuzzy条目
+ *       （头部除外）和未翻译的条目不加入目录，重复的条目视为错误。编译结果按原文
+ *       排序后与MO文件走同一条加载路径，查找结果和建立的索引与加载msgfmt的输出
+ *       相同。mo_context_reload和mo_watch_start重新解析.po文件，适合开发时热重载。
+ */
+mo_error_t mo_context_create_from_po(const char* filename, const mo_options_t* options,
+                                     mo_context_t** context);
+
+/**
+ * @brief 分页读取时的读取回调
+ * 
+ * @param[in] user_data mo_paged_options_t中的用户数据
+ * @param[in] offset 目录数据中的偏移
+ * @param[out] buffer 输出缓冲区
+ * @param[in] size 需要读取的字节数（不会越过目录末尾）
+ * @return bool 完整读取size字节时返回true
+ */
+typedef bool (*mo_read_callback_t)(void* user_data, size_t offset, void* buffer, size_t size);
+
+/**
+ * @brief 分页读取选项
+ * @note 使用前须调用mo_paged_options_init初始化，再设置read、user_data和size。
+ */
+typedef struct {
+    mo_read_callback_t read;    /**< 读取回调 */
+    void* user_data;            /**< 传给回调的用户数据 */
+    size_t size;                /**< 目录数据的总字节数 */
+    uint32_t page_size;         /**< 每页字节数，默认256 */
+    uint32_t page_count;        /**< 页缓存的页数，默认8 */
+    uint32_t result_size;       /**< 存放返回的翻译的环形缓冲区字节数，默认512 */
+} mo_paged_options_t;
+
+/**
+ * @brief 初始化分页读取选项为默认值
+ * 
+ * @param[out] options 选项结构体指针
+ */
+void mo_paged_options_init(mo_paged_options_t* options);
+
+/**
+ * @brief 通过读取回调分页访问目录并创建解析上下文
+ * 
+ * @param[in] options 分页读取选项
+ * @param[out] context 输出的上下文句柄指针
+ * @return mo_error_t 错误代码，回调读取失败时返回MO_ERROR_IO
+ * 
+ * @note 适用于目录存放在外部Flash等无法整体载入内存的场合。常驻内存的只有每条目
+ *       8字节的索引（键的哈希值和条目序号）、page_size * page_count字节的页缓存
+ *       和result_size字节的结果缓冲区，与目录文件大小无关。字符串表和字符串按需
+ *       经回调读入页缓存，缓存满时淘汰最久未使用的页；页缓存的命中和未命中次数
+ *       通过mo_get_stats报告。
+ *       返回的翻译复制在结果缓冲区中，在后续查找把缓冲区绕回覆盖之前有效；翻译
+ *       （含复数条目的全部形式）加结尾NUL超过result_size的条目按未翻译处理。
+ *       查找会修改页缓存，同一上下文只能在一个线程中使用。翻译按原字符集返回
+ *       （不转换编码），上下文不能重载，也不能加入文本域集合或用于mo_context_save_mph
+ *       和mo_translate_batch。
+ *       回调在创建期间和之后的每次查找中调用，须在上下文释放前保持可用。
+ */
+mo_error_t mo_context_create_paged(const mo_paged_options_t* options, mo_context_t** context);
+
 /**
  * @brief 释放MO解析上下文
  * 
@@ -99,6 +287,87 @@ mo_error_t mo_context_create_from_memory(const uint8_t* data, size_t size,
  */
 void mo_context_free(mo_context_t* context);
 
+/**
+ * @brief 重新加载上下文创建时的MO文件（热重载）
+ * 
+ * @param[in] context 由mo_context_create/mo_context_create_ex创建的上下文
+ * @return mo_error_t 错误代码，失败时上下文继续使用原来的目录
+ * 
+ * @note 在调用线程中加载新文件并建立索引，然后以一次原子指针替换发布，上下文
+ *       句柄保持不变。查找不加锁：读者进入查找时登记所在纪元，本函数等待替换前
+ *       进入的读者全部离开后才释放旧目录（基于纪元的回收），因此会阻塞到这些
+ *       查找结束为止，不能在mo_read_begin/mo_read_end之间调用。
+ *       旧目录释放后，此前返回的翻译字符串随之失效；需要跨越重载持有翻译结果的
+ *       调用者应在读取区间内使用，或自行复制。统计计数随目录一起重置。
+ *       从内存创建的上下文和编译进程序的目录不能重载。
+ */
+mo_error_t mo_context_reload(mo_context_t* context);
+
+/**
+ * @brief 进入读取区间
+ * 
+ * @note 区间内取得的翻译字符串在mo_read_end之前不会被mo_context_reload释放。
+ *       可以嵌套，只登记最外层；只涉及本线程槽位的原子读写，不会阻塞。
+ *       各查找函数内部已自动进入读取区间，只在需要延长翻译结果的有效期时使用。
+ */
+void mo_read_begin(void);
+
+/**
+ * @brief 离开读取区间
+ */
+void mo_read_end(void);
+
+/** @brief 文件监视句柄 */
+typedef struct mo_watch mo_watch_t;
+
+/**
+ * @brief 重载完成回调
+ * 
+ * @param[in] context 被重载的上下文
+ * @param[in] result mo_context_reload的返回值
+ * @param[in] user_data mo_watch_start传入的用户数据
+ */
+typedef void (*mo_reload_callback_t)(mo_context_t* context, mo_error_t result, void* user_data);
+
+/**
+ * @brief 监视上下文对应的MO文件，文件变化后在后台线程中自动重载
+ * 
+ * @param[in] context 由文件创建的上下文
+ * @param[in] callback 每次重载后调用（在监视线程中），可为NULL
+ * @param[in] user_data 传给回调的用户数据
+ * @param[out] watch 输出的监视句柄
+ * @return mo_error_t 错误代码，平台不支持（非Linux）时返回MO_ERROR_IO
+ * 
+ * @note 基于inotify监视文件所在目录，文件被写入关闭（IN_CLOSE_WRITE）或以
+ *       重命名方式替换（IN_MOVED_TO）时触发重载。应先写入临时文件再重命名：
+ *       当前目录以mmap映射原文件，原地覆盖会破坏正在使用的目录，也可能加载到
+ *       写了一半的文件；加载失败时保留原目录并通过回调报告。
+ *       必须在释放上下文之前调用mo_watch_stop。
+ */
+mo_error_t mo_watch_start(mo_context_t* context, mo_reload_callback_t callback,
+                          void* user_data, mo_watch_t** watch);
+
+/**
+ * @brief 停止监视并等待监视线程退出
+ * 
+ * @param[in] watch 监视句柄
+ */
+void mo_watch_stop(mo_watch_t* watch);
+
+/**
+ * @brief 为目录构建最小完美哈希并写入新文件
+ * 
+ * @param[in] context MO上下文句柄
+ * @param[in] filename 输出文件路径
+ * @return mo_error_t 错误代码
+ * 
+ * @note 输出文件为原MO数据后追加哈希段（字节序与原文件一致），仍是合法的MO文件，
+ *       其他gettext实现会忽略追加的数据。使用MO_SEARCH_MPH加载时直接读取该段，
+ *       每次查找只需一次哈希、一次表读取和一次memcmp，运行时无需构建索引。
+ *       该函数供构建期工具调用，若输入已带有哈希段则重新构建。
+ */
+mo_error_t mo_context_save_mph(const mo_context_t* context, const char* filename);
+
 /**
  * @brief 获取翻译字符串
  * 
@@ -106,7 +375,7 @@ void mo_context_free(mo_context_t* context);
  * @param[in] original 原始字符串（需要翻译的字符串）
  * @return const char* 翻译后的字符串，未找到时返回原始字符串
  * 
- * @note 根据编译时选择的查找策略（LINEAR/BINARY/HASH）使用不同的查找算法。
+ * @note 使用上下文创建时选定的查找策略（LINEAR/BINARY/HASH/GETTEXT/MPH）。
  */
 const char* mo_translate(mo_context_t* context, const char* original);
 
@@ -117,10 +386,70 @@ const char* mo_translate(mo_context_t* context, const char* original);
  * @param[in] original 原始字符串
  * @param[in] original_len 原始字符串长度
  * @return const char* 翻译后的字符串
+ * 
+ * @note 线程安全：索引在创建后只读，查找缓存与统计计数均为无锁原子操作，
+ *       同一上下文可被任意多个线程并发查找。上下文的创建和释放仍须由调用者
+ *       保证与查找互斥。
  */
 const char* mo_translate_n(mo_context_t* context, 
                           const char* original, size_t original_len);
 
+/**
+ * @brief 批量获取翻译字符串
+ * 
+ * @param[in] context MO上下文句柄
+ * @param[in] keys 原始字符串数组
+ * @param[in] lens 原始字符串长度数组，NULL表示按strlen计算
+ * @param[out] out 输出的翻译数组，未找到的项输出原始字符串
+ * @param[in] n 字符串数量
+ * @return size_t 找到翻译的字符串数量
+ * 
+ * @note 先计算所有键的哈希并预取哈希槽位和键数据，再统一比较，使大目录中
+ *       各次查找的内存访问延迟相互重叠。适合一次翻译大量表头、标签等字符串。
+ *       批量查找不经过单条查找缓存。分页读取的目录不支持批量查找（结果缓冲区放不下
+ *       整批翻译），全部输出原始字符串并返回0。
+ */
+size_t mo_translate_batch(mo_context_t* context, const char** keys, const size_t* lens,
+                          const char** out, size_t n);
+
+/**
+ * @brief 预先计算的翻译键
+ * 
+ * 由mo_key_make（或C++中的mo_key_literal）创建一次，之后反复传给mo_translate_key。
+ * 创建时算好长度和哈希值；首次在某个目录中查找后记住条目序号，之后同一目录中的
+ * 查找只需读取一次绑定缓存。应保存在可写的存储中（如static变量），不要声明为const。
+ */
+typedef struct {
+    const char* str;    /**< 原始字符串 */
+    size_t len;         /**< 字符串长度 */
+    uint32_t hash;      /**< 哈希值（与HASH/MPH策略相同） */
+    MO_ALIGNAS(8) uint64_t binding; /**< 绑定缓存：高32位为目录代号，低32位为条目序号，内部以原子方式访问 */
+} mo_key_t;
+
+/**
+ * @brief 创建翻译键
+ * 
+ * @param[in] str 原始字符串，须在键的整个生命周期内有效
+ * @param[in] len 字符串长度
+ * @return mo_key_t 尚未绑定目录的翻译键
+ */
+mo_key_t mo_key_make(const char* str, size_t len);
+
+/**
+ * @brief 使用预先计算的键获取翻译字符串
+ * 
+ * @param[in] context MO上下文句柄
+ * @param[in,out] key 翻译键，查找后更新其绑定缓存
+ * @return const char* 翻译后的字符串，未找到时返回key->str
+ * 
+ * @note 不计算哈希也不调用strlen。键记住上次查找的目录代号和条目序号（包括未找到），
+ *       再次在同一目录中查找时直接取出翻译；每个加载的目录有唯一的代号，重载后
+ *       代号改变，绑定自动失效并在下次查找时重新解析。多个线程可以共享同一个键，
+ *       绑定以单个64位原子变量读写；在不同上下文之间交替使用同一个键仍然正确，
+ *       只是每次都要重新解析。
+ */
+const char* mo_translate_key(mo_context_t* context, mo_key_t* key);
+
 /**
  * @brief 获取翻译字符串（带上下文和复数形式）
  * 
@@ -131,7 +460,9 @@ const char* mo_translate_n(mo_context_t* context,
  * @param[in] n 数量值
  * @return const char* 翻译后的字符串
  * 
- * @note 上下文格式为"context\004original"，复数形式使用gettext标准规则。
+ * @note 上下文格式为"context\004original"。复数形式按目录头部Plural-Forms的
+ *       plural表达式（加载时编译）对n求值，返回对应的msgstr[n]；头部未声明时
+ *       按n != 1选择。未找到翻译时，n == 1返回singular，否则返回plural。
  */
 const char* mo_translate_cp(mo_context_t* context, 
                            const char* context_str,
@@ -139,6 +470,36 @@ const char* mo_translate_cp(mo_context_t* context,
                            const char* plural,
                            unsigned long n);
 
+/**
+ * @brief 枚举条目时的回调
+ * 
+ * @param[in] original 条目的查找键（带上下文时为"context\004msgid"，复数条目为单数msgid），不以NUL结尾
+ * @param[in] original_len 查找键长度
+ * @param[in] translation 翻译字符串（复数条目为msgstr[0]）
+ * @param[in] user_data 调用者传入的参数
+ * @return bool 返回false停止枚举
+ */
+typedef bool (*mo_entry_callback_t)(const char* original, size_t original_len,
+                                    const char* translation, void* user_data);
+
+/**
+ * @brief 枚举查找键以指定前缀开头的条目
+ * 
+ * @param[in] context MO上下文句柄
+ * @param[in] prefix 键前缀，可以包含上下文和\004分隔符
+ * @param[in] prefix_len 前缀长度，0表示枚举所有条目
+ * @param[in] callback 每个匹配条目调用一次
+ * @param[in] user_data 传给回调的参数
+ * @return size_t 调用回调的次数
+ * 
+ * @note BINARY和EYTZINGER策略按有序索引定位第一个匹配的条目，按字节序依次回调，
+ *       不访问前缀范围以外的条目；其他策略按文件中的顺序扫描全部条目。头部条目
+ *       （空msgid）不会被枚举。回调在读取区间内执行，传入的字符串在回调返回前有效，
+ *       回调中不能重载或释放该上下文。
+ */
+size_t mo_foreach_prefix(mo_context_t* context, const char* prefix, size_t prefix_len,
+                         mo_entry_callback_t callback, void* user_data);
+
 /**
  * @brief 获取MO文件中的字符串数量
  * 
@@ -147,6 +508,52 @@ const char* mo_translate_cp(mo_context_t* context,
  */
 uint32_t mo_get_string_count(const mo_context_t* context);
 
+/**
+ * @brief 获取上下文当前目录的代号
+ * 
+ * @param[in] context MO上下文句柄
+ * @return uint32_t 目录代号，context为NULL时返回0
+ * 
+ * @note 每个加载的目录有唯一的非0代号，重载后改变。调用者可以把翻译结果与代号
+ *       一起缓存，代号不变时缓存的翻译仍然有效。只读取句柄自身的字段，不进入读取区间。
+ */
+uint32_t mo_get_generation(const mo_context_t* context);
+
+/**
+ * @brief 获取目录头部元数据
+ * 
+ * @param[in] context MO上下文句柄
+ * @return const mo_metadata_t* 加载时解析的头部字段，context为NULL时返回NULL
+ * 
+ * @note 与翻译结果相同，返回的数据在上下文重载或释放前有效。头部条目不参与查找，
+ *       mo_translate(ctx, "")返回""本身。
+ */
+const mo_metadata_t* mo_get_metadata(const mo_context_t* context);
+
+/**
+ * @brief 获取目录的字符集（Content-Type中的charset参数）
+ * 
+ * @param[in] context MO上下文句柄
+ * @return const char* 字符集名称，缺失或context为NULL时返回""
+ */
+const char* mo_get_charset(const mo_context_t* context);
+
+/**
+ * @brief 获取目录的语言（头部的Language字段）
+ * 
+ * @param[in] context MO上下文句柄
+ * @return const char* 语言代码，缺失或context为NULL时返回""
+ */
+const char* mo_get_language(const mo_context_t* context);
+
+/**
+ * @brief 获取目录头部的Plural-Forms原文
+ * 
+ * @param[in] context MO上下文句柄
+ * @return const char* 如"nplurals=2; plural=(n != 1);"，缺失或context为NULL时返回""
+ */
+const char* mo_get_plural_forms(const mo_context_t* context);
+
 /**
  * @brief 获取错误描述信息
  * 
@@ -171,16 +578,86 @@ void mo_enable_logging(bool enable);
  */
 bool mo_get_stats(const mo_context_t* context, mo_stats_t* stats);
 
+/**
+ * @brief 获取内存占用明细
+ * 
+ * @param[in] context MO上下文句柄
+ * @param[out] usage 内存占用明细
+ * @return bool 成功返回true，参数无效时返回false
+ */
+bool mo_get_memory_usage(const mo_context_t* context, mo_memory_usage_t* usage);
+
 /**
  * @brief 获取当前使用的查找方法
  * 
  * @param[in] context MO上下文句柄
- * @return const char* 查找方法字符串
+ * @return const char* 查找方法字符串，为该上下文实际使用的策略
+ *         （如GETTEXT回退后报告HASH，AUTO报告最终选定的策略）
  */
 const char* mo_get_search_method(const mo_context_t* context);
 
 #ifdef __cplusplus
 }
-#endif
+
+#if __cplusplus >= 201402L
+/* 编译期计算翻译键：与mo_hash_bytes相同的算法（修改时两处须保持一致） */
+namespace mo_detail {
+
+constexpr uint64_t mo_hash_mum(uint64_t a, uint64_t b)
+{
+    uint64_t ha = a >> 32, la = (uint32_t)a;
+    uint64_t hb = b >> 32, lb = (uint32_t)b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    return lo ^ hi;
+}
+
+/* 按小端顺序组装至多8个字节 */
+constexpr uint64_t mo_hash_chunk(const char* p, size_t n)
+{
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        v |= (uint64_t)(uint8_t)p[i] << (8 * i);
+    }
+    return v;
+}
+
+constexpr uint32_t mo_hash_bytes(const char* str, size_t len)
+{
+    uint64_t h = 0xa0761d6478bd642fULL;
+    size_t pos = 0;
+    while (len - pos >= 8)
+    {
+        h = mo_hash_mum(h ^ mo_hash_chunk(str + pos, 8), 0xe7037ed1a0b428dbULL);
+        pos += 8;
+    }
+    h = mo_hash_mum(h ^ mo_hash_chunk(str + pos, len - pos),
+                    0x8ebc6af09c88c6e3ULL ^ (uint64_t)len);
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+} /* namespace mo_detail */
+
+/**
+ * @brief 在编译期创建字符串字面量的翻译键
+ * 
+ * @code
+ * static mo_key_t k_open = mo_key_literal("Open");  // 常量初始化，运行时不计算
+ * puts(mo_translate_key(ctx, &k_open));
+ * @endcode
+ */
+template <size_t N>
+constexpr mo_key_t mo_key_literal(const char (&str)[N])
+{
+    return mo_key_t{ str, N - 1, mo_detail::mo_hash_bytes(str, N - 1), 0 };
+}
+#endif /* __cplusplus >= 201402L */
+
+#endif /* __cplusplus */
 
 #endif /* MO_PARSER_H */
@@ -0,0 +1,118 @@
+/**
+ * @file mo_writer.h
+ * @brief MO文件编译器 - 生成为查找优化的标准MO文件
+ * @copyright MIT License
+ *
+ * 收集条目（逐条加入、来自已加载的目录或.po文件）后写出标准MO文件，可以替代
+ * msgfmt在构建流程中生成目录。输出文件带有按条目数选定大小的gettext哈希表，
+ * GNU gettext和MO_SEARCH_GETTEXT策略加载后无需建立索引即可查找；字符串区按
+ * 访问热度排列，每个条目的原文和翻译相邻存放，常用条目集中在文件前部的少数页中。
+ */
+
+#ifndef MO_WRITER_H
+#define MO_WRITER_H
+
+#include "mo_parser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief MO文件编译器句柄 */
+typedef struct mo_writer mo_writer_t;
+
+/**
+ * @brief 创建空的编译器
+ *
+ * @param[out] writer 输出的编译器句柄
+ * @return mo_error_t 错误代码
+ */
+mo_error_t mo_writer_create(mo_writer_t** writer);
+
+/**
+ * @brief 释放编译器
+ *
+ * @param[in] writer 编译器句柄
+ */
+void mo_writer_free(mo_writer_t* writer);
+
+/**
+ * @brief 加入一个条目
+ *
+ * @param[in] writer 编译器句柄
+ * @param[in] msgctxt 消息上下文（可为NULL）
+ * @param[in] msgid 原文，空字符串且msgctxt为NULL时是目录头部
+ * @param[in] msgid_plural 复数原文（可为NULL）
+ * @param[in] msgstr 翻译数组，复数条目按msgstr[0..count-1]排列
+ * @param[in] count 翻译个数，非复数条目必须为1
+ * @return mo_error_t 错误代码，参数无效时返回MO_ERROR_INVALID_CONTEXT
+ *
+ * @note 与msgfmt相同，msgstr[0]为空的条目视为未翻译，不写入目录；头部中的
+ *       POT-Creation-Date行被删去。
+ *       字符串按原样复制，字符集应与头部Content-Type声明的一致。
+ */
+mo_error_t mo_writer_add(mo_writer_t* writer, const char* msgctxt, const char* msgid,
+                         const char* msgid_plural, const char* const* msgstr, uint32_t count);
+
+/**
+ * @brief 加入已加载目录中的全部条目
+ *
+ * @param[in] writer 编译器句柄
+ * @param[in] context 目录上下文（不能是分页读取的上下文）
+ * @return mo_error_t 错误代码
+ *
+ * @note 加载时转换过编码的目录按文件中的原始字节复制翻译，与头部声明的字符集一致。
+ */
+mo_error_t mo_writer_add_catalog(mo_writer_t* writer, const mo_context_t* context);
+
+/**
+ * @brief 解析.po文件并加入其中的全部条目
+ *
+ * @param[in] writer 编译器句柄
+ * @param[in] filename .po文件路径
+ * @return mo_error_t 错误代码，语法错误时返回MO_ERROR_INVALID_FORMAT
+ *
+ * @note 解析规则与mo_context_create_from_po相同：跳过fuzzy、未翻译和废弃的条目。
+ */
+mo_error_t mo_writer_add_po(mo_writer_t* writer, const char* filename);
+
+/**
+ * @brief 标记一个常用条目
+ *
+ * @param[in] writer 编译器句柄
+ * @param[in] msgctxt 消息上下文（可为NULL）
+ * @param[in] msgid 原文
+ * @return mo_error_t 错误代码
+ *
+ * @note 字符串区中先按标记顺序存放常用条目，再按原文顺序存放其余条目；字符串表
+ *       和哈希表不受影响。可以在加入条目之前或之后标记，目录中不存在的键被忽略。
+ */
+mo_error_t mo_writer_add_hot(mo_writer_t* writer, const char* msgctxt, const char* msgid);
+
+/**
+ * @brief 返回已加入的条目数
+ *
+ * @param[in] writer 编译器句柄
+ * @return uint32_t 条目数（含头部）
+ */
+uint32_t mo_writer_count(const mo_writer_t* writer);
+
+/**
+ * @brief 写出MO文件
+ *
+ * @param[in] writer 编译器句柄
+ * @param[in] filename 输出文件路径
+ * @return mo_error_t 错误代码，存在重复的键时返回MO_ERROR_INVALID_FORMAT
+ *
+ * @note 文件按主机字节序写出，布局与msgfmt相同：头部、按原文排序的原文/翻译
+ *       字符串表、哈希表、字符串区。哈希表使用hashpjw和双重哈希探测，大小在不小于
+ *       条目数4/3的第一个素数及其后1/8范围内的素数中选取探测次数最少的一个。
+ *       写入失败时不留下不完整的文件。
+ */
+mo_error_t mo_writer_save(const mo_writer_t* writer, const char* filename);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MO_WRITER_H */
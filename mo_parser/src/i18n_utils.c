@@ -0,0 +1,81 @@
+/**
+ * @file i18n_utils.c
+ * @brief I18N_T宏使用的全局翻译目录
+ */
+
+#include "i18n_utils.h"
+#include "mo_internal.h"
+#include <stdatomic.h>
+
+/* 当前翻译目录，读写都是原子操作，切换目录时不影响其他线程的查找 */
+static _Atomic(mo_context_t*) g_i18n_context = NULL;
+
+/**
+ * @brief 设置I18N_T使用的翻译目录
+ */
+void i18n_set_context(mo_context_t* context)
+{
+    atomic_store_explicit(&g_i18n_context, context, memory_order_release);
+}
+
+/**
+ * @brief 获取I18N_T使用的翻译目录
+ */
+mo_context_t* i18n_get_context(void)
+{
+    return atomic_load_explicit(&g_i18n_context, memory_order_acquire);
+}
+
+/**
+ * @brief 使用调用点缓存槽位翻译
+ *
+ * @note 槽位按顺序锁读写（与上下文的查找缓存相同）：版本号为奇数时正在写入，
+ *       读取前后版本号一致才采用，写入冲突时放弃写入，不会读到混合的字段。
+ */
+const char* i18n_translate_slot(i18n_slot_t* slot, const char* text)
+{
+    mo_context_t* context = i18n_get_context();
+    uint32_t current;
+    uint32_t version;
+    const char* result;
+
+    if (!context || !text)
+    {
+        return text;
+    }
+
+    /* 切换目录或重载后代号改变，槽位自动失效 */
+    current = mo_get_generation(context);
+    version = MO_ATOMIC_LOAD_U32(&slot->seq, ACQUIRE);
+    if (!(version & 1u) &&
+        MO_ATOMIC_LOAD_U32(&slot->generation, RELAXED) == current &&
+        MO_ATOMIC_LOAD_PTR(&slot->original, RELAXED) == text)
+    {
+        result = MO_ATOMIC_LOAD_PTR(&slot->translation, RELAXED);
+        atomic_thread_fence(memory_order_acquire);
+        if (MO_ATOMIC_LOAD_U32(&slot->seq, RELAXED) == version)
+        {
+            return result;
+        }
+    }
+
+    /* 先取代号再查找：查找期间发生重载时，槽位记录的是旧代号，下次调用会重新查找 */
+    result = mo_translate(context, text);
+
+    /* 分页读取的翻译会被后续查找覆盖，与上下文的查找缓存相同，不能保存指针 */
+    if (context->paged)
+    {
+        return result;
+    }
+
+    version = MO_ATOMIC_LOAD_U32(&slot->seq, RELAXED);
+    if (!(version & 1u) && MO_ATOMIC_CAS_U32(&slot->seq, &version, version + 1u))
+    {
+        atomic_thread_fence(memory_order_release);
+        MO_ATOMIC_STORE_U32(&slot->generation, current, RELAXED);
+        MO_ATOMIC_STORE_PTR(&slot->original, text, RELAXED);
+        MO_ATOMIC_STORE_PTR(&slot->translation, result, RELAXED);
+        MO_ATOMIC_STORE_U32(&slot->seq, version + 2u, RELEASE);
+    }
+    return result;
+}
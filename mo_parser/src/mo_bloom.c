@@ -0,0 +1,85 @@
+/**
+ * @file mo_bloom.c
+ * @brief 未命中过滤 - 分块Bloom过滤器
+ *
+ * 每个块是一条64字节的缓存行，由8个64位字组成；每个键由哈希值选定一个块，并在
+ * 块内每个字中各置1位。判断键是否存在只读取这一条缓存行，与查找策略的索引无关，
+ * 因此对所有策略都适用。每键16位时误判率约为0.1%。
+ */
+
+#include "mo_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* 块的对齐字节数（缓存行大小） */
+#define MO_BLOOM_ALIGN 64
+
+/**
+ * @brief 为全部查找键建立Bloom过滤器
+ *
+ * @note 键的哈希值与HASH/MPH策略相同（mo_hash_bytes），使用这些策略时查找可以
+ *       直接复用已算出的哈希值。
+ */
+mo_error_t mo_bloom_build(mo_context_t* ctx)
+{
+    uint64_t* words;
+    uintptr_t aligned;
+    uint64_t bits = (uint64_t)ctx->num_strings * MO_BLOOM_BITS_PER_KEY;
+    uint32_t blocks = (uint32_t)((bits + MO_BLOOM_WORDS * 64 - 1) / (MO_BLOOM_WORDS * 64));
+    uint32_t i;
+    
+    if (blocks == 0)
+    {
+        blocks = 1;
+    }
+    
+    ctx->bloom_block = malloc((size_t)blocks * MO_BLOOM_WORDS * sizeof(uint64_t) + MO_BLOOM_ALIGN);
+    if (!ctx->bloom_block)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    
+    aligned = ((uintptr_t)ctx->bloom_block + MO_BLOOM_ALIGN - 1) & ~(uintptr_t)(MO_BLOOM_ALIGN - 1);
+    words = (uint64_t*)aligned;
+    memset(words, 0, (size_t)blocks * MO_BLOOM_WORDS * sizeof(uint64_t));
+    ctx->bloom = words;
+    ctx->bloom_blocks = blocks;
+    
+    for (i = 0; i < ctx->num_strings; i++)
+    {
+        uint32_t len;
+        const char* key;
+        uint64_t* block;
+        uint32_t hash;
+        uint32_t w;
+    
+        /* 头部条目不参与查找 */
+        if (i == ctx->header_index)
+        {
+            continue;
+        }
+    
+        key = mo_entry_key(ctx, i, &len);
+        hash = mo_hash_bytes(key, len);
+        block = (uint64_t*)mo_bloom_block(ctx, hash);
+        for (w = 0; w < MO_BLOOM_WORDS; w++)
+        {
+            block[w] |= mo_bloom_bit(hash, w);
+        }
+    }
+    
+    mo_log(ctx, "Built Bloom filter: %u blocks (%zu bytes) for %u entries",
+           blocks, (size_t)blocks * MO_BLOOM_WORDS * sizeof(uint64_t), ctx->num_strings);
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 释放Bloom过滤器（可重复调用）
+ */
+void mo_bloom_release(mo_context_t* ctx)
+{
+    free(ctx->bloom_block);
+    ctx->bloom_block = NULL;
+    ctx->bloom = NULL;
+    ctx->bloom_blocks = 0;
+}
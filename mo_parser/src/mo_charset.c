@@ -0,0 +1,463 @@
+/**
+ * @file mo_charset.c
+ * @brief 加载时把非UTF-8目录的翻译转换为UTF-8
+ *
+ * 头部声明的字符集不是UTF-8（或其子集ASCII）时，加载时逐条转换全部翻译，结果连同
+ * 新的翻译字符串表一起放在一块连续的堆内存中，此后查找返回的仍是指向这块内存的
+ * 指针，不再有逐次转换的开销。原文（查找键）不转换。
+ *
+ * ISO-8859-1和Windows-1252由内置表解码；其他字符集（GBK、Shift_JIS等）在POSIX
+ * 平台使用iconv，在Windows上使用MultiByteToWideChar。无法识别的字节序列替换为
+ * U+FFFD。平台不支持的字符集保留原始字节并记录日志。
+ */
+
+#include "mo_internal.h"
+#include "unicode_utils.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(MO_HAVE_ICONV)
+#include <errno.h>
+#include <iconv.h>
+#endif
+
+/* 规范化后字符集名称的最大长度 */
+#define MO_CHARSET_NAME_MAX 32
+
+/* 替换无法解码的字节 */
+#define MO_REPLACEMENT_CHAR 0xFFFDu
+
+/* 转换方式 */
+typedef enum {
+    MO_CHARSET_UTF8,        /**< 无需转换 */
+    MO_CHARSET_LATIN1,      /**< ISO-8859-1，字节值即码点 */
+    MO_CHARSET_CP1252,      /**< Windows-1252，0x80-0x9F查表 */
+    MO_CHARSET_SYSTEM,      /**< 交给平台的转换接口 */
+} mo_charset_kind_t;
+
+/* 转换器 */
+typedef struct {
+    mo_charset_kind_t kind;
+#ifdef _WIN32
+    UINT code_page;
+#elif defined(MO_HAVE_ICONV)
+    iconv_t cd;
+#endif
+} mo_converter_t;
+
+/* 输出缓冲区，前部为翻译字符串表，之后依次存放转换后的字符串 */
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+} mo_arena_t;
+
+/* Windows-1252在0x80-0x9F的码点，未定义的位置与ISO-8859-1相同 */
+static const uint16_t s_cp1252_high[32] = {
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+    0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+    0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+};
+
+static void mo_charset_normalize(const char* name, char* out, size_t size);
+static bool mo_converter_open(mo_converter_t* conv, const char* charset);
+static void mo_converter_close(mo_converter_t* conv);
+static bool mo_arena_reserve(mo_arena_t* arena, size_t extra);
+static bool mo_arena_put_codepoint(mo_arena_t* arena, uint32_t codepoint);
+static bool mo_decode_single_byte(const mo_converter_t* conv, const uint8_t* in, size_t len,
+                                  mo_arena_t* arena);
+static bool mo_decode_system(mo_converter_t* conv, const uint8_t* in, size_t len,
+                             mo_arena_t* arena);
+
+/**
+ * @brief 规范化字符集名称：转为小写并去掉'-'、'_'和空白，如"Shift_JIS"为"shiftjis"
+ */
+static void mo_charset_normalize(const char* name, char* out, size_t size)
+{
+    size_t n = 0;
+    
+    for (; *name && n + 1 < size; name++)
+    {
+        if (*name == '-' || *name == '_' || isspace((unsigned char)*name))
+        {
+            continue;
+        }
+        out[n++] = (char)tolower((unsigned char)*name);
+    }
+    out[n] = '\0';
+}
+
+/**
+ * @brief 按头部声明的字符集准备转换器
+ *
+ * @return 平台不支持该字符集时返回false
+ */
+static bool mo_converter_open(mo_converter_t* conv, const char* charset)
+{
+    char name[MO_CHARSET_NAME_MAX];
+    
+    mo_charset_normalize(charset, name, sizeof(name));
+    memset(conv, 0, sizeof(*conv));
+    
+    /* 没有声明字符集的目录按UTF-8处理，ASCII是UTF-8的子集 */
+    if (name[0] == '\0' || strcmp(name, "utf8") == 0 || strcmp(name, "ascii") == 0 ||
+        strcmp(name, "usascii") == 0 || strcmp(name, "ansix3.41968") == 0)
+    {
+        conv->kind = MO_CHARSET_UTF8;
+        return true;
+    }
+    if (strcmp(name, "iso88591") == 0 || strcmp(name, "latin1") == 0 ||
+        strcmp(name, "l1") == 0 || strcmp(name, "cp819") == 0)
+    {
+        conv->kind = MO_CHARSET_LATIN1;
+        return true;
+    }
+    if (strcmp(name, "cp1252") == 0 || strcmp(name, "windows1252") == 0)
+    {
+        conv->kind = MO_CHARSET_CP1252;
+        return true;
+    }
+    
+    conv->kind = MO_CHARSET_SYSTEM;
+#ifdef _WIN32
+    {
+        /* 常见gettext字符集名称对应的代码页 */
+        static const struct {
+            const char* name;
+            UINT code_page;
+        } s_code_pages[] = {
+            { "gbk", 936 },      { "gb2312", 936 },    { "cp936", 936 },
+            { "gb18030", 54936 },
+            { "shiftjis", 932 }, { "sjis", 932 },      { "cp932", 932 },
+            { "eucjp", 20932 },
+            { "big5", 950 },     { "cp950", 950 },
+            { "euckr", 51949 },  { "cp949", 949 },
+            { "koi8r", 20866 },  { "koi8u", 21866 },
+        };
+    
+        for (size_t i = 0; i < sizeof(s_code_pages) / sizeof(s_code_pages[0]); i++)
+        {
+            if (strcmp(name, s_code_pages[i].name) == 0)
+            {
+                conv->code_page = s_code_pages[i].code_page;
+                return true;
+            }
+        }
+        /* windows125x和iso8859x */
+        if (strncmp(name, "windows", 7) == 0 || strncmp(name, "cp", 2) == 0)
+        {
+            conv->code_page = (UINT)strtoul(name + (name[0] == 'w' ? 7 : 2), NULL, 10);
+        }
+        else if (strncmp(name, "iso8859", 7) == 0)
+        {
+            conv->code_page = 28590 + (UINT)strtoul(name + 7, NULL, 10);
+        }
+        return conv->code_page != 0 && IsValidCodePage(conv->code_page);
+    }
+#elif defined(MO_HAVE_ICONV)
+    /* iconv接受原始名称，规范化后的名称不一定能识别 */
+    conv->cd = iconv_open("UTF-8", charset);
+    return conv->cd != (iconv_t)-1;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 释放转换器
+ */
+static void mo_converter_close(mo_converter_t* conv)
+{
+#if !defined(_WIN32) && defined(MO_HAVE_ICONV)
+    if (conv->kind == MO_CHARSET_SYSTEM && conv->cd != (iconv_t)-1)
+    {
+        iconv_close(conv->cd);
+    }
+#else
+    (void)conv;
+#endif
+}
+
+/**
+ * @brief 确保输出缓冲区还能写入extra字节
+ */
+static bool mo_arena_reserve(mo_arena_t* arena, size_t extra)
+{
+    if (arena->size + extra <= arena->capacity)
+    {
+        return true;
+    }
+    
+    size_t capacity = arena->capacity * 2;
+    if (capacity < arena->size + extra)
+    {
+        capacity = arena->size + extra;
+    }
+    uint8_t* data = (uint8_t*)realloc(arena->data, capacity);
+    if (!data)
+    {
+        return false;
+    }
+    arena->data = data;
+    arena->capacity = capacity;
+    return true;
+}
+
+/**
+ * @brief 写入一个码点的UTF-8编码，无效码点写入U+FFFD
+ */
+static bool mo_arena_put_codepoint(mo_arena_t* arena, uint32_t codepoint)
+{
+    size_t len = 0;
+    
+    /* codepoint_to_utf8要求缓冲区至少5字节 */
+    if (!mo_arena_reserve(arena, 5))
+    {
+        return false;
+    }
+    if (codepoint_to_utf8(codepoint, arena->data + arena->size, &len) != CONV_SUCCESS)
+    {
+        codepoint_to_utf8(MO_REPLACEMENT_CHAR, arena->data + arena->size, &len);
+    }
+    arena->size += len;
+    return true;
+}
+
+/**
+ * @brief 解码单字节字符集（ISO-8859-1、Windows-1252）
+ */
+static bool mo_decode_single_byte(const mo_converter_t* conv, const uint8_t* in, size_t len,
+                                  mo_arena_t* arena)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        uint32_t codepoint = in[i];
+    
+        /* ASCII部分（包括复数形式之间的NUL）原样写入 */
+        if (codepoint < 0x80)
+        {
+            if (!mo_arena_reserve(arena, 1))
+            {
+                return false;
+            }
+            arena->data[arena->size++] = in[i];
+            continue;
+        }
+        if (conv->kind == MO_CHARSET_CP1252 && codepoint < 0xA0)
+        {
+            codepoint = s_cp1252_high[codepoint - 0x80];
+        }
+        if (!mo_arena_put_codepoint(arena, codepoint))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 使用平台接口解码
+ *
+ * @note 长度明确给出，复数形式之间的NUL随其他字符一起转换。
+ */
+static bool mo_decode_system(mo_converter_t* conv, const uint8_t* in, size_t len,
+                             mo_arena_t* arena)
+{
+#ifdef _WIN32
+    if (len == 0)
+    {
+        return true;
+    }
+    
+    /* 先转为UTF-16，再逐个码点写入UTF-8 */
+    int units = MultiByteToWideChar(conv->code_page, 0, (LPCCH)in, (int)len, NULL, 0);
+    uint16_t* wide = units > 0 ? (uint16_t*)malloc((size_t)units * sizeof(uint16_t)) : NULL;
+    bool ok = wide != NULL;
+    
+    if (ok)
+    {
+        MultiByteToWideChar(conv->code_page, 0, (LPCCH)in, (int)len, (LPWSTR)wide, units);
+    }
+    for (int i = 0; ok && i < units; )
+    {
+        uint32_t codepoint = MO_REPLACEMENT_CHAR;
+        size_t used = 1;
+    
+        if (wide[i] == 0)
+        {
+            codepoint = 0;
+        }
+        else if (utf16_to_codepoint(&wide[i], &codepoint, UTF16_NATIVE, &used) != CONV_SUCCESS)
+        {
+            codepoint = MO_REPLACEMENT_CHAR;
+            used = 1;
+        }
+        ok = mo_arena_put_codepoint(arena, codepoint);
+        i += (int)used;
+    }
+    free(wide);
+    return ok;
+#elif defined(MO_HAVE_ICONV)
+    char* src = (char*)in;
+    size_t src_left = len;
+    
+    while (src_left > 0)
+    {
+        /* 每个字符至少占1个输入字节，UTF-8输出不超过4字节 */
+        if (!mo_arena_reserve(arena, src_left * 4 + 8))
+        {
+            return false;
+        }
+        char* dst = (char*)arena->data + arena->size;
+        size_t dst_left = arena->capacity - arena->size;
+        size_t converted = iconv(conv->cd, &src, &src_left, &dst, &dst_left);
+    
+        arena->size = (size_t)((uint8_t*)dst - arena->data);
+        if (converted != (size_t)-1)
+        {
+            continue;
+        }
+        if (errno == E2BIG)
+        {
+            /* 输出超过预留的长度，扩大一倍后继续 */
+            if (!mo_arena_reserve(arena, arena->capacity - arena->size + 64))
+            {
+                return false;
+            }
+            continue;
+        }
+    
+        /* EILSEQ/EINVAL：跳过一个字节并写入替换字符 */
+        src++;
+        src_left--;
+        if (!mo_arena_put_codepoint(arena, MO_REPLACEMENT_CHAR))
+        {
+            return false;
+        }
+    }
+    
+    /* 结束有状态编码（如ISO-2022-JP）的移位状态，并为下一个字符串复位 */
+    if (!mo_arena_reserve(arena, 8))
+    {
+        return false;
+    }
+    char* dst = (char*)arena->data + arena->size;
+    size_t dst_left = arena->capacity - arena->size;
+    iconv(conv->cd, NULL, NULL, &dst, &dst_left);
+    arena->size = (size_t)((uint8_t*)dst - arena->data);
+    return true;
+#else
+    (void)conv;
+    (void)in;
+    (void)len;
+    (void)arena;
+    return false;
+#endif
+}
+
+/**
+ * @brief 把目录的全部翻译转换为UTF-8
+ *
+ * @note 转换后ctx->trans_table和ctx->trans_data指向新分配的连续内存，表项与文件相同
+ *       按need_swap存放，读取路径不变。头部字段随后按转换后的头部重新解析，
+ *       metadata.charset改为"UTF-8"。
+ */
+mo_error_t mo_charset_transcode(mo_context_t* ctx)
+{
+    mo_converter_t conv;
+    mo_arena_t arena = { NULL, 0, 0 };
+    size_t table_bytes = (size_t)ctx->num_strings * sizeof(mo_string_entry_t);
+    mo_error_t result = MO_SUCCESS;
+    uint32_t i;
+    
+    if (!mo_converter_open(&conv, ctx->metadata->charset))
+    {
+        mo_log(ctx, "Charset %s is not supported, translations are returned unconverted",
+               ctx->metadata->charset);
+        return MO_SUCCESS;
+    }
+    if (conv.kind == MO_CHARSET_UTF8)
+    {
+        return MO_SUCCESS;
+    }
+    
+    /* 按原长度预留，多字节输出时再扩大 */
+    size_t capacity = table_bytes;
+    for (i = 0; i < ctx->num_strings; i++)
+    {
+        uint32_t len;
+        mo_entry_translation(ctx, i, &len);
+        capacity += (size_t)len + 1;
+    }
+    if (!mo_arena_reserve(&arena, capacity))
+    {
+        result = MO_ERROR_MEMORY;
+        goto cleanup;
+    }
+    arena.size = table_bytes;
+    
+    for (i = 0; i < ctx->num_strings; i++)
+    {
+        uint32_t len;
+        const uint8_t* in = (const uint8_t*)mo_entry_translation(ctx, i, &len);
+        size_t start = arena.size;
+        bool ok = conv.kind == MO_CHARSET_SYSTEM ?
+                  mo_decode_system(&conv, in, len, &arena) :
+                  mo_decode_single_byte(&conv, in, len, &arena);
+    
+        if (!ok || !mo_arena_reserve(&arena, 1))
+        {
+            result = MO_ERROR_MEMORY;
+            goto cleanup;
+        }
+        arena.data[arena.size++] = '\0';
+        if (arena.size > UINT32_MAX)
+        {
+            result = MO_ERROR_INVALID_FORMAT;
+            goto cleanup;
+        }
+    
+        /* 缓冲区可能已经移动，表项只保存偏移 */
+        mo_string_entry_t* entry = (mo_string_entry_t*)arena.data + i;
+        entry->length = mo_swap_uint32((uint32_t)(arena.size - 1 - start), ctx->need_swap);
+        entry->offset = mo_swap_uint32((uint32_t)start, ctx->need_swap);
+    }
+    
+    /* 归还多余的容量，失败时保留原缓冲区 */
+    uint8_t* shrunk = (uint8_t*)realloc(arena.data, arena.size ? arena.size : 1);
+    if (shrunk)
+    {
+        arena.data = shrunk;
+    }
+    
+    ctx->trans_arena = arena.data;
+    ctx->trans_arena_size = arena.size;
+    ctx->trans_table = (const mo_string_entry_t*)arena.data;
+    ctx->trans_data = arena.data;
+    arena.data = NULL;
+    mo_log(ctx, "Transcoded %u translations from %s to UTF-8: %zu bytes",
+           ctx->num_strings, ctx->metadata->charset, ctx->trans_arena_size);
+    
+    /* 头部本身也是翻译，按转换后的文本重新解析 */
+    const char* header_text = NULL;
+    uint32_t header_len = 0;
+    if (ctx->header_index != MO_INDEX_NONE)
+    {
+        header_text = mo_entry_translation(ctx, ctx->header_index, &header_len);
+    }
+    mo_metadata_release(ctx);
+    result = mo_metadata_parse(ctx, header_text, header_len);
+    if (result == MO_SUCCESS && ctx->metadata_block)
+    {
+        ctx->metadata_block->metadata.charset = "UTF-8";
+    }
+    
+cleanup:
+    mo_converter_close(&conv);
+    free(arena.data);
+    return result;
+}
@@ -0,0 +1,577 @@
+/**
+ * @file mo_domain.c
+ * @brief 多文本域翻译目录集合实现
+ *
+ * 合并索引为线性探测的开放寻址哈希表，每个槽位保存键的哈希值和一条记录链的
+ * 起点。同一msgid在各文本域中的翻译按文本域加入顺序链接，每个文本域只保留
+ * 回退链中最具体语言的那条记录，因此回退和跨文本域查找都在建立索引时完成。
+ */
+
+#include "mo_domain.h"
+#include "mo_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#define MO_DOMAIN_MAX_NAME 64       /**< 文本域和语言名称的最大长度（含NUL） */
+#define MO_DOMAIN_MAX_CHAIN 4       /**< 回退链的最大长度 */
+
+/* 集合中的一个目录 */
+typedef struct {
+    uint32_t domain;                    /**< 文本域序号 */
+    char locale[MO_DOMAIN_MAX_NAME];    /**< 目录的语言 */
+    mo_context_t* context;              /**< 目录上下文（由集合释放） */
+    const mo_context_t* entries;        /**< 合并索引引用的目录：加入时上下文的当前目录 */
+} mo_domain_catalog_t;
+
+/* 合并索引中的一条翻译记录 */
+typedef struct {
+    uint32_t catalog;   /**< 提供翻译的目录序号 */
+    uint32_t entry;     /**< 目录中的条目序号 */
+    uint32_t next;      /**< 同一键在后续文本域中的记录，MO_INDEX_NONE表示结束 */
+} mo_domain_record_t;
+
+/* 目录集合 */
+struct mo_domain_set {
+    char (*domains)[MO_DOMAIN_MAX_NAME];    /**< 文本域名称，按加入顺序排列 */
+    uint32_t num_domains;
+    mo_domain_catalog_t* catalogs;          /**< 全部目录 */
+    uint32_t num_catalogs;
+
+    bool has_locale;                        /**< 是否已设置语言 */
+    char chain[MO_DOMAIN_MAX_CHAIN][MO_DOMAIN_MAX_NAME]; /**< 语言回退链，从具体到一般 */
+    uint32_t chain_len;                     /**< 回退链长度，0表示不翻译 */
+
+    /* 合并索引 */
+    mo_domain_record_t* records;            /**< 翻译记录 */
+    uint32_t num_records;
+    uint32_t* index_hashes;                 /**< 各槽位键的哈希值 */
+    uint32_t* index_heads;                  /**< 各槽位的首条记录，MO_INDEX_NONE表示空槽位 */
+    uint32_t index_mask;                    /**< 槽位数-1（槽位数为2的幂次） */
+};
+
+/* 内部函数声明 */
+static bool mo_domain_copy_name(char* dst, const char* src);
+static uint32_t mo_domain_find(const mo_domain_set_t* set, const char* domain);
+static void mo_domain_chain_add(mo_domain_set_t* set, const char* name, size_t len);
+static void mo_domain_build_chain(mo_domain_set_t* set, const char* locale);
+static uint32_t mo_domain_probe(const mo_domain_set_t* set, const mo_lookup_key_t* key,
+                                uint32_t hash);
+static void mo_domain_insert_catalog(mo_domain_set_t* set, uint32_t catalog);
+static void mo_domain_release_index(mo_domain_set_t* set);
+static mo_error_t mo_domain_build_index(mo_domain_set_t* set);
+static const mo_domain_record_t* mo_domain_lookup(const mo_domain_set_t* set,
+                                                  const char* domain,
+                                                  const mo_lookup_key_t* key);
+
+/**
+ * @brief 复制名称，名称为空或过长时返回false
+ */
+static bool mo_domain_copy_name(char* dst, const char* src)
+{
+    size_t len = src ? strlen(src) : 0;
+    
+    if (len == 0 || len >= MO_DOMAIN_MAX_NAME)
+    {
+        return false;
+    }
+    
+    memcpy(dst, src, len + 1);
+    return true;
+}
+
+/**
+ * @brief 查找文本域序号
+ */
+static uint32_t mo_domain_find(const mo_domain_set_t* set, const char* domain)
+{
+    for (uint32_t i = 0; i < set->num_domains; i++)
+    {
+        if (strcmp(set->domains[i], domain) == 0)
+        {
+            return i;
+        }
+    }
+    return MO_INDEX_NONE;
+}
+
+/**
+ * @brief 向回退链追加一个语言名称（忽略重复项）
+ */
+static void mo_domain_chain_add(mo_domain_set_t* set, const char* name, size_t len)
+{
+    if (len == 0 || len >= MO_DOMAIN_MAX_NAME || set->chain_len >= MO_DOMAIN_MAX_CHAIN)
+    {
+        return;
+    }
+    
+    for (uint32_t i = 0; i < set->chain_len; i++)
+    {
+        if (strlen(set->chain[i]) == len && memcmp(set->chain[i], name, len) == 0)
+        {
+            return;
+        }
+    }
+    
+    memcpy(set->chain[set->chain_len], name, len);
+    set->chain[set->chain_len][len] = '\0';
+    set->chain_len++;
+}
+
+/**
+ * @brief 按language[_territory][.codeset][@modifier]生成回退链
+ */
+static void mo_domain_build_chain(mo_domain_set_t* set, const char* locale)
+{
+    char name[MO_DOMAIN_MAX_NAME];
+    
+    set->chain_len = 0;
+    if (!locale || strcmp(locale, "C") == 0 || strcmp(locale, "POSIX") == 0)
+    {
+        return;
+    }
+    
+    size_t lang_end = strcspn(locale, "_.@");
+    size_t territory_end = strcspn(locale, ".@");
+    const char* modifier = strchr(locale, '@');
+    
+    mo_domain_chain_add(set, locale, strlen(locale));
+    
+    /* language_territory@modifier（去掉编码） */
+    if (modifier && locale[territory_end] == '.')
+    {
+        int len = snprintf(name, sizeof(name), "%.*s%s", (int)territory_end, locale, modifier);
+        if (len > 0 && (size_t)len < sizeof(name))
+        {
+            mo_domain_chain_add(set, name, (size_t)len);
+        }
+    }
+    
+    mo_domain_chain_add(set, locale, territory_end);
+    mo_domain_chain_add(set, locale, lang_end);
+}
+
+/**
+ * @brief 探测合并索引，返回键所在的槽位或应插入的空槽位
+ */
+static uint32_t mo_domain_probe(const mo_domain_set_t* set, const mo_lookup_key_t* key,
+                                uint32_t hash)
+{
+    uint32_t slot = hash & set->index_mask;
+    
+    /* 装载因子不超过1/2，必然存在空槽位 */
+    while (set->index_heads[slot] != MO_INDEX_NONE)
+    {
+        if (set->index_hashes[slot] == hash)
+        {
+            const mo_domain_record_t* record = &set->records[set->index_heads[slot]];
+            if (mo_entry_matches(set->catalogs[record->catalog].entries, record->entry, key))
+            {
+                return slot;
+            }
+        }
+        slot = (slot + 1) & set->index_mask;
+    }
+    
+    return slot;
+}
+
+/**
+ * @brief 将一个目录的全部条目加入合并索引
+ *
+ * @note 调用顺序为文本域加入顺序、回退链从具体到一般，因此某文本域已有记录的键
+ *       说明更具体的语言已提供翻译，直接跳过；新记录追加在链尾以保持文本域顺序。
+ */
+static void mo_domain_insert_catalog(mo_domain_set_t* set, uint32_t catalog)
+{
+    const mo_context_t* ctx = set->catalogs[catalog].entries;
+    uint32_t domain = set->catalogs[catalog].domain;
+    
+    for (uint32_t i = 0; i < ctx->num_strings; i++)
+    {
+        uint32_t len;
+        mo_lookup_key_t key = { mo_entry_key(ctx, i, &len), 0, NULL, 0 };
+        uint32_t hash;
+        uint32_t slot;
+        uint32_t last = MO_INDEX_NONE;
+        bool present = false;
+    
+        /* 头部条目不参与查找 */
+        if (len == 0)
+        {
+            continue;
+        }
+    
+        key.len = len;
+        hash = mo_hash_bytes(key.str, len);
+        slot = mo_domain_probe(set, &key, hash);
+    
+        for (uint32_t r = set->index_heads[slot]; r != MO_INDEX_NONE; r = set->records[r].next)
+        {
+            if (set->catalogs[set->records[r].catalog].domain == domain)
+            {
+                present = true;
+                break;
+            }
+            last = r;
+        }
+        if (present)
+        {
+            continue;
+        }
+    
+        mo_domain_record_t* record = &set->records[set->num_records];
+        record->catalog = catalog;
+        record->entry = i;
+        record->next = MO_INDEX_NONE;
+    
+        if (last == MO_INDEX_NONE)
+        {
+            set->index_hashes[slot] = hash;
+            set->index_heads[slot] = set->num_records;
+        }
+        else
+        {
+            set->records[last].next = set->num_records;
+        }
+        set->num_records++;
+    }
+}
+
+/**
+ * @brief 释放合并索引
+ */
+static void mo_domain_release_index(mo_domain_set_t* set)
+{
+    free(set->records);
+    free(set->index_hashes);
+    free(set->index_heads);
+    set->records = NULL;
+    set->index_hashes = NULL;
+    set->index_heads = NULL;
+    set->num_records = 0;
+    set->index_mask = 0;
+}
+
+/**
+ * @brief 按当前回退链重建合并索引
+ */
+static mo_error_t mo_domain_build_index(mo_domain_set_t* set)
+{
+    uint64_t total = 0;
+    uint32_t size = 16;
+    uint32_t d, k, c;
+    
+    mo_domain_release_index(set);
+    
+    /* 统计回退链中各语言目录的条目总数 */
+    for (c = 0; c < set->num_catalogs; c++)
+    {
+        for (k = 0; k < set->chain_len; k++)
+        {
+            if (strcmp(set->catalogs[c].locale, set->chain[k]) == 0)
+            {
+                total += set->catalogs[c].entries->num_strings;
+                break;
+            }
+        }
+    }
+    if (total == 0)
+    {
+        return MO_SUCCESS;
+    }
+    if (total > UINT32_MAX / 4)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    
+    while (size < total * 2)
+    {
+        size <<= 1;
+    }
+    
+    set->records = (mo_domain_record_t*)malloc((size_t)total * sizeof(mo_domain_record_t));
+    set->index_hashes = (uint32_t*)malloc((size_t)size * sizeof(uint32_t));
+    set->index_heads = (uint32_t*)malloc((size_t)size * sizeof(uint32_t));
+    if (!set->records || !set->index_hashes || !set->index_heads)
+    {
+        mo_domain_release_index(set);
+        return MO_ERROR_MEMORY;
+    }
+    memset(set->index_heads, 0xFF, (size_t)size * sizeof(uint32_t));
+    set->index_mask = size - 1;
+    
+    for (d = 0; d < set->num_domains; d++)
+    {
+        for (k = 0; k < set->chain_len; k++)
+        {
+            for (c = 0; c < set->num_catalogs; c++)
+            {
+                if (set->catalogs[c].domain == d &&
+                    strcmp(set->catalogs[c].locale, set->chain[k]) == 0)
+                {
+                    mo_domain_insert_catalog(set, c);
+                }
+            }
+        }
+    }
+    
+    mo_log(NULL, "Domain index built: %u domains, %u records, %u slots",
+           set->num_domains, set->num_records, size);
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 在合并索引中查找键，domain为NULL时返回优先级最高的文本域中的记录
+ */
+static const mo_domain_record_t* mo_domain_lookup(const mo_domain_set_t* set,
+                                                  const char* domain,
+                                                  const mo_lookup_key_t* key)
+{
+    uint32_t domain_index = MO_INDEX_NONE;
+    
+    if (!set->index_heads)
+    {
+        return NULL;
+    }
+    
+    if (domain)
+    {
+        domain_index = mo_domain_find(set, domain);
+        if (domain_index == MO_INDEX_NONE)
+        {
+            return NULL;
+        }
+    }
+    
+    uint32_t slot = mo_domain_probe(set, key, mo_hash_key(key));
+    for (uint32_t r = set->index_heads[slot]; r != MO_INDEX_NONE; r = set->records[r].next)
+    {
+        if (domain_index == MO_INDEX_NONE ||
+            set->catalogs[set->records[r].catalog].domain == domain_index)
+        {
+            return &set->records[r];
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief 创建空的目录集合
+ */
+mo_error_t mo_domain_set_create(mo_domain_set_t** set)
+{
+    if (!set)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    *set = (mo_domain_set_t*)calloc(1, sizeof(mo_domain_set_t));
+    return *set ? MO_SUCCESS : MO_ERROR_MEMORY;
+}
+
+/**
+ * @brief 释放目录集合及其中的所有目录
+ */
+void mo_domain_set_free(mo_domain_set_t* set)
+{
+    if (!set)
+    {
+        return;
+    }
+    
+    mo_domain_release_index(set);
+    for (uint32_t c = 0; c < set->num_catalogs; c++)
+    {
+        mo_context_free(set->catalogs[c].context);
+    }
+    free(set->catalogs);
+    free(set->domains);
+    free(set);
+}
+
+/**
+ * @brief 向集合加入一个目录
+ */
+mo_error_t mo_domain_set_add(mo_domain_set_t* set, const char* domain,
+                             const char* locale, mo_context_t* context)
+{
+    mo_domain_catalog_t catalog;
+    char name[MO_DOMAIN_MAX_NAME];
+    bool new_domain = false;
+    mo_error_t result;
+    
+    /* 合并索引直接读取目录的字符串表，分页读取的目录不能加入 */
+    if (!set || !context || context->paged ||
+        !mo_domain_copy_name(name, domain) ||
+        !mo_domain_copy_name(catalog.locale, locale))
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    /* 加入前重载过的上下文，句柄自身的字符串表已经释放，索引引用当前目录 */
+    mo_read_begin();
+    catalog.entries = mo_context_current(context);
+    mo_read_end();
+    
+    catalog.context = context;
+    catalog.domain = mo_domain_find(set, name);
+    if (catalog.domain == MO_INDEX_NONE)
+    {
+        char (*domains)[MO_DOMAIN_MAX_NAME] = realloc(set->domains,
+            (set->num_domains + 1) * sizeof(set->domains[0]));
+        if (!domains)
+        {
+            return MO_ERROR_MEMORY;
+        }
+        set->domains = domains;
+        memcpy(set->domains[set->num_domains], name, sizeof(name));
+        catalog.domain = set->num_domains++;
+        new_domain = true;
+    }
+    
+    mo_domain_catalog_t* catalogs = (mo_domain_catalog_t*)realloc(set->catalogs,
+        (set->num_catalogs + 1) * sizeof(mo_domain_catalog_t));
+    if (!catalogs)
+    {
+        result = MO_ERROR_MEMORY;
+        goto cleanup;
+    }
+    set->catalogs = catalogs;
+    set->catalogs[set->num_catalogs++] = catalog;
+    
+    if (!set->has_locale)
+    {
+        return MO_SUCCESS;
+    }
+    
+    result = mo_domain_build_index(set);
+    if (result != MO_SUCCESS)
+    {
+        /* 撤销加入，上下文仍归调用者所有，并尽量恢复原来的索引 */
+        set->num_catalogs--;
+        mo_domain_build_index(set);
+    }
+    
+cleanup:
+    /* 失败时同时移除本次追加的文本域名称，不指定文本域的查找顺序保持不变 */
+    if (result != MO_SUCCESS && new_domain)
+    {
+        set->num_domains--;
+    }
+    return result;
+}
+
+/**
+ * @brief 从文件加载目录并加入集合
+ */
+mo_error_t mo_domain_set_add_file(mo_domain_set_t* set, const char* domain,
+                                  const char* locale, const char* filename,
+                                  const mo_options_t* options)
+{
+    mo_context_t* context = NULL;
+    mo_error_t result;
+    
+    if (!set || !filename)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    result = mo_context_create_ex(filename, options, &context);
+    if (result != MO_SUCCESS)
+    {
+        return result;
+    }
+    
+    result = mo_domain_set_add(set, domain, locale, context);
+    if (result != MO_SUCCESS)
+    {
+        mo_context_free(context);
+    }
+    return result;
+}
+
+/**
+ * @brief 设置当前语言并重建合并索引
+ */
+mo_error_t mo_domain_set_set_locale(mo_domain_set_t* set, const char* locale)
+{
+    if (!set || (locale && strlen(locale) >= MO_DOMAIN_MAX_NAME))
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    mo_domain_build_chain(set, locale);
+    set->has_locale = true;
+    return mo_domain_build_index(set);
+}
+
+/**
+ * @brief 在集合中翻译字符串
+ */
+const char* mo_domain_translate(const mo_domain_set_t* set, const char* domain,
+                                const char* original)
+{
+    const mo_domain_record_t* record;
+    uint32_t len;
+    
+    if (!set || !original)
+    {
+        return original;
+    }
+    
+    mo_lookup_key_t key = { original, strlen(original), NULL, 0 };
+    record = mo_domain_lookup(set, domain, &key);
+    if (!record)
+    {
+        return original;
+    }
+    
+    return mo_entry_translation(set->catalogs[record->catalog].entries, record->entry, &len);
+}
+
+/**
+ * @brief 在集合中翻译字符串（带上下文和复数形式）
+ */
+const char* mo_domain_translate_cp(const mo_domain_set_t* set, const char* domain,
+                                   const char* context_str, const char* singular,
+                                   const char* plural, unsigned long n)
+{
+    const mo_domain_record_t* record = NULL;
+    mo_lookup_key_t key;
+    
+    if (!set || !singular)
+    {
+        return singular;
+    }
+    
+    /* 上下文与msgid分段查找，规则与mo_translate_cp相同 */
+    key.str = singular;
+    key.len = strlen(singular);
+    key.context = context_str;
+    key.context_len = context_str ? strlen(context_str) : 0;
+    
+    record = mo_domain_lookup(set, domain, &key);
+    if (!record && context_str)
+    {
+        key.context = NULL;
+        key.context_len = 0;
+        record = mo_domain_lookup(set, domain, &key);
+    }
+    
+    if (!record)
+    {
+        /* 未翻译时按英语规则返回原文 */
+        return (plural && n != 1) ? plural : singular;
+    }
+    
+    const mo_context_t* ctx = set->catalogs[record->catalog].entries;
+    if (!plural)
+    {
+        uint32_t len;
+        return mo_entry_translation(ctx, record->entry, &len);
+    }
+    
+    return mo_select_plural(ctx, record->entry, n);
+}
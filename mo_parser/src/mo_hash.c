@@ -0,0 +1,294 @@
+/**
+ * @file mo_hash.c
+ * @brief 字符串哈希函数 - 按64位字读取，乘法折叠混合
+ *
+ * 每次处理8字节，使用64x64->128位乘法后高低位异或的方式混合（与wyhash同类），
+ * 对共享前缀的键也有良好的分布。mo_hash_cstr在计算哈希的同时求出字符串长度，
+ * 调用者无需再单独调用strlen。
+ */
+
+#include "mo_internal.h"
+#include <string.h>
+
+#define MO_HASH_SEED 0xa0761d6478bd642fULL
+#define MO_HASH_P1 0xe7037ed1a0b428dbULL
+#define MO_HASH_P2 0x8ebc6af09c88c6e3ULL
+
+/* 哈希值按小端读取定义，大端主机读取8字节块后须交换字节序 */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && \
+    (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+#define MO_HASH_BIG_ENDIAN 1
+#endif
+
+/* 按字扫描要求小端主机，其他平台退化为逐字节求长度 */
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && \
+    (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define MO_HASH_WORD_SCAN 1
+#endif
+
+/* 按对齐字读取时可能越过字符串结尾（但不会越过所在的页），需要关闭地址检查 */
+#if defined(__clang__) || defined(__GNUC__)
+#define MO_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#define MO_NO_SANITIZE_ADDRESS
+#endif
+
+#define MO_ONES 0x0101010101010101ULL
+#define MO_HIGHS 0x8080808080808080ULL
+
+/**
+ * @brief 乘法折叠：计算a*b的128位结果并将高低64位异或
+ */
+static inline uint64_t mo_hash_mum(uint64_t a, uint64_t b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    uint64_t ha = a >> 32, la = (uint32_t)a;
+    uint64_t hb = b >> 32, lb = (uint32_t)b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    return lo ^ hi;
+#endif
+}
+
+/**
+ * @brief 按小端顺序读取8字节（不要求对齐）
+ * @note 哈希值写入MPH段和生成的C表，在任何主机上都必须相同。同样关闭地址检查，
+ *       未内联时（如-O0）按字扫描的越界读取也不会被误报。
+ */
+MO_NO_SANITIZE_ADDRESS
+static inline uint64_t mo_hash_load64(const void* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+#ifdef MO_HASH_BIG_ENDIAN
+    v = __builtin_bswap64(v);
+#endif
+    return v;
+}
+
+/**
+ * @brief 混合一个完整的8字节块
+ */
+static inline uint64_t mo_hash_round(uint64_t h, uint64_t chunk)
+{
+    return mo_hash_mum(h ^ chunk, MO_HASH_P1);
+}
+
+/**
+ * @brief 混合末尾不足8字节的部分及总长度，得到最终哈希值
+ */
+static inline uint32_t mo_hash_final(uint64_t h, uint64_t tail, size_t len)
+{
+    h = mo_hash_mum(h ^ tail, MO_HASH_P2 ^ (uint64_t)len);
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+/**
+ * @brief 计算指定长度字符串的哈希值
+ */
+uint32_t mo_hash_bytes(const char* str, size_t len)
+{
+    const uint8_t* p = (const uint8_t*)str;
+    uint64_t h = MO_HASH_SEED;
+    uint64_t tail = 0;
+    size_t remain = len;
+
+    while (remain >= 8)
+    {
+        h = mo_hash_round(h, mo_hash_load64(p));
+        p += 8;
+        remain -= 8;
+    }
+
+    /* 末尾字节同样按小端顺序组装 */
+    for (size_t i = 0; i < remain; i++)
+    {
+        tail |= (uint64_t)p[i] << (8 * i);
+    }
+
+    return mo_hash_final(h, tail, len);
+}
+
+/**
+ * @brief 开始逐段计算哈希值
+ */
+void mo_hash_stream_init(mo_hash_stream_t* stream)
+{
+    stream->h = MO_HASH_SEED;
+    stream->pending = 0;
+    stream->len = 0;
+}
+
+/**
+ * @brief 追加一段字节，跨段的8字节块在block中拼接
+ */
+void mo_hash_stream_feed(mo_hash_stream_t* stream, const char* str, size_t len)
+{
+    const uint8_t* p = (const uint8_t*)str;
+
+    stream->len += len;
+    if (stream->pending > 0)
+    {
+        size_t take = 8 - stream->pending;
+        if (take > len)
+        {
+            take = len;
+        }
+        memcpy(stream->block + stream->pending, p, take);
+        stream->pending += take;
+        p += take;
+        len -= take;
+        if (stream->pending < 8)
+        {
+            return;
+        }
+        stream->h = mo_hash_round(stream->h, mo_hash_load64(stream->block));
+        stream->pending = 0;
+    }
+
+    while (len >= 8)
+    {
+        stream->h = mo_hash_round(stream->h, mo_hash_load64(p));
+        p += 8;
+        len -= 8;
+    }
+
+    memcpy(stream->block, p, len);
+    stream->pending = len;
+}
+
+/**
+ * @brief 结束逐段计算，混合block中剩余的字节和总长度
+ */
+uint32_t mo_hash_stream_final(const mo_hash_stream_t* stream)
+{
+    uint64_t tail = 0;
+
+    for (size_t i = 0; i < stream->pending; i++)
+    {
+        tail |= (uint64_t)stream->block[i] << (8 * i);
+    }
+
+    return mo_hash_final(stream->h, tail, stream->len);
+}
+
+/**
+ * @brief 逐段计算查找键的哈希值
+ */
+uint32_t mo_hash_key(const mo_lookup_key_t* key)
+{
+    static const char separator = MO_CONTEXT_SEPARATOR;
+    mo_hash_stream_t stream;
+
+    if (!key->context)
+    {
+        return mo_hash_bytes(key->str, key->len);
+    }
+
+    mo_hash_stream_init(&stream);
+    mo_hash_stream_feed(&stream, key->context, key->context_len);
+    mo_hash_stream_feed(&stream, &separator, 1);
+    mo_hash_stream_feed(&stream, key->str, key->len);
+    return mo_hash_stream_final(&stream);
+}
+
+#ifdef MO_HASH_WORD_SCAN
+/**
+ * @brief 返回字中第一个0字节的位置（8表示没有）
+ */
+static inline unsigned mo_hash_first_zero(uint64_t v)
+{
+    uint64_t z = (v - MO_ONES) & ~v & MO_HIGHS;
+    return z ? (unsigned)(__builtin_ctzll(z) >> 3) : 8;
+}
+
+/**
+ * @brief 取低n个字节（n为0..7）
+ */
+static inline uint64_t mo_hash_low_bytes(uint64_t v, unsigned n)
+{
+    return n ? v & (~0ULL >> (64 - 8 * n)) : 0;
+}
+#endif
+
+/**
+ * @brief 计算以NUL结尾的字符串的哈希值，同时求出长度
+ *
+ * @note 结果与mo_hash_bytes(str, strlen(str))相同。小端主机上按对齐的8字节字
+ *       读取，在同一次遍历中检测结尾并拼接出与mo_hash_bytes相同的8字节块。
+ */
+MO_NO_SANITIZE_ADDRESS
+uint32_t mo_hash_cstr(const char* str, size_t* len)
+{
+#ifdef MO_HASH_WORD_SCAN
+    unsigned off = (unsigned)((uintptr_t)str & 7);
+    const uint8_t* w = (const uint8_t*)str - off;
+    uint64_t h = MO_HASH_SEED;
+    size_t total = 0;
+    unsigned k;
+
+    if (off == 0)
+    {
+        for (;;)
+        {
+            uint64_t cur = mo_hash_load64(w);
+            w += 8;
+            k = mo_hash_first_zero(cur);
+            if (k < 8)
+            {
+                *len = total + k;
+                return mo_hash_final(h, mo_hash_low_bytes(cur, k), *len);
+            }
+            h = mo_hash_round(h, cur);
+            total += 8;
+        }
+    }
+
+    /* 非对齐起点：每个块由上一字的高npend字节和下一字的低(8-npend)字节拼成 */
+    unsigned npend = 8 - off;
+    uint64_t pending = mo_hash_load64(w) >> (8 * off);
+    w += 8;
+
+    /* pending中超出npend的高位字节为0，检测时填充为非0 */
+    k = mo_hash_first_zero(pending | (~0ULL << (8 * npend)));
+    if (k < npend)
+    {
+        *len = k;
+        return mo_hash_final(h, mo_hash_low_bytes(pending, k), k);
+    }
+
+    for (;;)
+    {
+        uint64_t next = mo_hash_load64(w);
+        w += 8;
+
+        k = mo_hash_first_zero(next);
+        if (k < off)
+        {
+            *len = total + npend + k;
+            return mo_hash_final(h, pending | (mo_hash_low_bytes(next, k) << (8 * npend)), *len);
+        }
+
+        h = mo_hash_round(h, pending | (next << (8 * npend)));
+        total += 8;
+        pending = next >> (8 * off);
+
+        k = mo_hash_first_zero(pending | (~0ULL << (8 * npend)));
+        if (k < npend)
+        {
+            *len = total + k;
+            return mo_hash_final(h, mo_hash_low_bytes(pending, k), *len);
+        }
+    }
+#else
+    *len = strlen(str);
+    return mo_hash_bytes(str, *len);
+#endif
+}
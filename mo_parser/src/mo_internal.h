@@ -0,0 +1,696 @@
+/**
+ * @file mo_internal.h
+ * @brief MO文件解析器内部定义 - 上下文结构与查找策略接口
+ *
+ * 仅供库内部各源文件共享，不对外安装。
+ */
+
+#ifndef MO_INTERNAL_H
+#define MO_INTERNAL_H
+
+#include "mo_parser.h"
+#include <stdatomic.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 内部常量定义 */
+#define MO_MAGIC 0x950412de
+#define MO_MAGIC_REV 0xde120495
+#define MO_CONTEXT_SEPARATOR '\004'  /**< msgctxt与msgid之间的分隔符 */
+#define MO_CACHE_SIZE 64
+#define MO_INDEX_NONE 0xFFFFFFFF    /**< 查找失败时返回的索引 */
+
+/* Plural-Forms字节码限制（表达式在加载时编译，求值时不分配内存） */
+#define MO_PLURAL_MAX_CODE 128
+#define MO_PLURAL_MAX_STACK 16
+
+/* Plural-Forms字节码指令 */
+typedef struct {
+    uint8_t op;
+    uint32_t arg;
+} mo_plural_op_t;
+
+/* 编译后的Plural-Forms表达式 */
+typedef struct {
+    mo_plural_op_t code[MO_PLURAL_MAX_CODE];
+    uint32_t code_len;          /**< 指令数量，0表示使用默认规则(n != 1) */
+    uint32_t nplurals;          /**< 翻译形式数量 */
+} mo_plural_expr_t;
+
+/* 头部条目的解析结果，各字段值的副本紧随其后存放 */
+typedef struct {
+    mo_metadata_t metadata;
+    mo_plural_expr_t plural;
+} mo_header_block_t;
+
+/**
+ * @brief 缓存项结构
+ * 
+ * 以顺序锁（seqlock）保护：写入者将seq置为奇数后写入各字段，完成后再置为偶数；
+ * 读取者在seq为奇数或前后两次读取不一致时视为未命中。读写双方都不会阻塞。
+ */
+typedef struct {
+    atomic_uint seq;                      /**< 版本号，奇数表示正在写入 */
+    _Atomic(const char*) original;
+    _Atomic(const char*) translation;
+    atomic_uint hash;                     /**< 哈希值缓存（仅带哈希函数的查找策略） */
+} mo_cache_item_t;
+
+/**
+ * @brief 内部性能统计结构，字段与mo_stats_t一一对应
+ * @note 使用relaxed原子操作累加，多线程并发查找时计数不丢失，也不引入同步开销。
+ */
+typedef struct {
+    atomic_uint total_lookups;
+    atomic_uint cache_hits;
+    atomic_uint cache_misses;
+    atomic_uint hash_collisions;
+    atomic_uint comparisons;
+    atomic_uint page_hits;
+    atomic_uint page_misses;
+    atomic_uint lookup_misses;
+    atomic_uint bloom_rejects;
+} mo_stats_counter_t;
+
+/* 统计计数（未启用MO_ENABLE_STATS时为空操作） */
+#ifdef MO_ENABLE_STATS
+#define MO_STAT_INC(ctx, field) \
+    atomic_fetch_add_explicit(&((mo_context_t*)(ctx))->stats.field, 1u, memory_order_relaxed)
+#else
+#define MO_STAT_INC(ctx, field) ((void)0)
+#endif
+
+/* 软件预取（只读，尽量保留在各级缓存中） */
+#if defined(__GNUC__) || defined(__clang__)
+#define MO_PREFETCH(addr) __builtin_prefetch((addr), 0, 3)
+#else
+#define MO_PREFETCH(addr) ((void)(addr))
+#endif
+
+/*
+ * 对公共头文件中普通类型的字段做原子访问（公共头文件不依赖stdatomic.h，字段不是
+ * _Atomic类型，不能转换成_Atomic指针访问）。order为RELAXED、ACQUIRE或RELEASE；
+ * MSVC的Interlocked函数都是完整屏障，忽略order。64位字段须按8字节对齐（MO_ALIGNAS）。
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define MO_ATOMIC_LOAD_U32(p, order)     __atomic_load_n((p), __ATOMIC_##order)
+#define MO_ATOMIC_STORE_U32(p, v, order) __atomic_store_n((p), (v), __ATOMIC_##order)
+#define MO_ATOMIC_CAS_U32(p, expected, desired) \
+    __atomic_compare_exchange_n((p), (expected), (desired), false, \
+                                __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#define MO_ATOMIC_LOAD_U64(p, order)     __atomic_load_n((p), __ATOMIC_##order)
+#define MO_ATOMIC_STORE_U64(p, v, order) __atomic_store_n((p), (v), __ATOMIC_##order)
+#define MO_ATOMIC_LOAD_PTR(p, order)     __atomic_load_n((p), __ATOMIC_##order)
+#define MO_ATOMIC_STORE_PTR(p, v, order) __atomic_store_n((p), (v), __ATOMIC_##order)
+#elif defined(_MSC_VER)
+#include <intrin.h>
+#define MO_ATOMIC_LOAD_U32(p, order) \
+    ((uint32_t)_InterlockedOr((volatile long*)(p), 0))
+#define MO_ATOMIC_STORE_U32(p, v, order) \
+    ((void)_InterlockedExchange((volatile long*)(p), (long)(v)))
+#define MO_ATOMIC_CAS_U32(p, expected, desired) \
+    mo_atomic_cas_u32_msvc((volatile long*)(p), (uint32_t*)(expected), (desired))
+#define MO_ATOMIC_LOAD_U64(p, order) \
+    ((uint64_t)_InterlockedCompareExchange64((volatile __int64*)(p), 0, 0))
+#define MO_ATOMIC_STORE_U64(p, v, order) \
+    ((void)_InterlockedExchange64((volatile __int64*)(p), (__int64)(v)))
+#define MO_ATOMIC_LOAD_PTR(p, order) \
+    _InterlockedCompareExchangePointer((void* volatile*)(p), NULL, NULL)
+#define MO_ATOMIC_STORE_PTR(p, v, order) \
+    ((void)_InterlockedExchangePointer((void* volatile*)(p), (void*)(v)))
+
+static inline bool mo_atomic_cas_u32_msvc(volatile long* p, uint32_t* expected, uint32_t desired)
+{
+    uint32_t old = (uint32_t)_InterlockedCompareExchange(p, (long)desired, (long)*expected);
+    if (old == *expected)
+    {
+        return true;
+    }
+    *expected = old;
+    return false;
+}
+#endif
+
+/* 批量查找的预取阶段数：每个阶段读取上一阶段预取的数据，并预取下一层依赖的地址 */
+#define MO_PREFETCH_STAGES 4
+
+/* 并行建立索引时最多分成的份数 */
+#define MO_PARALLEL_MAX_PARTS 64
+
+/* 批量查找时每组同时在途的键数量 */
+#define MO_BATCH_GROUP 16
+
+/* 分块Bloom过滤器：每块8个64位字（一条缓存行），每个键在每个字中置1位 */
+#define MO_BLOOM_WORDS 8
+#define MO_BLOOM_BITS_PER_KEY 16
+
+/* 哈希表控制字节：空槽位为0x80，已占用槽位为哈希值低7位 */
+#define MO_HASH_CTRL_EMPTY 0x80
+#define MO_HASH_GROUP_WIDTH 16      /**< 每组槽位数，一次SIMD比较覆盖一组 */
+
+/**
+ * @brief 查找键：逻辑上等于"msgctxt\004msgid"
+ *
+ * 带上下文的键由两段给出，哈希和比较都逐段进行，查找时不需要拼接缓冲区。
+ */
+typedef struct {
+    const char* str;            /**< msgid（无上下文时即完整的键） */
+    size_t len;                 /**< msgid长度 */
+    const char* context;        /**< msgctxt，NULL表示无上下文 */
+    size_t context_len;         /**< msgctxt长度 */
+} mo_lookup_key_t;
+
+/**
+ * @brief 查找策略接口
+ *
+ * 每个上下文在创建时选定一个策略，之后所有查找都经由该接口完成。
+ */
+typedef struct {
+    mo_search_method_t method;  /**< 策略枚举值 */
+    const char* name;           /**< 策略名称，用于mo_get_search_method */
+
+    /**
+     * @brief 建立索引（字符串表已校验）
+     * @note 策略可以在此将ctx->search替换为其他策略（如内嵌哈希表缺失时的回退）。
+     */
+    mo_error_t (*build)(mo_context_t* ctx);
+
+    /** @brief 计算查找键的哈希值，NULL表示该策略不使用哈希 */
+    uint32_t (*hash)(const char* str, size_t len);
+
+    /** @brief 计算以NUL结尾的键的哈希值并同时求出长度，与hash同时为NULL或非NULL */
+    uint32_t (*hash_cstr)(const char* str, size_t* len);
+
+    /** @brief 计算带上下文的查找键的哈希值，结果与对拼接后的键调用hash相同 */
+    uint32_t (*hash_key)(const mo_lookup_key_t* key);
+
+    /** @brief 查找键，返回条目序号，未找到返回MO_INDEX_NONE */
+    uint32_t (*find)(const mo_context_t* ctx, const mo_lookup_key_t* key, uint32_t hash);
+
+    /** @brief 释放build分配的资源，可为NULL */
+    void (*release)(mo_context_t* ctx);
+
+    /**
+     * @brief 预取哈希值对应的索引数据和键字节，可为NULL
+     * @param stage 0：预取探测起始槽位；之后每个阶段读取上一阶段预取的数据，预取下一层
+     *              （槽位指向的字符串表项、表项指向的键字节），最后一层之后的阶段不做任何事。
+     *              阶段数不超过MO_PREFETCH_STAGES。
+     */
+    void (*prefetch)(const mo_context_t* ctx, uint32_t hash, int stage);
+
+    /** @brief 返回build在堆上分配的索引字节数，NULL表示不占用堆内存 */
+    size_t (*memory)(const mo_context_t* ctx);
+
+    /**
+     * @brief 按键的字节序枚举以prefix开头的条目，NULL表示索引无序（按文件顺序扫描）
+     * @return 调用回调的次数
+     */
+    size_t (*foreach_prefix)(const mo_context_t* ctx, const char* prefix, size_t prefix_len,
+                             mo_entry_callback_t callback, void* user_data);
+} mo_search_ops_t;
+
+/**
+ * @brief Eytzinger有序索引的节点，每条缓存行4个
+ *
+ * 比较时先比较键前缀，前缀不同（或键不超过8字节）时无需读取字符串表和字符串本身。
+ */
+typedef struct {
+    uint64_t prefix;            /**< 键的前8字节按大端拼成的整数，不足8字节补0 */
+    uint32_t len;               /**< 键长度 */
+    uint32_t index;             /**< 条目序号 */
+} mo_eytzinger_node_t;
+
+/* 后台建立索引的线程 */
+typedef struct mo_lazy mo_lazy_t;
+
+/* 分页读取的状态：页缓存、常驻索引和结果缓冲区 */
+typedef struct mo_paged mo_paged_t;
+
+/* MO文件上下文结构 */
+struct mo_context {
+    const uint8_t* data;        /**< MO文件数据指针（只读） */
+    size_t size;                /**< 数据大小 */
+    bool is_mapped;             /**< 是否为内存映射模式 */
+    bool is_static;             /**< 由mo_gen_c生成的静态上下文，所有数据都是常量 */
+    bool need_swap;             /**< 文件字节序是否与主机相反 */
+
+    mo_header_t header;         /**< 已转换为主机字节序的文件头部副本 */
+    const mo_string_entry_t* orig_table;  /**< 原始字符串表，条目序号即表中下标 */
+    const mo_string_entry_t* trans_table; /**< 翻译字符串表，偏移相对于trans_data */
+    const uint8_t* trans_data;  /**< 翻译字符串所在的数据，通常即data，转换编码后为trans_arena */
+    uint32_t num_strings;       /**< 字符串数量 */
+
+    /* 复数形式与头部元数据（静态目录中指向常量，其余上下文指向metadata_block或默认值） */
+    const mo_plural_expr_t* plural; /**< 头部Plural-Forms编译结果 */
+    uint32_t header_index;      /**< 头部条目（空msgid）的序号，不参与查找；没有时为MO_INDEX_NONE */
+    const mo_metadata_t* metadata; /**< 加载时解析的头部字段，缺失的字段为空字符串 */
+    mo_header_block_t* metadata_block; /**< 解析结果和各字段值的副本所在的堆内存，与句柄共用或没有头部时为NULL */
+    size_t metadata_size;       /**< metadata_block的字节数 */
+
+    /* 转换为UTF-8的翻译（仅非UTF-8目录），前部为翻译字符串表 */
+    uint8_t* trans_arena;       /**< 与句柄共用或未转换时为NULL */
+    size_t trans_arena_size;    /**< trans_arena的字节数 */
+
+    const mo_search_ops_t* search; /**< 本上下文使用的查找策略 */
+
+    /* 哈希表相关（仅哈希表策略） */
+    uint8_t* hash_ctrl;           /**< 控制字节数组，每槽1字节，按16字节分组 */
+    uint32_t* hash_slots;         /**< 各槽位对应的条目序号 */
+    uint32_t hash_table_size;     /**< 槽位总数（16的倍数且为2的幂次） */
+    uint32_t hash_group_mask;     /**< 组掩码（组数-1） */
+    uint32_t hash_table_count;    /**< 哈希表中已存储的项数 */
+
+    /* 排序索引（仅二分查找策略） */
+    uint32_t* sorted_index;       /**< 按原文字节序排列的条目序号 */
+
+    /* Eytzinger有序索引（仅EYTZINGER策略） */
+    const mo_eytzinger_node_t* eytzinger_nodes; /**< 下标从1开始按层序排列，数组按缓存行对齐 */
+    void* eytzinger_block;        /**< 节点数组所在的堆内存块（对齐前的地址） */
+
+    /* MO文件内嵌的gettext哈希表（仅内嵌哈希表策略） */
+    const uint32_t* file_hash_table; /**< 文件中的哈希表，NULL表示不可用 */
+    uint32_t file_hash_size;         /**< 文件哈希表大小 */
+
+    /* 离线构建的最小完美哈希（仅MPH策略，数组直接指向文件数据） */
+    const uint32_t* mph_index;    /**< 槽位对应的字符串序号，共mph_keys项 */
+    const uint32_t* mph_remap;    /**< 超出mph_keys的槽位重定向到的空闲槽位 */
+    const uint32_t* mph_overflow; /**< 哈希值与其他键相同、需逐个比较的字符串序号 */
+    const uint16_t* mph_pilots;   /**< 各桶的位移参数 */
+    uint32_t mph_keys;            /**< 完美哈希覆盖的键数量 */
+    uint32_t mph_overflow_count;  /**< 溢出表项数 */
+    uint32_t mph_buckets;         /**< 桶数量 */
+    uint32_t mph_slots;           /**< 位移后的槽位范围（略大于mph_keys） */
+    uint64_t mph_seed;            /**< 构建时选定的哈希种子 */
+
+    /* 未命中过滤（可选，与查找策略无关） */
+    const uint64_t* bloom;        /**< 分块Bloom过滤器，按缓存行对齐，NULL表示未启用 */
+    void* bloom_block;            /**< 过滤器所在的堆内存块（对齐前的地址），与句柄共用时为NULL */
+    uint32_t bloom_blocks;        /**< 块数 */
+
+    /* 分页读取（仅PAGED策略，此时data、orig_table和trans_table均为NULL） */
+    mo_paged_t* paged;            /**< 字符串经读取回调按需载入，查找时会修改其中的页缓存 */
+
+    /* 缓存机制（查找路径中唯一可写的状态，无锁并发访问） */
+    mo_cache_item_t cache[MO_CACHE_SIZE];
+
+    bool logging_enabled;       /**< 日志开关 */
+
+    /* 热重载（仅由文件创建的上下文）与延迟建立的索引 */
+    _Atomic(mo_context_t*) current; /**< 重载或后台建立索引后生效的目录，NULL表示使用本结构中的数据 */
+    char* filename;             /**< 创建时的文件路径，重载时重新读取 */
+    bool from_po;               /**< filename是.po文件，加载和重载时先编译为MO数据 */
+    mo_options_t options;       /**< 创建选项，重载时沿用 */
+    _Atomic(mo_lazy_t*) lazy;   /**< 正在建立索引的后台线程，NULL表示没有 */
+    uint32_t build_threads;     /**< 建立索引时最多使用的线程数，0和1表示只用调用线程 */
+    bool shares_data;           /**< 目录数据属于句柄（后台建立的索引），释放时不解除映射 */
+
+    /* 翻译键绑定 */
+    _Atomic uint32_t generation; /**< 目录代号，首次使用时分配，0表示尚未分配；句柄上的值在重载后更新为当前目录的代号 */
+
+    /* 性能统计（可选） */
+    #ifdef MO_ENABLE_STATS
+    mo_stats_counter_t stats;
+    #endif
+};
+
+/* 内置查找策略 */
+extern const mo_search_ops_t mo_search_linear;
+extern const mo_search_ops_t mo_search_binary;
+extern const mo_search_ops_t mo_search_hash;
+extern const mo_search_ops_t mo_search_gettext;
+extern const mo_search_ops_t mo_search_mph;
+extern const mo_search_ops_t mo_search_eytzinger;
+extern const mo_search_ops_t mo_search_paged;
+
+/**
+ * @brief 交换32位整数字节序
+ */
+static inline uint32_t mo_swap_uint32(uint32_t val, bool swap)
+{
+    if (!swap)
+    {
+        return val;
+    }
+
+    return ((val >> 24) & 0x000000FF) |
+           ((val >> 8)  & 0x0000FF00) |
+           ((val << 8)  & 0x00FF0000) |
+           ((val << 24) & 0xFF000000);
+}
+
+/**
+ * @brief 交换16位整数字节序
+ */
+static inline uint16_t mo_swap_uint16(uint16_t val, bool swap)
+{
+    if (!swap)
+    {
+        return val;
+    }
+
+    return (uint16_t)((val >> 8) | (val << 8));
+}
+
+/**
+ * @brief 取得上下文当前生效的目录
+ *
+ * @note 必须在mo_read_begin/mo_read_end之间调用，返回的目录在离开读取区间前
+ *       不会被重载释放。
+ */
+static inline mo_context_t* mo_context_current(const mo_context_t* ctx)
+{
+    mo_context_t* current = atomic_load(&((mo_context_t*)ctx)->current);
+    return current ? current : (mo_context_t*)ctx;
+}
+
+/**
+ * @brief 等待宽限期：推进纪元并等待在此之前进入读取区间的读者全部离开
+ */
+void mo_rcu_synchronize(void);
+
+/**
+ * @brief 当前线程是否处于读取区间内
+ */
+bool mo_rcu_in_read(void);
+
+/**
+ * @brief 启动后台线程，为句柄的目录数据建立search策略的索引
+ * @return 无法创建线程时返回错误，调用者改为同步建立索引
+ */
+mo_error_t mo_lazy_start(mo_context_t* ctx, const mo_search_ops_t* search);
+
+/**
+ * @brief 等待后台建立索引的线程结束，没有线程时立即返回
+ */
+void mo_lazy_join(mo_context_t* ctx);
+
+/**
+ * @brief 为句柄的目录数据建立search策略的索引，完成后原子发布（在后台线程中调用）
+ */
+void mo_context_publish_index(mo_context_t* ctx, const mo_search_ops_t* search);
+
+/**
+ * @brief 并行任务，处理第part份（共parts份）
+ */
+typedef void (*mo_parallel_task_t)(void* arg, uint32_t part, uint32_t parts);
+
+/**
+ * @brief 按上下文的build_threads和条目数确定分成几份，条目较少时返回1
+ */
+uint32_t mo_parallel_parts(const mo_context_t* ctx, uint32_t count);
+
+/**
+ * @brief 把任务分成parts份并行执行，第0份在调用线程中执行，全部完成后返回
+ * @note 无法创建线程时，剩余的份在调用线程中依次执行，结果不变。
+ */
+void mo_parallel_run(uint32_t parts, mo_parallel_task_t task, void* arg);
+
+/**
+ * @brief 求出第part份负责的范围[begin, end)
+ */
+static inline void mo_parallel_range(uint32_t count, uint32_t part, uint32_t parts,
+                                     uint32_t* begin, uint32_t* end)
+{
+    *begin = (uint32_t)((uint64_t)count * part / parts);
+    *end = (uint32_t)((uint64_t)count * (part + 1) / parts);
+}
+
+/**
+ * @brief 文件是否带有可用的内嵌哈希表（GETTEXT策略无需建立索引）
+ */
+bool mo_gettext_usable(const mo_context_t* ctx);
+
+/**
+ * @brief 计算字符串的hashpjw哈希值（GNU gettext写入MO文件哈希表时使用的算法）
+ */
+uint32_t mo_hash_string_pjw(const char* str, size_t len);
+
+/**
+ * @brief 文件是否带有最小完美哈希段（MPH策略无需建立索引）
+ */
+bool mo_mph_usable(const mo_context_t* ctx);
+
+/**
+ * @brief 读取条目原文
+ *
+ * @note 条目直接引用文件中的字符串表（每项8字节，必要时转换字节序），上下文不再
+ *       为每个条目保存指针副本。复数条目的原文为"singular\0plural"，输出长度
+ *       包含两部分。
+ */
+static inline const char* mo_entry_original(const mo_context_t* ctx, uint32_t index,
+                                            uint32_t* len)
+{
+    const mo_string_entry_t* entry = &ctx->orig_table[index];
+    *len = mo_swap_uint32(entry->length, ctx->need_swap);
+    return (const char*)ctx->data + mo_swap_uint32(entry->offset, ctx->need_swap);
+}
+
+/**
+ * @brief 把分页读取的目录中条目的翻译复制到结果缓冲区
+ * @note 读取失败时返回""。
+ */
+const char* mo_paged_translation(const mo_context_t* ctx, uint32_t index, uint32_t* len);
+
+/**
+ * @brief 读取条目翻译，复数条目的长度包含以NUL分隔的全部msgstr[n]
+ */
+static inline const char* mo_entry_translation(const mo_context_t* ctx, uint32_t index,
+                                               uint32_t* len)
+{
+    if (ctx->paged)
+    {
+        return mo_paged_translation(ctx, index, len);
+    }
+
+    const mo_string_entry_t* entry = &ctx->trans_table[index];
+    *len = mo_swap_uint32(entry->length, ctx->need_swap);
+    return (const char*)ctx->trans_data + mo_swap_uint32(entry->offset, ctx->need_swap);
+}
+
+/**
+ * @brief 预取条目原文的首字节（字符串表项应已在缓存中）
+ */
+static inline void mo_entry_prefetch_key(const mo_context_t* ctx, uint32_t index)
+{
+    const mo_string_entry_t* entry = &ctx->orig_table[index];
+    MO_PREFETCH((const char*)ctx->data + mo_swap_uint32(entry->offset, ctx->need_swap));
+}
+
+/**
+ * @brief 读取条目的查找键（复数条目只取单数msgid部分）
+ */
+static inline const char* mo_entry_key(const mo_context_t* ctx, uint32_t index, uint32_t* len)
+{
+    const char* original = mo_entry_original(ctx, index, len);
+    const char* nul = (const char*)memchr(original, '\0', *len);
+    if (nul)
+    {
+        *len = (uint32_t)(nul - original);
+    }
+    return original;
+}
+
+/**
+ * @brief 判断条目的查找键是否等于str
+ *
+ * @note 查找键之后必然是NUL：非复数条目为字符串结尾，复数条目为单复数分隔符，
+ *       因此无需预先保存单数部分的长度。
+ */
+static inline bool mo_entry_equals(const mo_context_t* ctx, uint32_t index,
+                                   const char* str, size_t len)
+{
+    uint32_t orig_len;
+    const char* original = mo_entry_original(ctx, index, &orig_len);
+    return len <= orig_len && original[len] == '\0' && memcmp(original, str, len) == 0;
+}
+
+/**
+ * @brief 查找键是否为头部条目的键（不带上下文的空字符串）
+ *
+ * @note 头部条目不参与查找，各策略直接按未命中处理。
+ */
+static inline bool mo_key_is_header(const mo_lookup_key_t* key)
+{
+    return key->len == 0 && !key->context;
+}
+
+/**
+ * @brief 判断条目的查找键是否等于key
+ *
+ * @note 带上下文时依次比较msgctxt、分隔符和msgid，之后同样要求条目在该位置结束。
+ */
+static inline bool mo_entry_matches(const mo_context_t* ctx, uint32_t index,
+                                    const mo_lookup_key_t* key)
+{
+    uint32_t orig_len;
+    const char* original;
+    size_t total;
+
+    if (!key->context)
+    {
+        return mo_entry_equals(ctx, index, key->str, key->len);
+    }
+
+    original = mo_entry_original(ctx, index, &orig_len);
+    total = key->context_len + 1 + key->len;
+    return total <= orig_len && original[total] == '\0' &&
+           original[key->context_len] == MO_CONTEXT_SEPARATOR &&
+           memcmp(original, key->context, key->context_len) == 0 &&
+           memcmp(original + key->context_len + 1, key->str, key->len) == 0;
+}
+
+/**
+ * @brief 返回哈希值对应的Bloom过滤器块
+ */
+static inline const uint64_t* mo_bloom_block(const mo_context_t* ctx, uint32_t hash)
+{
+    return ctx->bloom + (size_t)(((uint64_t)hash * ctx->bloom_blocks) >> 32) * MO_BLOOM_WORDS;
+}
+
+/**
+ * @brief 键在块中第word个字里对应的位
+ *
+ * @note 块由哈希值的高位选择，块内各位由哈希值乘以不同的奇数常量后取高6位得到。
+ */
+static inline uint64_t mo_bloom_bit(uint32_t hash, uint32_t word)
+{
+    static const uint32_t salts[MO_BLOOM_WORDS] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+    };
+    return (uint64_t)1 << ((uint32_t)(hash * salts[word]) >> 26);
+}
+
+/**
+ * @brief 键是否可能在目录中（返回false时必然不在）
+ * @param hash 查找键的mo_hash_bytes哈希值
+ */
+static inline bool mo_bloom_may_contain(const mo_context_t* ctx, uint32_t hash)
+{
+    const uint64_t* block = mo_bloom_block(ctx, hash);
+    uint64_t missing = 0;
+
+    for (uint32_t i = 0; i < MO_BLOOM_WORDS; i++)
+    {
+        missing |= mo_bloom_bit(hash, i) & ~block[i];
+    }
+    return missing == 0;
+}
+
+/**
+ * @brief 为全部查找键（头部条目除外）建立Bloom过滤器
+ */
+mo_error_t mo_bloom_build(mo_context_t* ctx);
+
+/**
+ * @brief 释放Bloom过滤器（与句柄共用时只清除指针）
+ */
+void mo_bloom_release(mo_context_t* ctx);
+
+/**
+ * @brief 计算指定长度字符串的哈希值（按64位字混合）
+ */
+uint32_t mo_hash_bytes(const char* str, size_t len);
+
+/**
+ * @brief 计算以NUL结尾的字符串的哈希值并输出长度，结果与mo_hash_bytes一致
+ */
+uint32_t mo_hash_cstr(const char* str, size_t* len);
+
+/**
+ * @brief 逐段计算查找键的哈希值，结果与对拼接后的键调用mo_hash_bytes相同
+ */
+uint32_t mo_hash_key(const mo_lookup_key_t* key);
+
+/**
+ * @brief 逐段计算哈希值的中间状态
+ */
+typedef struct {
+    uint64_t h;                 /**< 已混合的完整块 */
+    uint8_t block[8];           /**< 尚未凑满8字节的部分 */
+    size_t pending;             /**< block中的字节数 */
+    size_t len;                 /**< 已追加的总字节数 */
+} mo_hash_stream_t;
+
+/**
+ * @brief 开始逐段计算哈希值
+ */
+void mo_hash_stream_init(mo_hash_stream_t* stream);
+
+/**
+ * @brief 追加一段字节
+ */
+void mo_hash_stream_feed(mo_hash_stream_t* stream, const char* str, size_t len);
+
+/**
+ * @brief 结束逐段计算，结果与对全部字节调用mo_hash_bytes相同
+ */
+uint32_t mo_hash_stream_final(const mo_hash_stream_t* stream);
+
+/**
+ * @brief 编译plural表达式
+ *
+ * @param[in] expr_str 表达式文本（如"n != 1"）
+ * @param[in] len 表达式长度
+ * @param[in] nplurals 翻译形式数量
+ * @param[out] expr 编译结果
+ * @return bool 语法正确且未超出字节码限制时返回true
+ */
+bool mo_plural_compile(const char* expr_str, size_t len, uint32_t nplurals,
+                       mo_plural_expr_t* expr);
+
+/**
+ * @brief 从目录头部的Plural-Forms字段编译plural表达式
+ */
+bool mo_plural_parse_header(const char* header, size_t header_len, mo_plural_expr_t* expr);
+
+/**
+ * @brief 对n求值，返回翻译形式索引（超出nplurals时返回0）
+ */
+uint32_t mo_plural_eval(const mo_plural_expr_t* expr, unsigned long n);
+
+/**
+ * @brief 按目录的Plural-Forms规则选择条目的翻译形式msgstr[n]
+ */
+const char* mo_select_plural(const mo_context_t* ctx, uint32_t index, unsigned long n);
+
+/**
+ * @brief 解析头部条目的字段到ctx->metadata并编译Plural-Forms到ctx->plural
+ * @note header为NULL时所有字段为空字符串，复数规则为默认的(n != 1)，不分配内存。
+ */
+mo_error_t mo_metadata_parse(mo_context_t* ctx, const char* header, size_t header_len);
+
+/**
+ * @brief 释放头部字段的副本
+ */
+void mo_metadata_release(mo_context_t* ctx);
+
+/**
+ * @brief 头部声明的字符集不是UTF-8时，把全部翻译转换为UTF-8并重新解析头部字段
+ * @note 平台不支持该字符集时保留原始字节，返回MO_SUCCESS。
+ */
+mo_error_t mo_charset_transcode(mo_context_t* ctx);
+
+/**
+ * @brief 把.po文本编译为内存中的MO数据（主机字节序，不含哈希表）
+ *
+ * @param[in] ctx 仅用于日志
+ * @param[out] image 堆上的MO数据，由调用者释放
+ * @return mo_error_t 语法错误时返回MO_ERROR_INVALID_FORMAT并记录行号
+ */
+mo_error_t mo_po_compile(const mo_context_t* ctx, const char* text, size_t size,
+                         uint8_t** image, size_t* image_size);
+
+/**
+ * @brief 记录日志信息
+ */
+void mo_log(const mo_context_t* ctx, const char* fmt, ...);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MO_INTERNAL_H */
@@ -0,0 +1,108 @@
+/**
+ * @file mo_lazy.c
+ * @brief 延迟建立索引 - 在后台线程中建立索引，完成后原子发布
+ *
+ * 句柄创建后先使用无需建立索引的策略查找，后台线程为同一份目录数据建立选定
+ * 策略的索引，放进一个共享数据的目录中，再像重载一样替换句柄的当前目录。
+ * 重载和释放句柄前先等待后台线程结束，发布时不会与它们竞争。
+ */
+
+#include "mo_internal.h"
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+struct mo_lazy {
+    mo_context_t* context;          /**< 句柄 */
+    const mo_search_ops_t* search;  /**< 要建立的查找策略 */
+#ifdef _WIN32
+    HANDLE thread;
+#else
+    pthread_t thread;
+#endif
+};
+
+#ifdef _WIN32
+static DWORD WINAPI mo_lazy_main(LPVOID arg);
+#else
+static void* mo_lazy_main(void* arg);
+#endif
+
+/**
+ * @brief 后台线程入口
+ */
+#ifdef _WIN32
+static DWORD WINAPI mo_lazy_main(LPVOID arg)
+#else
+static void* mo_lazy_main(void* arg)
+#endif
+{
+    mo_lazy_t* lazy = (mo_lazy_t*)arg;
+    
+    mo_context_publish_index(lazy->context, lazy->search);
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * @brief 启动后台线程建立索引
+ */
+mo_error_t mo_lazy_start(mo_context_t* ctx, const mo_search_ops_t* search)
+{
+    mo_lazy_t* lazy = (mo_lazy_t*)calloc(1, sizeof(mo_lazy_t));
+    
+    if (!lazy)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    
+    lazy->context = ctx;
+    lazy->search = search;
+    
+#ifdef _WIN32
+    lazy->thread = CreateThread(NULL, 0, mo_lazy_main, lazy, 0, NULL);
+    if (!lazy->thread)
+    {
+        free(lazy);
+        return MO_ERROR_MEMORY;
+    }
+#else
+    if (pthread_create(&lazy->thread, NULL, mo_lazy_main, lazy) != 0)
+    {
+        free(lazy);
+        return MO_ERROR_MEMORY;
+    }
+#endif
+    
+    atomic_store(&ctx->lazy, lazy);
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 等待后台线程结束
+ */
+void mo_lazy_join(mo_context_t* ctx)
+{
+    /* 取走线程记录，保证只有一个调用者等待同一个线程 */
+    mo_lazy_t* lazy = atomic_exchange(&ctx->lazy, NULL);
+    
+    if (!lazy)
+    {
+        return;
+    }
+    
+#ifdef _WIN32
+    WaitForSingleObject(lazy->thread, INFINITE);
+    CloseHandle(lazy->thread);
+#else
+    pthread_join(lazy->thread, NULL);
+#endif
+    free(lazy);
+}
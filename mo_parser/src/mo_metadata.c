@@ -0,0 +1,264 @@
+/**
+ * @file mo_metadata.c
+ * @brief 目录头部元数据
+ *
+ * msgid为空的头部条目是"Name: value"逐行排列的字段。加载时只扫描一遍，把常用字段的
+ * 值复制到一块堆内存中并以NUL结尾，之后的访问直接返回这些副本，不再搜索头部文本。
+ * 头部条目本身不参与查找。
+ */
+
+#include "mo_internal.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 解析的字段数（含从Content-Type中取出的charset） */
+#define MO_METADATA_FIELDS 8
+
+/* 缺失字段的值 */
+static const char s_empty[] = "";
+
+/* 没有头部条目的目录使用的元数据和复数规则(n != 1) */
+static const mo_metadata_t s_default_metadata = {
+    s_empty, s_empty, s_empty, s_empty, s_empty, s_empty, s_empty, s_empty, 2
+};
+static const mo_plural_expr_t s_default_plural = { .code_len = 0, .nplurals = 2 };
+
+/* 头部字段名与mo_metadata_t成员的对应关系，charset不是独立字段，单独处理 */
+static const struct {
+    const char* name;
+    size_t offset;
+} s_fields[] = {
+    { "Project-Id-Version:", offsetof(mo_metadata_t, project_id_version) },
+    { "PO-Revision-Date:",   offsetof(mo_metadata_t, po_revision_date) },
+    { "Last-Translator:",    offsetof(mo_metadata_t, last_translator) },
+    { "Language-Team:",      offsetof(mo_metadata_t, language_team) },
+    { "Language:",           offsetof(mo_metadata_t, language) },
+    { "Content-Type:",       offsetof(mo_metadata_t, content_type) },
+    { "Plural-Forms:",       offsetof(mo_metadata_t, plural_forms) },
+};
+
+#define MO_METADATA_NAMED (sizeof(s_fields) / sizeof(s_fields[0]))
+
+/* Content-Type在s_fields中的下标，charset从它的值中取出 */
+#define MO_FIELD_CONTENT_TYPE 5
+
+/* 字段值在头部文本中的位置 */
+typedef struct {
+    const char* value;
+    size_t len;
+} mo_field_span_t;
+
+static void mo_trim(mo_field_span_t* span);
+static void mo_find_charset(const mo_field_span_t* content_type, mo_field_span_t* charset);
+static const char** mo_metadata_slot(mo_metadata_t* metadata, size_t offset);
+
+/**
+ * @brief 去掉字段值首尾的空白
+ */
+static void mo_trim(mo_field_span_t* span)
+{
+    while (span->len > 0 && (*span->value == ' ' || *span->value == '\t'))
+    {
+        span->value++;
+        span->len--;
+    }
+    while (span->len > 0 && (span->value[span->len - 1] == ' ' ||
+                             span->value[span->len - 1] == '\t' ||
+                             span->value[span->len - 1] == '\r'))
+    {
+        span->len--;
+    }
+}
+
+/**
+ * @brief 从Content-Type的值中取出charset参数
+ *
+ * @note 如"text/plain; charset=UTF-8"，参数值到';'或空白结束。
+ */
+static void mo_find_charset(const mo_field_span_t* content_type, mo_field_span_t* charset)
+{
+    const char* p = content_type->value;
+    const char* end = content_type->value + content_type->len;
+    
+    charset->value = NULL;
+    charset->len = 0;
+    for (; p + 8 <= end; p++)
+    {
+        if (memcmp(p, "charset=", 8) == 0)
+        {
+            p += 8;
+            charset->value = p;
+            while (p < end && *p != ';' && *p != ' ' && *p != '\t')
+            {
+                p++;
+            }
+            charset->len = (size_t)(p - charset->value);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 返回metadata中指定偏移处的字段指针
+ */
+static const char** mo_metadata_slot(mo_metadata_t* metadata, size_t offset)
+{
+    return (const char**)((char*)metadata + offset);
+}
+
+/**
+ * @brief 解析目录头部
+ *
+ * @note 编译后的复数规则、mo_metadata_t和所有字段值的副本放在同一块堆内存中，缺失的
+ *       字段指向空字符串，Plural-Forms缺失或无法解析时使用默认规则(n != 1)。header为
+ *       NULL（目录没有头部条目）时指向内置的默认值，不分配内存。
+ */
+mo_error_t mo_metadata_parse(mo_context_t* ctx, const char* header, size_t header_len)
+{
+    mo_field_span_t spans[MO_METADATA_FIELDS];
+    const char* line = header;
+    const char* end = header ? header + header_len : NULL;
+    size_t total = 0;
+    size_t i;
+    
+    memset(spans, 0, sizeof(spans));
+    
+    /* 逐行匹配字段名，同名字段出现多次时以第一次为准 */
+    while (line && line < end)
+    {
+        const char* eol = memchr(line, '\n', (size_t)(end - line));
+        if (!eol)
+        {
+            eol = end;
+        }
+    
+        for (i = 0; i < MO_METADATA_NAMED; i++)
+        {
+            size_t name_len = strlen(s_fields[i].name);
+            if (!spans[i].value && (size_t)(eol - line) >= name_len &&
+                memcmp(line, s_fields[i].name, name_len) == 0)
+            {
+                spans[i].value = line + name_len;
+                spans[i].len = (size_t)(eol - line) - name_len;
+                mo_trim(&spans[i]);
+                break;
+            }
+        }
+    
+        line = eol + 1;
+    }
+    
+    mo_find_charset(&spans[MO_FIELD_CONTENT_TYPE], &spans[MO_METADATA_NAMED]);
+    
+    ctx->metadata_block = NULL;
+    ctx->metadata_size = 0;
+    ctx->metadata = &s_default_metadata;
+    ctx->plural = &s_default_plural;
+    if (!header)
+    {
+        return MO_SUCCESS;
+    }
+    
+    total = sizeof(mo_header_block_t);
+    for (i = 0; i < MO_METADATA_FIELDS; i++)
+    {
+        if (spans[i].len > 0)
+        {
+            total += spans[i].len + 1;
+        }
+    }
+    
+    mo_header_block_t* block = (mo_header_block_t*)malloc(total);
+    if (!block)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    
+    if (!mo_plural_parse_header(header, header_len, &block->plural))
+    {
+        memset(&block->plural, 0, sizeof(block->plural));
+        block->plural.nplurals = 2;
+    }
+    
+    /* 依次复制各字段的值 */
+    char* out = (char*)(block + 1);
+    for (i = 0; i < MO_METADATA_FIELDS; i++)
+    {
+        const char** slot = mo_metadata_slot(&block->metadata, i < MO_METADATA_NAMED ?
+                                             s_fields[i].offset :
+                                             offsetof(mo_metadata_t, charset));
+        if (spans[i].len == 0)
+        {
+            *slot = s_empty;
+            continue;
+        }
+        memcpy(out, spans[i].value, spans[i].len);
+        out[spans[i].len] = '\0';
+        *slot = out;
+        out += spans[i].len + 1;
+    }
+    block->metadata.nplurals = block->plural.nplurals;
+    
+    ctx->metadata_block = block;
+    ctx->metadata_size = total;
+    ctx->metadata = &block->metadata;
+    ctx->plural = &block->plural;
+    
+    mo_log(ctx, "Metadata: language=\"%s\", charset=\"%s\"",
+           block->metadata.language, block->metadata.charset);
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 释放头部字段的副本（可重复调用）
+ */
+void mo_metadata_release(mo_context_t* ctx)
+{
+    free(ctx->metadata_block);
+    ctx->metadata_block = NULL;
+    ctx->metadata_size = 0;
+}
+
+/**
+ * @brief 获取目录头部元数据
+ */
+const mo_metadata_t* mo_get_metadata(const mo_context_t* context)
+{
+    const mo_metadata_t* metadata = NULL;
+    
+    if (context)
+    {
+        mo_read_begin();
+        metadata = mo_context_current(context)->metadata;
+        mo_read_end();
+    }
+    return metadata;
+}
+
+/**
+ * @brief 获取目录的字符集
+ */
+const char* mo_get_charset(const mo_context_t* context)
+{
+    const mo_metadata_t* metadata = mo_get_metadata(context);
+    return metadata ? metadata->charset : s_empty;
+}
+
+/**
+ * @brief 获取目录的语言
+ */
+const char* mo_get_language(const mo_context_t* context)
+{
+    const mo_metadata_t* metadata = mo_get_metadata(context);
+    return metadata ? metadata->language : s_empty;
+}
+
+/**
+ * @brief 获取目录头部的Plural-Forms
+ */
+const char* mo_get_plural_forms(const mo_context_t* context)
+{
+    const mo_metadata_t* metadata = mo_get_metadata(context);
+    return metadata ? metadata->plural_forms : s_empty;
+}
@@ -0,0 +1,691 @@
+/**
+ * @file mo_paged.c
+ * @brief 分页读取的目录 - 经读取回调按需载入字符串
+ *
+ * 目录数据不载入内存，常驻的只有按哈希值排序的{哈希值, 条目序号}索引（每条目8字节）、
+ * 固定页数的页缓存和存放返回结果的环形缓冲区。查找时在索引中二分定位哈希值，
+ * 再经页缓存读取字符串表和原文逐字节比较；页缓存满时淘汰最久未使用的页。
+ * 内存占用由创建选项决定，与目录文件的大小无关。
+ */
+
+#include "mo_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* 默认选项 */
+#define MO_PAGED_DEFAULT_PAGE_SIZE 256
+#define MO_PAGED_DEFAULT_PAGE_COUNT 8
+#define MO_PAGED_DEFAULT_RESULT_SIZE 512
+
+/* 常驻索引项 */
+typedef struct {
+    uint32_t hash;              /**< 查找键的哈希值 */
+    uint32_t index;             /**< 条目序号 */
+} mo_paged_slot_t;
+
+struct mo_paged {
+    mo_read_callback_t read;    /**< 读取回调 */
+    void* user_data;            /**< 传给回调的用户数据 */
+    size_t size;                /**< 目录数据的总字节数 */
+
+    /* 页缓存 */
+    uint8_t* pages;             /**< page_count页，每页page_size字节 */
+    uint32_t* page_numbers;     /**< 各缓存页对应的页号，MO_INDEX_NONE表示空闲 */
+    uint32_t* page_used;        /**< 各缓存页最近一次使用时的计数 */
+    uint32_t page_size;
+    uint32_t page_count;
+    uint32_t clock;             /**< 使用计数，每次访问加1 */
+
+    /* 常驻索引 */
+    mo_paged_slot_t* slots;     /**< 按哈希值（相同时按条目序号）排序 */
+    uint32_t slot_count;        /**< 索引项数（不含头部条目和放不进结果缓冲区的条目） */
+
+    /* 返回给调用者的字符串 */
+    char* results;              /**< 环形缓冲区 */
+    uint32_t result_size;
+    uint32_t result_pos;        /**< 下一次写入的位置 */
+};
+
+static const uint8_t* mo_paged_page(const mo_context_t* ctx, uint32_t page);
+static bool mo_paged_read(const mo_context_t* ctx, size_t offset, void* buffer, size_t len);
+static bool mo_paged_equal(const mo_context_t* ctx, size_t offset, const char* str, size_t len);
+static bool mo_paged_entry(const mo_context_t* ctx, uint32_t table, uint32_t index,
+                           uint32_t* len, uint32_t* offset);
+static char* mo_paged_reserve(mo_paged_t* paged, size_t size);
+static int mo_paged_compare(const void* a, const void* b);
+static mo_error_t mo_paged_build(mo_context_t* ctx, const mo_paged_options_t* options);
+static bool mo_paged_hash_key(const mo_context_t* ctx, size_t offset, size_t len,
+                              uint32_t* hash);
+static mo_error_t mo_paged_build_slots(mo_context_t* ctx);
+static mo_error_t mo_build_paged(mo_context_t* ctx);
+static uint32_t mo_find_string_paged(const mo_context_t* ctx, const mo_lookup_key_t* key,
+                                     uint32_t hash);
+static void mo_release_paged(mo_context_t* ctx);
+static size_t mo_paged_memory(const mo_context_t* ctx);
+static size_t mo_foreach_prefix_paged(const mo_context_t* ctx, const char* prefix,
+                                      size_t prefix_len, mo_entry_callback_t callback,
+                                      void* user_data);
+
+/**
+ * @brief 取得指定页的数据，未缓存时淘汰最久未使用的页并经回调读入
+ *
+ * @return 页数据，读取失败时返回NULL
+ */
+static const uint8_t* mo_paged_page(const mo_context_t* ctx, uint32_t page)
+{
+    mo_paged_t* paged = ctx->paged;
+    uint32_t victim = 0;
+    uint32_t i;
+    
+    paged->clock++;
+    for (i = 0; i < paged->page_count; i++)
+    {
+        if (paged->page_numbers[i] == page)
+        {
+            MO_STAT_INC(ctx, page_hits);
+            paged->page_used[i] = paged->clock;
+            return paged->pages + (size_t)i * paged->page_size;
+        }
+        /* 空闲页的计数为0，总是先被选中 */
+        if (paged->page_used[i] < paged->page_used[victim])
+        {
+            victim = i;
+        }
+    }
+    
+    MO_STAT_INC(ctx, page_misses);
+    
+    size_t offset = (size_t)page * paged->page_size;
+    size_t len = paged->size - offset < paged->page_size ? paged->size - offset : paged->page_size;
+    uint8_t* data = paged->pages + (size_t)victim * paged->page_size;
+    
+    if (!paged->read(paged->user_data, offset, data, len))
+    {
+        paged->page_numbers[victim] = MO_INDEX_NONE;
+        paged->page_used[victim] = 0;
+        mo_log(ctx, "Paged read failed: offset=%zu, size=%zu", offset, len);
+        return NULL;
+    }
+    
+    paged->page_numbers[victim] = page;
+    paged->page_used[victim] = paged->clock;
+    return data;
+}
+
+/**
+ * @brief 经页缓存读取[offset, offset + len)，可以跨页
+ */
+static bool mo_paged_read(const mo_context_t* ctx, size_t offset, void* buffer, size_t len)
+{
+    const mo_paged_t* paged = ctx->paged;
+    uint8_t* out = (uint8_t*)buffer;
+    
+    while (len > 0)
+    {
+        uint32_t page = (uint32_t)(offset / paged->page_size);
+        size_t start = offset % paged->page_size;
+        size_t chunk = paged->page_size - start < len ? paged->page_size - start : len;
+        const uint8_t* data = mo_paged_page(ctx, page);
+        if (!data)
+        {
+            return false;
+        }
+    
+        memcpy(out, data + start, chunk);
+        out += chunk;
+        offset += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+/**
+ * @brief 判断目录中[offset, offset + len)是否等于str，逐页比较而不复制
+ */
+static bool mo_paged_equal(const mo_context_t* ctx, size_t offset, const char* str, size_t len)
+{
+    const mo_paged_t* paged = ctx->paged;
+    
+    while (len > 0)
+    {
+        uint32_t page = (uint32_t)(offset / paged->page_size);
+        size_t start = offset % paged->page_size;
+        size_t chunk = paged->page_size - start < len ? paged->page_size - start : len;
+        const uint8_t* data = mo_paged_page(ctx, page);
+        if (!data || memcmp(data + start, str, chunk) != 0)
+        {
+            return false;
+        }
+    
+        str += chunk;
+        offset += chunk;
+        len -= chunk;
+    }
+    return true;
+}
+
+/**
+ * @brief 读取字符串表（起始偏移为table）中的一项
+ */
+static bool mo_paged_entry(const mo_context_t* ctx, uint32_t table, uint32_t index,
+                           uint32_t* len, uint32_t* offset)
+{
+    mo_string_entry_t entry;
+    
+    if (!mo_paged_read(ctx, (size_t)table + (size_t)index * sizeof(entry), &entry, sizeof(entry)))
+    {
+        return false;
+    }
+    *len = mo_swap_uint32(entry.length, ctx->need_swap);
+    *offset = mo_swap_uint32(entry.offset, ctx->need_swap);
+    return true;
+}
+
+/**
+ * @brief 在结果缓冲区中分配size字节，空间不足时从头开始覆盖
+ *
+ * @return 超过缓冲区大小时返回NULL
+ */
+static char* mo_paged_reserve(mo_paged_t* paged, size_t size)
+{
+    char* result;
+    
+    if (size > paged->result_size)
+    {
+        return NULL;
+    }
+    if (paged->result_size - paged->result_pos < size)
+    {
+        paged->result_pos = 0;
+    }
+    
+    result = paged->results + paged->result_pos;
+    paged->result_pos += (uint32_t)size;
+    return result;
+}
+
+/**
+ * @brief 按哈希值排序，相同时按条目序号，与文件中的顺序一致
+ */
+static int mo_paged_compare(const void* a, const void* b)
+{
+    const mo_paged_slot_t* x = (const mo_paged_slot_t*)a;
+    const mo_paged_slot_t* y = (const mo_paged_slot_t*)b;
+    
+    if (x->hash != y->hash)
+    {
+        return x->hash < y->hash ? -1 : 1;
+    }
+    return x->index < y->index ? -1 : (x->index > y->index);
+}
+
+/**
+ * @brief 经页缓存逐页计算[offset, offset + len)中第一个NUL之前部分的哈希值，不复制字符串
+ */
+static bool mo_paged_hash_key(const mo_context_t* ctx, size_t offset, size_t len,
+                              uint32_t* hash)
+{
+    const mo_paged_t* paged = ctx->paged;
+    mo_hash_stream_t stream;
+    
+    mo_hash_stream_init(&stream);
+    while (len > 0)
+    {
+        uint32_t page = (uint32_t)(offset / paged->page_size);
+        size_t start = offset % paged->page_size;
+        size_t chunk = paged->page_size - start < len ? paged->page_size - start : len;
+        const uint8_t* data = mo_paged_page(ctx, page);
+        if (!data)
+        {
+            return false;
+        }
+    
+        const uint8_t* nul = (const uint8_t*)memchr(data + start, '\0', chunk);
+        if (nul)
+        {
+            mo_hash_stream_feed(&stream, (const char*)data + start, (size_t)(nul - (data + start)));
+            break;
+        }
+        mo_hash_stream_feed(&stream, (const char*)data + start, chunk);
+        offset += chunk;
+        len -= chunk;
+    }
+    
+    *hash = mo_hash_stream_final(&stream);
+    return true;
+}
+
+/**
+ * @brief 扫描字符串表，计算各条目查找键的哈希值并排序
+ *
+ * @note 原文经页缓存逐页参与哈希计算，不整体载入，建立索引所需的内存与原文长度无关。
+ */
+static mo_error_t mo_paged_build_slots(mo_context_t* ctx)
+{
+    mo_paged_t* paged = ctx->paged;
+    uint32_t skipped = 0;
+    uint32_t i;
+    
+    paged->slots = (mo_paged_slot_t*)malloc(
+        (ctx->num_strings ? ctx->num_strings : 1) * sizeof(mo_paged_slot_t));
+    if (!paged->slots)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    
+    for (i = 0; i < ctx->num_strings; i++)
+    {
+        uint32_t orig_len;
+        uint32_t orig_offset;
+        uint32_t trans_len;
+        uint32_t trans_offset;
+    
+        if (!mo_paged_entry(ctx, ctx->header.orig_table_offset, i, &orig_len, &orig_offset) ||
+            !mo_paged_entry(ctx, ctx->header.trans_table_offset, i, &trans_len, &trans_offset))
+        {
+            return MO_ERROR_IO;
+        }
+        if ((uint64_t)orig_offset + orig_len + 1 > paged->size ||
+            (uint64_t)trans_offset + trans_len + 1 > paged->size)
+        {
+            return MO_ERROR_INVALID_FORMAT;
+        }
+    
+        /* 头部条目不参与查找 */
+        if (orig_len == 0)
+        {
+            ctx->header_index = i;
+            continue;
+        }
+    
+        /* 翻译放不进结果缓冲区的条目按未翻译处理 */
+        if ((uint64_t)trans_len + 1 > paged->result_size)
+        {
+            skipped++;
+            continue;
+        }
+    
+        /* 查找键到第一个NUL为止（复数条目只取单数msgid） */
+        if (!mo_paged_hash_key(ctx, orig_offset, orig_len,
+                               &paged->slots[paged->slot_count].hash))
+        {
+            return MO_ERROR_IO;
+        }
+        paged->slots[paged->slot_count].index = i;
+        paged->slot_count++;
+    }
+    
+    qsort(paged->slots, paged->slot_count, sizeof(mo_paged_slot_t), mo_paged_compare);
+    if (skipped > 0)
+    {
+        mo_log(ctx, "Paged: %u entries exceed the result buffer and stay untranslated", skipped);
+    }
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 分配页缓存和结果缓冲区，读取头部并建立常驻索引
+ */
+static mo_error_t mo_paged_build(mo_context_t* ctx, const mo_paged_options_t* options)
+{
+    mo_paged_t* paged = ctx->paged;
+    mo_header_t raw;
+    mo_header_t* header = &ctx->header;
+    mo_error_t result = MO_SUCCESS;
+    char* header_text = NULL;
+    uint32_t header_len = 0;
+    uint32_t i;
+    
+    paged->read = options->read;
+    paged->user_data = options->user_data;
+    paged->size = options->size;
+    paged->page_size = options->page_size;
+    paged->page_count = options->page_count;
+    paged->result_size = options->result_size;
+    paged->pages = (uint8_t*)malloc((size_t)paged->page_size * paged->page_count);
+    paged->page_numbers = (uint32_t*)malloc(paged->page_count * sizeof(uint32_t));
+    paged->page_used = (uint32_t*)calloc(paged->page_count, sizeof(uint32_t));
+    paged->results = (char*)malloc(paged->result_size);
+    if (!paged->pages || !paged->page_numbers || !paged->page_used || !paged->results)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    for (i = 0; i < paged->page_count; i++)
+    {
+        paged->page_numbers[i] = MO_INDEX_NONE;
+    }
+    
+    /* 检查魔数，确定字节序 */
+    if (!mo_paged_read(ctx, 0, &raw, sizeof(raw)))
+    {
+        return MO_ERROR_IO;
+    }
+    if (raw.magic == MO_MAGIC)
+    {
+        ctx->need_swap = false;
+    }
+    else if (raw.magic == MO_MAGIC_REV)
+    {
+        ctx->need_swap = true;
+    }
+    else
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    
+    header->magic = MO_MAGIC;
+    header->revision = mo_swap_uint32(raw.revision, ctx->need_swap);
+    header->num_strings = mo_swap_uint32(raw.num_strings, ctx->need_swap);
+    header->orig_table_offset = mo_swap_uint32(raw.orig_table_offset, ctx->need_swap);
+    header->trans_table_offset = mo_swap_uint32(raw.trans_table_offset, ctx->need_swap);
+    header->hash_table_size = mo_swap_uint32(raw.hash_table_size, ctx->need_swap);
+    header->hash_table_offset = mo_swap_uint32(raw.hash_table_offset, ctx->need_swap);
+    
+    if ((uint64_t)header->orig_table_offset +
+            (uint64_t)header->num_strings * sizeof(mo_string_entry_t) > paged->size ||
+        (uint64_t)header->trans_table_offset +
+            (uint64_t)header->num_strings * sizeof(mo_string_entry_t) > paged->size)
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    ctx->num_strings = header->num_strings;
+    ctx->header_index = MO_INDEX_NONE;
+    
+    result = mo_paged_build_slots(ctx);
+    if (result != MO_SUCCESS)
+    {
+        return result;
+    }
+    
+    /* 头部只在这里读取一次，编译Plural-Forms并解析元数据（解析结果另行保存） */
+    if (ctx->header_index != MO_INDEX_NONE)
+    {
+        uint32_t offset;
+        if (!mo_paged_entry(ctx, header->trans_table_offset, ctx->header_index,
+                            &header_len, &offset))
+        {
+            return MO_ERROR_IO;
+        }
+        header_text = (char*)malloc((size_t)header_len + 1);
+        if (!header_text)
+        {
+            return MO_ERROR_MEMORY;
+        }
+        if (!mo_paged_read(ctx, offset, header_text, header_len))
+        {
+            result = MO_ERROR_IO;
+            goto cleanup;
+        }
+        header_text[header_len] = '\0';
+    }
+    result = mo_metadata_parse(ctx, header_text, header_len);
+    
+cleanup:
+    free(header_text);
+    return result;
+}
+
+/**
+ * @brief 初始化分页读取选项为默认值
+ */
+void mo_paged_options_init(mo_paged_options_t* options)
+{
+    if (!options)
+    {
+        return;
+    }
+    
+    memset(options, 0, sizeof(mo_paged_options_t));
+    options->page_size = MO_PAGED_DEFAULT_PAGE_SIZE;
+    options->page_count = MO_PAGED_DEFAULT_PAGE_COUNT;
+    options->result_size = MO_PAGED_DEFAULT_RESULT_SIZE;
+}
+
+/**
+ * @brief 通过读取回调分页访问目录并创建解析上下文
+ */
+mo_error_t mo_context_create_paged(const mo_paged_options_t* options, mo_context_t** context)
+{
+    mo_error_t result = MO_SUCCESS;
+    mo_context_t* ctx = NULL;
+    
+    /* 参数检查 */
+    if (!options || !options->read || !context || options->size < sizeof(mo_header_t) ||
+        options->page_size == 0 || options->page_count == 0 || options->result_size == 0 ||
+        options->size / options->page_size >= MO_INDEX_NONE)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    /* 分配上下文结构 */
+    ctx = (mo_context_t*)calloc(1, sizeof(mo_context_t));
+    if (!ctx)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    
+    /* 先设置策略，失败时由mo_context_free经release释放分页状态 */
+    ctx->search = &mo_search_paged;
+    ctx->paged = (mo_paged_t*)calloc(1, sizeof(mo_paged_t));
+    if (!ctx->paged)
+    {
+        result = MO_ERROR_MEMORY;
+        goto cleanup;
+    }
+    
+    result = mo_paged_build(ctx, options);
+    if (result != MO_SUCCESS)
+    {
+        goto cleanup;
+    }
+    
+    mo_log(ctx, "Paged MO context created: %u strings, %u pages of %u bytes, %u-byte results",
+           ctx->num_strings, ctx->paged->page_count, ctx->paged->page_size,
+           ctx->paged->result_size);
+    *context = ctx;
+    return MO_SUCCESS;
+    
+cleanup:
+    mo_context_free(ctx);
+    return result;
+}
+
+/**
+ * @brief 把条目的翻译复制到结果缓冲区
+ */
+const char* mo_paged_translation(const mo_context_t* ctx, uint32_t index, uint32_t* len)
+{
+    uint32_t offset;
+    char* result;
+    
+    /* 索引中的条目在建立时已确认翻译放得进结果缓冲区 */
+    if (!mo_paged_entry(ctx, ctx->header.trans_table_offset, index, len, &offset) ||
+        !(result = mo_paged_reserve(ctx->paged, (size_t)*len + 1)) ||
+        !mo_paged_read(ctx, offset, result, *len))
+    {
+        *len = 0;
+        return "";
+    }
+    
+    result[*len] = '\0';
+    return result;
+}
+
+/**
+ * @brief 常驻索引在创建时已经建立，这里只确认分页状态存在
+ */
+static mo_error_t mo_build_paged(mo_context_t* ctx)
+{
+    return ctx->paged ? MO_SUCCESS : MO_ERROR_INVALID_CONTEXT;
+}
+
+/**
+ * @brief 在常驻索引中二分定位哈希值，再逐个比较原文
+ */
+static uint32_t mo_find_string_paged(const mo_context_t* ctx, const mo_lookup_key_t* key,
+                                     uint32_t hash)
+{
+    const mo_paged_t* paged = ctx->paged;
+    uint32_t low = 0;
+    uint32_t high = paged->slot_count;
+    size_t total = key->context ? key->context_len + 1 + key->len : key->len;
+    
+    if (mo_key_is_header(key))
+    {
+        return MO_INDEX_NONE;
+    }
+    
+    /* 第一个哈希值不小于hash的索引项 */
+    while (low < high)
+    {
+        uint32_t mid = low + (high - low) / 2;
+        if (paged->slots[mid].hash < hash)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    
+    for (; low < paged->slot_count && paged->slots[low].hash == hash; low++)
+    {
+        uint32_t index = paged->slots[low].index;
+        uint32_t orig_len;
+        uint32_t offset;
+        size_t pos;
+    
+        MO_STAT_INC(ctx, comparisons);
+        if (!mo_paged_entry(ctx, ctx->header.orig_table_offset, index, &orig_len, &offset) ||
+            total > orig_len)
+        {
+            continue;
+        }
+    
+        /* 依次比较msgctxt、分隔符和msgid，之后条目须在该位置结束 */
+        pos = offset;
+        if (key->context)
+        {
+            static const char separator[1] = { MO_CONTEXT_SEPARATOR };
+            if (!mo_paged_equal(ctx, pos, key->context, key->context_len) ||
+                !mo_paged_equal(ctx, pos + key->context_len, separator, 1))
+            {
+                MO_STAT_INC(ctx, hash_collisions);
+                continue;
+            }
+            pos += key->context_len + 1;
+        }
+        if (mo_paged_equal(ctx, pos, key->str, key->len) &&
+            mo_paged_equal(ctx, pos + key->len, "", 1))
+        {
+            return index;
+        }
+        MO_STAT_INC(ctx, hash_collisions);
+    }
+    
+    return MO_INDEX_NONE;
+}
+
+/**
+ * @brief 释放分页状态（可重复调用）
+ */
+static void mo_release_paged(mo_context_t* ctx)
+{
+    mo_paged_t* paged = ctx->paged;
+    
+    if (!paged)
+    {
+        return;
+    }
+    
+    free(paged->pages);
+    free(paged->page_numbers);
+    free(paged->page_used);
+    free(paged->slots);
+    free(paged->results);
+    free(paged);
+    ctx->paged = NULL;
+}
+
+/**
+ * @brief 常驻内存：分页状态、索引、页缓存和结果缓冲区
+ */
+static size_t mo_paged_memory(const mo_context_t* ctx)
+{
+    const mo_paged_t* paged = ctx->paged;
+    
+    return sizeof(mo_paged_t) +
+           (size_t)ctx->num_strings * sizeof(mo_paged_slot_t) +
+           (size_t)paged->page_count * (paged->page_size + 2 * sizeof(uint32_t)) +
+           paged->result_size;
+}
+
+/**
+ * @brief 按文件中的顺序枚举以prefix开头的条目
+ *
+ * @note 原文和翻译一起复制到结果缓冲区，两者合计放不进缓冲区的条目不会被枚举。
+ */
+static size_t mo_foreach_prefix_paged(const mo_context_t* ctx, const char* prefix,
+                                      size_t prefix_len, mo_entry_callback_t callback,
+                                      void* user_data)
+{
+    mo_paged_t* paged = ctx->paged;
+    size_t count = 0;
+    uint32_t i;
+    
+    for (i = 0; i < ctx->num_strings; i++)
+    {
+        uint32_t orig_len;
+        uint32_t orig_offset;
+        uint32_t trans_len;
+        uint32_t trans_offset;
+        char* original;
+    
+        if (i == ctx->header_index ||
+            !mo_paged_entry(ctx, ctx->header.orig_table_offset, i, &orig_len, &orig_offset) ||
+            orig_len < prefix_len || !mo_paged_equal(ctx, orig_offset, prefix, prefix_len) ||
+            !mo_paged_entry(ctx, ctx->header.trans_table_offset, i, &trans_len, &trans_offset))
+        {
+            continue;
+        }
+    
+        original = mo_paged_reserve(paged, (size_t)orig_len + 1 + trans_len + 1);
+        if (!original ||
+            !mo_paged_read(ctx, orig_offset, original, orig_len) ||
+            !mo_paged_read(ctx, trans_offset, original + orig_len + 1, trans_len))
+        {
+            continue;
+        }
+        original[orig_len] = '\0';
+        original[orig_len + 1 + trans_len] = '\0';
+    
+        /* 复数条目的前缀可能只匹配到复数msgid，按查找键重新确认 */
+        size_t key_len = strlen(original);
+        if (key_len < prefix_len)
+        {
+            continue;
+        }
+    
+        count++;
+        if (!callback(original, key_len, original + orig_len + 1, user_data))
+        {
+            break;
+        }
+    }
+    return count;
+}
+
+const mo_search_ops_t mo_search_paged = {
+    MO_SEARCH_PAGED,
+    "PAGED",
+    mo_build_paged,
+    mo_hash_bytes,
+    mo_hash_cstr,
+    mo_hash_key,
+    mo_find_string_paged,
+    mo_release_paged,
+    NULL,
+    mo_paged_memory,
+    mo_foreach_prefix_paged
+};
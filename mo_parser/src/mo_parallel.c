@@ -0,0 +1,117 @@
+/**
+ * @file mo_parallel.c
+ * @brief 建立索引时的并行执行
+ *
+ * 大目录的条目校验、哈希计算和排序按条目范围分成若干份，每份由一个线程处理，
+ * 第0份在调用线程中执行。每次调用临时创建线程，只在加载时使用，不维护常驻线程池。
+ */
+
+#include "mo_internal.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/* 单个线程至少处理的条目数，条目较少时并行的开销超过收益 */
+#define MO_PARALLEL_MIN_ITEMS 16384
+
+/* 一份任务 */
+typedef struct {
+    mo_parallel_task_t task;
+    void* arg;
+    uint32_t part;
+    uint32_t parts;
+} mo_parallel_job_t;
+
+#ifdef _WIN32
+static DWORD WINAPI mo_parallel_main(LPVOID arg);
+#else
+static void* mo_parallel_main(void* arg);
+#endif
+
+/**
+ * @brief 工作线程入口
+ */
+#ifdef _WIN32
+static DWORD WINAPI mo_parallel_main(LPVOID arg)
+#else
+static void* mo_parallel_main(void* arg)
+#endif
+{
+    mo_parallel_job_t* job = (mo_parallel_job_t*)arg;
+    
+    job->task(job->arg, job->part, job->parts);
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+/**
+ * @brief 确定并行份数
+ */
+uint32_t mo_parallel_parts(const mo_context_t* ctx, uint32_t count)
+{
+    uint32_t parts = count / MO_PARALLEL_MIN_ITEMS;
+    uint32_t threads = ctx->build_threads;
+    
+    if (threads > MO_PARALLEL_MAX_PARTS)
+    {
+        threads = MO_PARALLEL_MAX_PARTS;
+    }
+    if (parts > threads)
+    {
+        parts = threads;
+    }
+    return parts ? parts : 1;
+}
+
+/**
+ * @brief 并行执行任务的各份
+ */
+void mo_parallel_run(uint32_t parts, mo_parallel_task_t task, void* arg)
+{
+    mo_parallel_job_t jobs[MO_PARALLEL_MAX_PARTS];
+    bool started[MO_PARALLEL_MAX_PARTS];
+#ifdef _WIN32
+    HANDLE threads[MO_PARALLEL_MAX_PARTS];
+#else
+    pthread_t threads[MO_PARALLEL_MAX_PARTS];
+#endif
+    uint32_t i;
+    
+    for (i = 1; i < parts; i++)
+    {
+        jobs[i].task = task;
+        jobs[i].arg = arg;
+        jobs[i].part = i;
+        jobs[i].parts = parts;
+#ifdef _WIN32
+        threads[i] = CreateThread(NULL, 0, mo_parallel_main, &jobs[i], 0, NULL);
+        started[i] = threads[i] != NULL;
+#else
+        started[i] = pthread_create(&threads[i], NULL, mo_parallel_main, &jobs[i]) == 0;
+#endif
+    }
+    
+    task(arg, 0, parts);
+    
+    for (i = 1; i < parts; i++)
+    {
+        if (!started[i])
+        {
+            /* 无法创建线程的份在调用线程中补做 */
+            task(arg, i, parts);
+            continue;
+        }
+#ifdef _WIN32
+        WaitForSingleObject(threads[i], INFINITE);
+        CloseHandle(threads[i]);
+#else
+        pthread_join(threads[i], NULL);
+#endif
+    }
+}
@@ -3,7 +3,7 @@
  * @brief MO文件解析器实现 - 支持多种查找策略
  */
 
-#include "mo_parser.h"
+#include "mo_internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -20,147 +20,70 @@
 #include <unistd.h>
 #endif
 
-/* 内部常量定义 */
-#define MO_MAGIC 0x950412de
-#define MO_MAGIC_REV 0xde120495
-#define MO_MAX_STRING_LENGTH 4096
-#define MO_CACHE_SIZE 64
-
-/* 字符串表项结构（内存中） */
-typedef struct {
-    const char* original;
-    const char* translation;
-    size_t original_len;
-    size_t translation_len;
-} mo_string_pair_t;
-
-/* 缓存项结构 */
-typedef struct {
-    const char* original;
-    const char* translation;
-    #ifdef MO_SEARCH_METHOD_HASH
-    uint32_t hash;              /**< 哈希值缓存（仅哈希表模式） */
-    #endif
-} mo_cache_item_t;
-
-/* 哈希表相关定义（仅哈希表模式） */
-#ifdef MO_SEARCH_METHOD_HASH
-#define MO_HASH_TABLE_LOAD_FACTOR 0.75f
-
-/* 哈希表槽位状态 */
-typedef enum {
-    MO_HASH_SLOT_EMPTY = 0,      /**< 空槽位 */
-    MO_HASH_SLOT_OCCUPIED = 1,   /**< 已占用槽位 */
-    MO_HASH_SLOT_DELETED = 2     /**< 已删除槽位 */
-} mo_hash_slot_state_t;
-
-/* 哈希表槽位结构 */
-typedef struct {
-    const char* original;        /**< 原始字符串指针 */
-    const char* translation;     /**< 翻译字符串指针 */
-    uint32_t original_len;       /**< 原始字符串长度 */
-    uint32_t translation_len;    /**< 翻译字符串长度 */
-    uint32_t hash;               /**< 字符串哈希值 */
-    mo_hash_slot_state_t state;  /**< 槽位状态 */
-} mo_hash_slot_t;
+/* 编译时默认查找策略（由CMake的MO_SEARCH_METHOD选项设置） */
+#ifndef MO_DEFAULT_SEARCH_METHOD
+#define MO_DEFAULT_SEARCH_METHOD MO_SEARCH_HASH
 #endif
 
-/* MO文件上下文结构 */
-struct mo_context {
-    uint8_t* data;              /**< MO文件数据指针 */
-    size_t size;                /**< 数据大小 */
-    bool is_mapped;             /**< 是否为内存映射模式 */
-    
-    mo_header_t* header;        /**< 文件头部指针 */
-    mo_string_entry_t* orig_table;  /**< 原始字符串表 */
-    mo_string_entry_t* trans_table; /**< 翻译字符串表 */
-    
-    mo_string_pair_t* pairs;    /**< 字符串对数组（解析后） */
-    uint32_t num_strings;       /**< 字符串数量 */
-    
-    /* 哈希表相关（仅哈希表模式） */
-    #ifdef MO_SEARCH_METHOD_HASH
-    mo_hash_slot_t* hash_table;   /**< 哈希表数组 */
-    uint32_t hash_table_size;     /**< 哈希表大小（必须是2的幂次） */
-    uint32_t hash_table_mask;     /**< 哈希表掩码（size-1） */
-    uint32_t hash_table_count;    /**< 哈希表中已存储的项数 */
-    #endif
-    
-    /* 缓存机制 */
-    mo_cache_item_t cache[MO_CACHE_SIZE];
-    uint32_t cache_index;
-    
-    bool logging_enabled;       /**< 日志开关 */
-    
-    /* 性能统计（可选） */
-    #ifdef MO_ENABLE_STATS
-    mo_stats_t stats;
-    #endif
-    const char* search_method;  /**< 查找方法名称 */
-};
-
-/* 查找策略方法名称 */
-#ifdef MO_SEARCH_METHOD_LINEAR
-static const char* s_search_method = "LINEAR";
-#elif defined(MO_SEARCH_METHOD_BINARY)
-static const char* s_search_method = "BINARY";
-#elif defined(MO_SEARCH_METHOD_HASH)
-static const char* s_search_method = "HASH";
-#else
-static const char* s_search_method = "UNKNOWN";
-#endif
+/* 自动选择策略时，不超过该条目数的目录使用线性查找（无需索引） */
+#define MO_AUTO_LINEAR_THRESHOLD 16
 
 /* 内部函数声明 */
-static uint32_t mo_swap_uint32(uint32_t val, bool swap);
+static mo_error_t mo_read_file(const char* filename, uint8_t** data, size_t* size);
 static const char* mo_get_string(const mo_context_t* ctx, 
                                 const mo_string_entry_t* table,
                                 uint32_t index);
-static void mo_log(const mo_context_t* ctx, const char* fmt, ...);
-
-/* 查找函数声明 */
-#ifdef MO_SEARCH_METHOD_LINEAR
-static uint32_t mo_find_string_linear(const mo_context_t* ctx, 
-                                     const char* str, size_t len);
-#endif
+static mo_error_t mo_context_load(const char* filename, const mo_options_t* options,
+                                  bool po, mo_context_t** context);
+static mo_error_t mo_context_open(const char* filename, const mo_options_t* options,
+                                  bool po, mo_context_t** context);
+static mo_error_t mo_context_compile_po(mo_context_t* ctx);
+static mo_error_t mo_context_parse(mo_context_t* ctx, const mo_options_t* options);
+static void mo_validate_entries(void* arg, uint32_t part, uint32_t parts);
+static void mo_context_release(mo_context_t* context);
+static bool mo_copy_stats(const mo_context_t* context, mo_stats_t* stats);
+static size_t mo_do_translate_batch(mo_context_t* context, const char** keys,
+                                    const size_t* lens, const char** out, size_t n);
+static const char* mo_do_translate_cp(mo_context_t* context, const char* context_str,
+                                      const char* singular, const char* plural,
+                                      unsigned long n);
+static uint32_t mo_context_generation(mo_context_t* ctx);
+static size_t mo_scan_prefix(const mo_context_t* ctx, const char* prefix, size_t prefix_len,
+                             mo_entry_callback_t callback, void* user_data);
+static uint32_t mo_find_index(const mo_context_t* ctx, const mo_lookup_key_t* key);
+static uint32_t mo_search_find(const mo_context_t* ctx, const mo_lookup_key_t* key,
+                               uint32_t hash);
+static const char* mo_lookup_cached(mo_context_t* context, const char* original,
+                                    size_t original_len, uint32_t hash);
+static bool mo_index_needs_build(const mo_context_t* ctx, const mo_search_ops_t* search);
+static const mo_search_ops_t* mo_select_search(const mo_context_t* ctx,
+                                               mo_search_method_t method);
+static bool mo_map_file(const char* filename, const uint8_t** data, size_t* size,
+                        mo_error_t* error);
+static void mo_unmap_file(const uint8_t* data, size_t size);
+static bool mo_cache_lookup(const mo_cache_item_t* item, const char* original,
+                            uint32_t hash, const char** translation);
+static void mo_cache_store(mo_cache_item_t* item, const char* original,
+                           uint32_t hash, const char* translation);
 
-#ifdef MO_SEARCH_METHOD_BINARY
-static uint32_t mo_find_string_binary(const mo_context_t* ctx, 
-                                     const char* str, size_t len);
-static int mo_compare_pairs(const void* a, const void* b);
-#endif
-
-#ifdef MO_SEARCH_METHOD_HASH
-static uint32_t mo_find_string_hash(const mo_context_t* ctx, 
-                                   const char* str, size_t len,
-                                   uint32_t hash);
-static uint32_t mo_hash_string(const char* str, size_t len);
-static uint32_t mo_next_power_of_two(uint32_t n);
-static bool mo_build_hash_table(mo_context_t* ctx);
-#endif
+/* 条目校验的分块结果 */
+typedef struct {
+    const mo_context_t* ctx;
+    bool valid[MO_PARALLEL_MAX_PARTS];
+    uint32_t header_index[MO_PARALLEL_MAX_PARTS];   /**< 头部条目（空msgid）的序号 */
+    uint32_t plural_entries[MO_PARALLEL_MAX_PARTS]; /**< 复数条目数，仅用于日志 */
+} mo_validate_job_t;
 
 /* 全局变量 */
 static bool g_logging_enabled = false;
 
-/**
- * @brief 交换32位整数字节序
- */
-static uint32_t mo_swap_uint32(uint32_t val, bool swap)
-{
-    if (!swap)
-    {
-        return val;
-    }
-    
-    return ((val >> 24) & 0x000000FF) |
-           ((val >> 8)  & 0x0000FF00) |
-           ((val << 8)  & 0x00FF0000) |
-           ((val << 24) & 0xFF000000);
-}
+/* 最近分配的目录代号 */
+static atomic_uint g_generation = 0;
 
 /**
  * @brief 记录日志信息
  */
-static void mo_log(const mo_context_t* ctx, const char* fmt, ...)
+void mo_log(const mo_context_t* ctx, const char* fmt, ...)
 {
     if (!g_logging_enabled && (!ctx || !ctx->logging_enabled))
     {
@@ -201,552 +124,791 @@ const char* mo_error_string(mo_error_t error)
     }
 }
 
-#ifdef MO_SEARCH_METHOD_LINEAR
 /**
- * @brief 线性查找字符串索引
+ * @brief 初始化创建选项为默认值
  */
-static uint32_t mo_find_string_linear(const mo_context_t* ctx, 
-                                     const char* str, size_t len)
+void mo_options_init(mo_options_t* options)
 {
-    if (!ctx || !ctx->pairs || ctx->num_strings == 0)
-    {
-        return 0xFFFFFFFF;
-    }
-    
-    /* 顺序遍历查找 */
-    for (uint32_t i = 0; i < ctx->num_strings; i++)
+    if (!options)
     {
-        const mo_string_pair_t* pair = &ctx->pairs[i];
-        
-        #ifdef MO_ENABLE_STATS
-        ((mo_context_t*)ctx)->stats.comparisons++;
-        #endif
-        
-        /* 先比较长度 */
-        if (pair->original_len != len)
-        {
-            continue;
-        }
-        
-        /* 再比较内容 */
-        if (memcmp(pair->original, str, len) == 0)
-        {
-            return i;
-        }
+        return;
     }
     
-    return 0xFFFFFFFF;
+    memset(options, 0, sizeof(mo_options_t));
+    options->search_method = MO_SEARCH_DEFAULT;
 }
-#endif
 
-#ifdef MO_SEARCH_METHOD_BINARY
 /**
- * @brief 比较字符串对（用于排序）
+ * @brief 策略在该目录上是否需要在加载时建立索引
+ *
+ * @note 带最小完美哈希段或内嵌哈希表的文件，MPH/GETTEXT策略直接使用文件中的数据。
  */
-static int mo_compare_pairs(const void* a, const void* b)
+static bool mo_index_needs_build(const mo_context_t* ctx, const mo_search_ops_t* search)
 {
-    const mo_string_pair_t* pair1 = (const mo_string_pair_t*)a;
-    const mo_string_pair_t* pair2 = (const mo_string_pair_t*)b;
-    
-    /* 先比较长度 */
-    if (pair1->original_len < pair2->original_len)
-        return -1;
-    else if (pair1->original_len > pair2->original_len)
-        return 1;
-    
-    /* 长度相等时，比较内容 */
-    return memcmp(pair1->original, pair2->original, pair1->original_len);
+    if (ctx->num_strings == 0 || search == &mo_search_linear)
+    {
+        return false;
+    }
+    if (search == &mo_search_mph && mo_mph_usable(ctx))
+    {
+        return false;
+    }
+    if ((search == &mo_search_mph || search == &mo_search_gettext) && mo_gettext_usable(ctx))
+    {
+        return false;
+    }
+    return true;
 }
 
 /**
- * @brief 二分查找字符串索引
+ * @brief 根据选项确定上下文使用的查找策略
  */
-static uint32_t mo_find_string_binary(const mo_context_t* ctx, 
-                                     const char* str, size_t len)
+static const mo_search_ops_t* mo_select_search(const mo_context_t* ctx,
+                                               mo_search_method_t method)
 {
-    uint32_t left = 0;
-    uint32_t right = 0;
-    
-    if (!ctx || !ctx->pairs || ctx->num_strings == 0)
+    if (method == MO_SEARCH_DEFAULT)
     {
-        return 0xFFFFFFFF;
+        method = MO_DEFAULT_SEARCH_METHOD;
     }
     
-    right = ctx->num_strings - 1;
-    
-    while (left <= right)
+    switch (method)
     {
-        uint32_t mid = left + (right - left) / 2;
-        const mo_string_pair_t* pair = &ctx->pairs[mid];
-        
-        #ifdef MO_ENABLE_STATS
-        ((mo_context_t*)ctx)->stats.comparisons++;
-        #endif
-        
-        /* 比较长度 */
-        if (pair->original_len < len)
-        {
-            left = mid + 1;
-        }
-        else if (pair->original_len > len)
-        {
-            if (mid == 0) break;
-            right = mid - 1;
-        }
-        else
-        {
-            /* 长度相等，比较内容 */
-            int cmp = memcmp(pair->original, str, len);
-            if (cmp == 0)
-            {
-                return mid;
-            }
-            else if (cmp < 0)
+        case MO_SEARCH_LINEAR:
+            return &mo_search_linear;
+        case MO_SEARCH_BINARY:
+            return &mo_search_binary;
+        case MO_SEARCH_HASH:
+            return &mo_search_hash;
+        case MO_SEARCH_GETTEXT:
+            return &mo_search_gettext;
+        case MO_SEARCH_MPH:
+            return &mo_search_mph;
+        case MO_SEARCH_EYTZINGER:
+            return &mo_search_eytzinger;
+        case MO_SEARCH_AUTO:
+            /* 小目录线性扫描即可，无需任何索引；大目录依次尝试离线构建的完美哈希、
+             * 文件内嵌哈希表，最后才在加载时构建哈希表 */
+            if (ctx->num_strings <= MO_AUTO_LINEAR_THRESHOLD)
             {
-                left = mid + 1;
+                return &mo_search_linear;
             }
-            else
-            {
-                if (mid == 0) break;
-                right = mid - 1;
-            }
-        }
+            return &mo_search_mph;
+        default:
+            return NULL;
     }
-    
-    return 0xFFFFFFFF;
 }
-#endif
 
-#ifdef MO_SEARCH_METHOD_HASH
 /**
- * @brief 计算字符串的哈希值（djb2算法）
+ * @brief 以只读方式将文件映射到内存
+ * 
+ * @note 映射失败（如空文件或平台不支持）时由调用者回退到读取模式。
  */
-static uint32_t mo_hash_string(const char* str, size_t len)
+static bool mo_map_file(const char* filename, const uint8_t** data, size_t* size,
+                        mo_error_t* error)
 {
-    uint32_t hash = 5381;
-    for (size_t i = 0; i < len; i++)
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+    LARGE_INTEGER file_size;
+    void* view = NULL;
+    
+    file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
     {
-        hash = ((hash << 5) + hash) + (uint8_t)str[i]; /* hash * 33 + c */
+        *error = MO_ERROR_FILE_NOT_FOUND;
+        return false;
     }
-    return hash;
-}
-
-/**
- * @brief 获取大于等于n的最小2的幂次
- */
-static uint32_t mo_next_power_of_two(uint32_t n)
-{
-    n--;
-    n |= n >> 1;
-    n |= n >> 2;
-    n |= n >> 4;
-    n |= n >> 8;
-    n |= n >> 16;
-    n++;
-    return n;
-}
-
-/**
- * @brief 构建哈希表
- */
-static bool mo_build_hash_table(mo_context_t* ctx)
-{
-    if (!ctx || !ctx->pairs || ctx->num_strings == 0)
+    
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0 ||
+        (uint64_t)file_size.QuadPart > (uint64_t)SIZE_MAX)
     {
+        CloseHandle(file);
+        *error = MO_ERROR_IO;
         return false;
     }
     
-    /* 计算哈希表初始大小（2的幂次） */
-    uint32_t target_size = (uint32_t)(ctx->num_strings / MO_HASH_TABLE_LOAD_FACTOR) + 1;
-    ctx->hash_table_size = mo_next_power_of_two(target_size);
-    ctx->hash_table_mask = ctx->hash_table_size - 1;
-    ctx->hash_table_count = 0;
+    mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping)
+    {
+        view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        /* 视图独立于句柄存在，映射建立后即可关闭句柄 */
+        CloseHandle(mapping);
+    }
+    CloseHandle(file);
     
-    /* 分配哈希表内存 */
-    ctx->hash_table = (mo_hash_slot_t*)calloc(ctx->hash_table_size, sizeof(mo_hash_slot_t));
-    if (!ctx->hash_table)
+    if (!view)
     {
+        *error = MO_ERROR_IO;
         return false;
     }
     
-    /* 初始化所有槽位为空 */
-    for (uint32_t i = 0; i < ctx->hash_table_size; i++)
+    *data = (const uint8_t*)view;
+    *size = (size_t)file_size.QuadPart;
+    return true;
+#else
+    struct stat st;
+    void* addr = NULL;
+    int fd = open(filename, O_RDONLY);
+    
+    if (fd < 0)
     {
-        ctx->hash_table[i].state = MO_HASH_SLOT_EMPTY;
+        *error = MO_ERROR_FILE_NOT_FOUND;
+        return false;
     }
     
-    /* 插入所有字符串对到哈希表 */
-    for (uint32_t i = 0; i < ctx->num_strings; i++)
+    if (fstat(fd, &st) != 0 || st.st_size <= 0)
     {
-        const mo_string_pair_t* pair = &ctx->pairs[i];
-        uint32_t hash = mo_hash_string(pair->original, pair->original_len);
-        uint32_t index = hash & ctx->hash_table_mask;
-        
-        /* 开放寻址处理冲突 */
-        while (ctx->hash_table[index].state == MO_HASH_SLOT_OCCUPIED)
-        {
-            index = (index + 1) & ctx->hash_table_mask;
-        }
-        
-        /* 填充槽位 */
-        ctx->hash_table[index].original = pair->original;
-        ctx->hash_table[index].translation = pair->translation;
-        ctx->hash_table[index].original_len = pair->original_len;
-        ctx->hash_table[index].translation_len = pair->translation_len;
-        ctx->hash_table[index].hash = hash;
-        ctx->hash_table[index].state = MO_HASH_SLOT_OCCUPIED;
-        ctx->hash_table_count++;
+        close(fd);
+        *error = MO_ERROR_IO;
+        return false;
     }
     
-    mo_log(ctx, "Hash table built: size=%u, items=%u, load=%.2f", 
-           ctx->hash_table_size, ctx->hash_table_count,
-           (float)ctx->hash_table_count / ctx->hash_table_size);
+    addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    /* 映射建立后文件描述符不再需要 */
+    close(fd);
+    
+    if (addr == MAP_FAILED)
+    {
+        *error = MO_ERROR_IO;
+        return false;
+    }
     
+    *data = (const uint8_t*)addr;
+    *size = (size_t)st.st_size;
     return true;
+#endif
+}
+
+/**
+ * @brief 解除文件映射
+ */
+static void mo_unmap_file(const uint8_t* data, size_t size)
+{
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile((LPCVOID)data);
+#else
+    munmap((void*)data, size);
+#endif
 }
 
 /**
- * @brief 使用哈希表查找字符串索引
+ * @brief 以读取方式将整个文件加载到堆内存（映射不可用时的回退路径）
  */
-static uint32_t mo_find_string_hash(const mo_context_t* ctx, 
-                                   const char* str, size_t len,
-                                   uint32_t hash)
+static mo_error_t mo_read_file(const char* filename, uint8_t** data, size_t* size)
 {
-    if (!ctx || !ctx->hash_table || ctx->hash_table_size == 0 || !str)
+    mo_error_t result = MO_SUCCESS;
+    FILE* file = NULL;
+    uint8_t* buffer = NULL;
+    long file_size = 0;
+    
+    /* 打开文件 */
+    file = fopen(filename, "rb");
+    if (!file)
     {
-        return 0xFFFFFFFF;
+        return MO_ERROR_FILE_NOT_FOUND;
     }
     
-    uint32_t index = hash & ctx->hash_table_mask;
-    uint32_t start_index = index;
+    /* 获取文件大小 */
+    if (fseek(file, 0, SEEK_END) != 0 || (file_size = ftell(file)) < 0 ||
+        fseek(file, 0, SEEK_SET) != 0)
+    {
+        result = MO_ERROR_IO;
+        goto cleanup;
+    }
     
-    /* 开放寻址查找 */
-    while (1)
+    /* 分配内存并读取文件（过短的MO文件由解析时的头部检查拒绝，空的.po文件是合法的） */
+    buffer = (uint8_t*)malloc(file_size > 0 ? (size_t)file_size : 1);
+    if (!buffer)
     {
-        mo_hash_slot_t* slot = &ctx->hash_table[index];
-        
-        if (slot->state == MO_HASH_SLOT_EMPTY)
-        {
-            /* 找到空槽位，说明字符串不存在 */
-            return 0xFFFFFFFF;
-        }
-        
-        if (slot->state == MO_HASH_SLOT_OCCUPIED)
-        {
-            /* 检查哈希值是否匹配（快速过滤） */
-            if (slot->hash == hash)
-            {
-                /* 哈希值匹配，进一步检查字符串内容 */
-                if (slot->original_len == len && 
-                    memcmp(slot->original, str, len) == 0)
-                {
-                    return index; /* 返回哈希表索引 */
-                }
-            }
-            
-            /* 记录哈希冲突 */
-            #ifdef MO_ENABLE_STATS
-            if (ctx->hash_table_count < ctx->hash_table_size)
-            {
-                ((mo_context_t*)ctx)->stats.hash_collisions++;
-            }
-            #endif
-        }
-        
-        /* 线性探测下一个槽位 */
-        index = (index + 1) & ctx->hash_table_mask;
-        
-        /* 如果回到起点，说明表已满且未找到 */
-        if (index == start_index)
-        {
-            return 0xFFFFFFFF;
-        }
+        result = MO_ERROR_MEMORY;
+        goto cleanup;
+    }
+    
+    if (fread(buffer, 1, (size_t)file_size, file) != (size_t)file_size)
+    {
+        result = MO_ERROR_IO;
+        goto cleanup;
     }
+    
+    *data = buffer;
+    *size = (size_t)file_size;
+    buffer = NULL;
+    
+cleanup:
+    fclose(file);
+    free(buffer);
+    return result;
 }
-#endif
 
 /**
  * @brief 从文件加载MO文件
  */
 mo_error_t mo_context_create(const char* filename, mo_context_t** context)
+{
+    return mo_context_create_ex(filename, NULL, context);
+}
+
+/**
+ * @brief 加载文件并建立索引，创建和重载共用
+ * 
+ * @param po 文件是.po文本，映射或读入后先编译为MO数据
+ */
+static mo_error_t mo_context_load(const char* filename, const mo_options_t* options,
+                                  bool po, mo_context_t** context)
 {
     mo_error_t result = MO_SUCCESS;
     mo_context_t* ctx = NULL;
-    FILE* file = NULL;
+    const uint8_t* mapped = NULL;
     uint8_t* data = NULL;
     size_t file_size = 0;
     
-    /* 参数检查 */
-    if (!filename || !context)
-    {
-        return MO_ERROR_INVALID_CONTEXT;
-    }
-    
     /* 分配上下文结构 */
     ctx = (mo_context_t*)calloc(1, sizeof(mo_context_t));
     if (!ctx)
     {
-        result = MO_ERROR_MEMORY;
-        goto cleanup;
+        return MO_ERROR_MEMORY;
     }
     
-    /* 打开文件 */
-    file = fopen(filename, "rb");
-    if (!file)
+    /* 优先使用只读映射，多个进程可共享同一份页缓存 */
+    if (mo_map_file(filename, &mapped, &file_size, &result))
     {
-        result = MO_ERROR_FILE_NOT_FOUND;
-        goto cleanup;
+        ctx->data = mapped;
+        ctx->size = file_size;
+        ctx->is_mapped = true;
     }
-    
-    /* 获取文件大小 */
-    fseek(file, 0, SEEK_END);
-    file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    
-    if (file_size < sizeof(mo_header_t))
+    else if (result == MO_ERROR_FILE_NOT_FOUND)
     {
-        result = MO_ERROR_INVALID_FORMAT;
         goto cleanup;
     }
-    
-    /* 分配内存并读取文件 */
-    data = (uint8_t*)malloc(file_size);
-    if (!data)
+    else
     {
-        result = MO_ERROR_MEMORY;
-        goto cleanup;
+        result = mo_read_file(filename, &data, &file_size);
+        if (result != MO_SUCCESS)
+        {
+            goto cleanup;
+        }
+        
+        ctx->data = data;
+        ctx->size = file_size;
+        ctx->is_mapped = false;
     }
     
-    if (fread(data, 1, file_size, file) != file_size)
+    if (po)
     {
-        result = MO_ERROR_IO;
-        goto cleanup;
+        result = mo_context_compile_po(ctx);
+        if (result != MO_SUCCESS)
+        {
+            goto cleanup;
+        }
     }
     
-    /* 初始化上下文 */
-    ctx->data = data;
-    ctx->size = file_size;
-    ctx->is_mapped = false;
-    
     /* 解析MO文件 */
-    result = mo_context_create_from_memory(data, file_size, &ctx);
+    result = mo_context_parse(ctx, options);
     if (result != MO_SUCCESS)
     {
         goto cleanup;
     }
     
-    /* 转移数据所有权 */
-    data = NULL;
     *context = ctx;
-    ctx = NULL;
+    return MO_SUCCESS;
     
 cleanup:
-    if (file)
+    mo_context_free(ctx);
+    return result;
+}
+
+/**
+ * @brief 把上下文中的.po文本替换为编译出的MO数据
+ * 
+ * @note 失败时保留原文本，由mo_context_free释放。
+ */
+static mo_error_t mo_context_compile_po(mo_context_t* ctx)
+{
+    uint8_t* image = NULL;
+    size_t image_size = 0;
+    mo_error_t result;
+    
+    result = mo_po_compile(ctx, (const char*)ctx->data, ctx->size, &image, &image_size);
+    if (result != MO_SUCCESS)
     {
-        fclose(file);
+        return result;
     }
     
-    if (data)
+    if (ctx->is_mapped)
     {
-        free(data);
+        mo_unmap_file(ctx->data, ctx->size);
     }
-    
-    if (ctx)
+    else
     {
-        mo_context_free(ctx);
+        free((void*)ctx->data);
     }
-    
-    return result;
+    ctx->data = image;
+    ctx->size = image_size;
+    ctx->is_mapped = false;
+    return MO_SUCCESS;
 }
 
 /**
- * @brief 从内存数据创建MO解析器
+ * @brief 从文件加载MO文件（带创建选项）
  */
-mo_error_t mo_context_create_from_memory(const uint8_t* data, size_t size, 
-                                        mo_context_t** context)
+mo_error_t mo_context_create_ex(const char* filename, const mo_options_t* options,
+                                mo_context_t** context)
+{
+    return mo_context_open(filename, options, false, context);
+}
+
+/**
+ * @brief 直接加载.po文件
+ */
+mo_error_t mo_context_create_from_po(const char* filename, const mo_options_t* options,
+                                     mo_context_t** context)
+{
+    return mo_context_open(filename, options, true, context);
+}
+
+/**
+ * @brief 加载文件并记录路径和选项，MO文件和.po文件共用
+ */
+static mo_error_t mo_context_open(const char* filename, const mo_options_t* options,
+                                  bool po, mo_context_t** context)
 {
     mo_error_t result = MO_SUCCESS;
     mo_context_t* ctx = NULL;
-    mo_header_t* header = NULL;
-    bool need_swap = false;
-    uint32_t i;
+    size_t len;
     
     /* 参数检查 */
-    if (!data || size < sizeof(mo_header_t) || !context)
+    if (!filename || !context)
     {
         return MO_ERROR_INVALID_CONTEXT;
     }
     
-    /* 分配上下文结构 */
-    ctx = (mo_context_t*)calloc(1, sizeof(mo_context_t));
-    if (!ctx)
+    result = mo_context_load(filename, options, po, &ctx);
+    if (result != MO_SUCCESS)
     {
-        result = MO_ERROR_MEMORY;
-        goto cleanup;
+        return result;
     }
     
-    #ifdef MO_ENABLE_STATS
-    /* 初始化统计信息 */
-    memset(&ctx->stats, 0, sizeof(mo_stats_t));
-    #endif
-    
-    /* 复制数据 */
-    ctx->data = (uint8_t*)malloc(size);
-    if (!ctx->data)
+    /* 记录路径和选项，供mo_context_reload重新加载 */
+    len = strlen(filename);
+    ctx->filename = (char*)malloc(len + 1);
+    if (!ctx->filename)
     {
-        result = MO_ERROR_MEMORY;
-        goto cleanup;
+        mo_context_free(ctx);
+        return MO_ERROR_MEMORY;
     }
+    memcpy(ctx->filename, filename, len + 1);
+    ctx->from_po = po;
     
-    memcpy(ctx->data, data, size);
-    ctx->size = size;
-    ctx->is_mapped = false;
-    
-    /* 设置头部指针 */
-    header = (mo_header_t*)ctx->data;
-    ctx->header = header;
-    
-    /* 检查魔数，确定字节序 */
-    if (header->magic == MO_MAGIC)
+    if (options)
     {
-        need_swap = false;
-    }
-    else if (header->magic == MO_MAGIC_REV)
-    {
-        need_swap = true;
+        ctx->options = *options;
     }
     else
     {
-        result = MO_ERROR_INVALID_FORMAT;
-        goto cleanup;
+        mo_options_init(&ctx->options);
     }
     
-    /* 转换头部字段字节序 */
-    header->revision = mo_swap_uint32(header->revision, need_swap);
-    header->num_strings = mo_swap_uint32(header->num_strings, need_swap);
-    header->orig_table_offset = mo_swap_uint32(header->orig_table_offset, need_swap);
-    header->trans_table_offset = mo_swap_uint32(header->trans_table_offset, need_swap);
-    header->hash_table_size = mo_swap_uint32(header->hash_table_size, need_swap);
-    header->hash_table_offset = mo_swap_uint32(header->hash_table_offset, need_swap);
+    *context = ctx;
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 重新加载上下文对应的文件
+ */
+mo_error_t mo_context_reload(mo_context_t* context)
+{
+    mo_context_t* next = NULL;
+    mo_context_t* old = NULL;
+    mo_options_t options;
+    mo_error_t result;
     
-    /* 验证偏移量 */
-    if (header->orig_table_offset + header->num_strings * sizeof(mo_string_entry_t) > size ||
-        header->trans_table_offset + header->num_strings * sizeof(mo_string_entry_t) > size)
+    /* 读取区间内等待宽限期会等到自己，直接拒绝 */
+    if (!context || context->is_static || !context->filename || mo_rcu_in_read())
     {
-        result = MO_ERROR_INVALID_FORMAT;
-        goto cleanup;
+        return MO_ERROR_INVALID_CONTEXT;
     }
     
-    /* 设置字符串表指针 */
-    ctx->orig_table = (mo_string_entry_t*)(ctx->data + header->orig_table_offset);
-    ctx->trans_table = (mo_string_entry_t*)(ctx->data + header->trans_table_offset);
-    ctx->num_strings = header->num_strings;
+    /* 创建时的索引若仍在后台建立，等它发布后再替换，避免两者竞争当前目录 */
+    mo_lazy_join(context);
     
-    /* 分配字符串对数组 */
-    ctx->pairs = (mo_string_pair_t*)calloc(header->num_strings, sizeof(mo_string_pair_t));
-    if (!ctx->pairs)
+    /* 在调用线程中加载并建立索引，期间读者继续使用旧目录。重载出的目录不是句柄，
+     * 没有后台线程为它发布索引，因此总是同步建立 */
+    options = context->options;
+    options.lazy_index = false;
+    result = mo_context_load(context->filename, &options, context->from_po, &next);
+    if (result != MO_SUCCESS)
     {
-        result = MO_ERROR_MEMORY;
-        goto cleanup;
+        mo_log(context, "Reload of %s failed: %s", context->filename, mo_error_string(result));
+        return result;
     }
     
-    /* 初始化字符串对 */
-    for (i = 0; i < header->num_strings; i++)
+    /* 一次原子替换发布新目录，之后进入读取区间的读者只会看到新目录 */
+    uint32_t generation = mo_context_generation(next);
+    old = atomic_exchange(&context->current, next);
+    
+    /* 句柄的代号随之改变，按代号缓存翻译结果的调用者（如I18N_T）据此失效 */
+    atomic_store(&context->generation, generation);
+    
+    /* 等待可能仍在访问旧目录的读者全部离开后再释放 */
+    mo_rcu_synchronize();
+    if (old)
     {
-        uint32_t orig_len = mo_swap_uint32(ctx->orig_table[i].length, need_swap);
-        uint32_t orig_offset = mo_swap_uint32(ctx->orig_table[i].offset, need_swap);
-        uint32_t trans_len = mo_swap_uint32(ctx->trans_table[i].length, need_swap);
-        uint32_t trans_offset = mo_swap_uint32(ctx->trans_table[i].offset, need_swap);
-        
-        /* 验证偏移量 */
-        if (orig_offset + orig_len + 1 > size || trans_offset + trans_len + 1 > size)
+        /* 后台建立的索引与句柄共用目录数据，两者一起释放 */
+        bool shared = old->shares_data;
+        mo_context_free(old);
+        if (shared)
         {
-            result = MO_ERROR_INVALID_FORMAT;
-            goto cleanup;
+            mo_context_release(context);
         }
-        
-        ctx->pairs[i].original = (const char*)(ctx->data + orig_offset);
-        ctx->pairs[i].translation = (const char*)(ctx->data + trans_offset);
-        ctx->pairs[i].original_len = orig_len;
-        ctx->pairs[i].translation_len = trans_len;
+    }
+    else
+    {
+        mo_context_release(context);
     }
     
-    /* 根据查找策略进行初始化 */
-    #ifdef MO_SEARCH_METHOD_BINARY
-    /* 二分查找：需要对数组进行排序 */
-    qsort(ctx->pairs, header->num_strings, sizeof(mo_string_pair_t), mo_compare_pairs);
-    mo_log(ctx, "Sorted %u string pairs for binary search", header->num_strings);
-    #endif
+    mo_log(context, "Reloaded %s: %u strings", context->filename, next->num_strings);
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 从内存数据创建MO解析器
+ */
+mo_error_t mo_context_create_from_memory(const uint8_t* data, size_t size, 
+                                        mo_context_t** context)
+{
+    return mo_context_create_from_memory_ex(data, size, NULL, context);
+}
+
+/**
+ * @brief 从内存数据创建MO解析器（带创建选项）
+ */
+mo_error_t mo_context_create_from_memory_ex(const uint8_t* data, size_t size,
+                                           const mo_options_t* options,
+                                           mo_context_t** context)
+{
+    mo_error_t result = MO_SUCCESS;
+    mo_context_t* ctx = NULL;
+    uint8_t* buffer = NULL;
+    
+    /* 参数检查 */
+    if (!data || size < sizeof(mo_header_t) || !context)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    /* 分配上下文结构 */
+    ctx = (mo_context_t*)calloc(1, sizeof(mo_context_t));
+    if (!ctx)
+    {
+        return MO_ERROR_MEMORY;
+    }
     
-    #ifdef MO_SEARCH_METHOD_HASH
-    /* 哈希查找：构建哈希表 */
-    if (!mo_build_hash_table(ctx))
+    /* 复制数据 */
+    buffer = (uint8_t*)malloc(size);
+    if (!buffer)
     {
         result = MO_ERROR_MEMORY;
         goto cleanup;
     }
-    #endif
     
-    /* 初始化缓存 */
-    ctx->cache_index = 0;
-    ctx->logging_enabled = g_logging_enabled;
+    memcpy(buffer, data, size);
+    ctx->data = buffer;
+    ctx->size = size;
+    ctx->is_mapped = false;
+    
+    result = mo_context_parse(ctx, options);
+    if (result != MO_SUCCESS)
+    {
+        goto cleanup;
+    }
     
-    ctx->search_method = s_search_method;
-    mo_log(ctx, "MO context created successfully: %u strings, method=%s", 
-           header->num_strings, ctx->search_method);
-
     *context = ctx;
     return MO_SUCCESS;
     
 cleanup:
-    if (ctx)
+    mo_context_free(ctx);
+    return result;
+}
+
+/**
+ * @brief 校验一份条目的偏移和长度
+ */
+static void mo_validate_entries(void* arg, uint32_t part, uint32_t parts)
+{
+    mo_validate_job_t* job = (mo_validate_job_t*)arg;
+    const mo_context_t* ctx = job->ctx;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t i;
+    
+    job->valid[part] = false;
+    job->header_index[part] = MO_INDEX_NONE;
+    job->plural_entries[part] = 0;
+    
+    mo_parallel_range(ctx->num_strings, part, parts, &begin, &end);
+    for (i = begin; i < end; i++)
     {
-        mo_context_free(ctx);
+        uint32_t orig_len = mo_swap_uint32(ctx->orig_table[i].length, ctx->need_swap);
+        uint32_t orig_offset = mo_swap_uint32(ctx->orig_table[i].offset, ctx->need_swap);
+        uint32_t trans_len = mo_swap_uint32(ctx->trans_table[i].length, ctx->need_swap);
+        uint32_t trans_offset = mo_swap_uint32(ctx->trans_table[i].offset, ctx->need_swap);
+        
+        /* 字符串必须以NUL结尾，查找时按C字符串返回并以NUL界定查找键 */
+        if ((uint64_t)orig_offset + orig_len + 1 > ctx->size || 
+            (uint64_t)trans_offset + trans_len + 1 > ctx->size ||
+            ctx->data[orig_offset + orig_len] != '\0' ||
+            ctx->data[trans_offset + trans_len] != '\0')
+        {
+            return;
+        }
+        
+        /* 复数条目的msgid为"singular\0plural"，其翻译为以NUL分隔的msgstr[0..k] */
+        if (memchr(ctx->data + orig_offset, '\0', orig_len))
+        {
+            job->plural_entries[part]++;
+        }
+        
+        if (orig_len == 0)
+        {
+            job->header_index[part] = i;
+        }
     }
     
-    return result;
+    job->valid[part] = true;
 }
 
 /**
- * @brief 释放MO解析上下文
+ * @brief 解析上下文中已加载的MO数据并建立索引
+ * 
+ * @note 文件数据始终按只读处理，字节序转换后的头部保存在上下文中。
  */
-void mo_context_free(mo_context_t* context)
+static mo_error_t mo_context_parse(mo_context_t* ctx, const mo_options_t* options)
 {
-    if (!context)
+    mo_options_t defaults;
+    mo_error_t result = MO_SUCCESS;
+    const mo_header_t* raw = (const mo_header_t*)ctx->data;
+    mo_header_t* header = &ctx->header;
+    bool need_swap = false;
+    uint32_t i;
+    
+    #ifdef MO_ENABLE_STATS
+    /* 初始化统计信息 */
+    memset(&ctx->stats, 0, sizeof(ctx->stats));
+    #endif
+    
+    if (!options)
     {
-        return;
+        mo_options_init(&defaults);
+        options = &defaults;
     }
+    ctx->logging_enabled = g_logging_enabled;
+    ctx->build_threads = options->build_threads;
     
+    if (ctx->size < sizeof(mo_header_t))
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    
+    /* 检查魔数，确定字节序 */
+    if (raw->magic == MO_MAGIC)
+    {
+        need_swap = false;
+    }
+    else if (raw->magic == MO_MAGIC_REV)
+    {
+        need_swap = true;
+    }
+    else
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    
+    /* 转换头部字段字节序 */
+    ctx->need_swap = need_swap;
+    header->magic = MO_MAGIC;
+    header->revision = mo_swap_uint32(raw->revision, need_swap);
+    header->num_strings = mo_swap_uint32(raw->num_strings, need_swap);
+    header->orig_table_offset = mo_swap_uint32(raw->orig_table_offset, need_swap);
+    header->trans_table_offset = mo_swap_uint32(raw->trans_table_offset, need_swap);
+    header->hash_table_size = mo_swap_uint32(raw->hash_table_size, need_swap);
+    header->hash_table_offset = mo_swap_uint32(raw->hash_table_offset, need_swap);
+    
+    /* 验证偏移量 */
+    if ((uint64_t)header->orig_table_offset + 
+            (uint64_t)header->num_strings * sizeof(mo_string_entry_t) > ctx->size ||
+        (uint64_t)header->trans_table_offset + 
+            (uint64_t)header->num_strings * sizeof(mo_string_entry_t) > ctx->size)
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    
+    /* 设置字符串表指针 */
+    ctx->orig_table = (const mo_string_entry_t*)(ctx->data + header->orig_table_offset);
+    ctx->trans_table = (const mo_string_entry_t*)(ctx->data + header->trans_table_offset);
+    ctx->trans_data = ctx->data;
+    ctx->num_strings = header->num_strings;
+    
+    /* 校验各条目的偏移和长度，之后的查找直接读取文件中的字符串表 */
+    mo_validate_job_t validate;
+    uint32_t parts = mo_parallel_parts(ctx, ctx->num_strings);
+    uint32_t header_index = MO_INDEX_NONE;
+    uint32_t plural_entries = 0;
+    
+    validate.ctx = ctx;
+    mo_parallel_run(parts, mo_validate_entries, &validate);
+    for (i = 0; i < parts; i++)
+    {
+        if (!validate.valid[i])
+        {
+            return MO_ERROR_INVALID_FORMAT;
+        }
+        if (validate.header_index[i] != MO_INDEX_NONE)
+        {
+            header_index = validate.header_index[i];
+        }
+        plural_entries += validate.plural_entries[i];
+    }
+    
+    /* 头部字段和Plural-Forms只在这里解析一次，头部条目本身不参与查找 */
+    const char* header_text = NULL;
+    uint32_t header_len = 0;
+    if (header_index != MO_INDEX_NONE)
+    {
+        header_text = mo_entry_translation(ctx, header_index, &header_len);
+    }
+    ctx->header_index = header_index;
+    result = mo_metadata_parse(ctx, header_text, header_len);
+    if (result != MO_SUCCESS)
+    {
+        return result;
+    }
+    mo_log(ctx, "Plural forms: nplurals=%u, %u instructions, %u plural entries",
+           ctx->plural->nplurals, ctx->plural->code_len, plural_entries);
+    
+    /* 非UTF-8目录的翻译在这里一次性转换，之后的查找直接返回转换结果 */
+    if (!options->keep_charset)
+    {
+        result = mo_charset_transcode(ctx);
+        if (result != MO_SUCCESS)
+        {
+            return result;
+        }
+    }
+    
+    /* 过滤器与查找策略无关，延迟建立索引时同样在这里同步建立，后台发布的目录共用它 */
+    if (options->bloom_filter)
+    {
+        result = mo_bloom_build(ctx);
+        if (result != MO_SUCCESS)
+        {
+            return result;
+        }
+    }
+    
+    /* 根据选项确定查找策略并建立索引 */
+    ctx->search = mo_select_search(ctx, options->search_method);
+    if (!ctx->search)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    /* 延迟建立索引：先使用内嵌哈希表或线性扫描，选定的策略交给后台线程 */
+    if (options->lazy_index && mo_index_needs_build(ctx, ctx->search))
+    {
+        const mo_search_ops_t* deferred = ctx->search;
+        
+        ctx->search = mo_gettext_usable(ctx) ? &mo_search_gettext : &mo_search_linear;
+        result = ctx->search->build(ctx);
+        if (result != MO_SUCCESS)
+        {
+            return result;
+        }
+        
+        if (mo_lazy_start(ctx, deferred) == MO_SUCCESS)
+        {
+            mo_log(ctx, "MO context created: %u strings, method=%s, building %s in background",
+                   header->num_strings, ctx->search->name, deferred->name);
+            return MO_SUCCESS;
+        }
+        
+        /* 无法创建线程时同步建立 */
+        ctx->search = deferred;
+    }
+    
+    result = ctx->search->build(ctx);
+    if (result != MO_SUCCESS)
+    {
+        return result;
+    }
+    
+    mo_log(ctx, "MO context created successfully: %u strings, method=%s, mapped=%d", 
+           header->num_strings, ctx->search->name, ctx->is_mapped);
+    
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 释放上下文自身持有的目录数据和索引（可重复调用）
+ */
+static void mo_context_release(mo_context_t* context)
+{
     #ifdef MO_ENABLE_STATS
+    mo_stats_t stats;
+    mo_copy_stats(context, &stats);
     mo_log(context, "Freeing MO context: total_lookups=%u, cache_hits=%u, cache_misses=%u", 
-           context->stats.total_lookups, context->stats.cache_hits, context->stats.cache_misses);
-    #ifdef MO_SEARCH_METHOD_HASH
-    mo_log(context, "  hash_collisions=%u", context->stats.hash_collisions);
-    #endif
-    #if defined(MO_SEARCH_METHOD_LINEAR) || defined(MO_SEARCH_METHOD_BINARY)
-    mo_log(context, "  comparisons=%u", context->stats.comparisons);
-    #endif
+           stats.total_lookups, stats.cache_hits, stats.cache_misses);
+    mo_log(context, "  hash_collisions=%u, comparisons=%u, page_hits=%u, page_misses=%u",
+           stats.hash_collisions, stats.comparisons, stats.page_hits, stats.page_misses);
+    mo_log(context, "  lookup_misses=%u, bloom_rejects=%u",
+           stats.lookup_misses, stats.bloom_rejects);
     #else
     mo_log(context, "Freeing MO context");
     #endif
     
-    if (context->data && !context->is_mapped)
+    if (context->data && !context->shares_data)
     {
-        free(context->data);
+        if (context->is_mapped)
+        {
+            mo_unmap_file(context->data, context->size);
+        }
+        else
+        {
+            free((void*)context->data);
+        }
+        context->data = NULL;
+        context->size = 0;
     }
     
-    if (context->pairs)
+    if (context->search && context->search->release)
     {
-        free(context->pairs);
+        context->search->release(context);
     }
-    
-    #ifdef MO_SEARCH_METHOD_HASH
-    if (context->hash_table)
+    context->search = NULL;
+    mo_metadata_release(context);
+    mo_bloom_release(context);
+    free(context->trans_arena);
+    context->trans_arena = NULL;
+    context->trans_arena_size = 0;
+}
+
+/**
+ * @brief 释放MO解析上下文
+ */
+void mo_context_free(mo_context_t* context)
+{
+    /* 编译进程序的目录没有任何动态分配的资源 */
+    if (!context || context->is_static)
     {
-        free(context->hash_table);
+        return;
     }
-    #endif
     
+    /* 后台线程可能正在读取句柄的目录数据，先等它结束 */
+    mo_lazy_join(context);
+    mo_context_free(atomic_load(&context->current));
+    mo_context_release(context);
+    free(context->filename);
     free(context);
 }
 
@@ -762,8 +924,7 @@ static const char* mo_get_string(const mo_context_t* ctx,
         return NULL;
     }
     
-    bool need_swap = (ctx->header->magic == MO_MAGIC_REV);
-    uint32_t offset = mo_swap_uint32(table[index].offset, need_swap);
+    uint32_t offset = mo_swap_uint32(table[index].offset, ctx->need_swap);
     
     if (offset >= ctx->size)
     {
@@ -773,94 +934,551 @@ static const char* mo_get_string(const mo_context_t* ctx,
     return (const char*)(ctx->data + offset);
 }
 
+/**
+ * @brief 读取缓存项
+ * 
+ * @return bool 命中时返回true并输出翻译；槽位正在被写入或内容不匹配时返回false
+ */
+static bool mo_cache_lookup(const mo_cache_item_t* item, const char* original,
+                            uint32_t hash, const char** translation)
+{
+    unsigned seq = atomic_load_explicit(&item->seq, memory_order_acquire);
+    if (seq & 1u)
+    {
+        return false;
+    }
+    
+    const char* cached_original = atomic_load_explicit(&item->original, memory_order_relaxed);
+    const char* cached_translation = atomic_load_explicit(&item->translation, memory_order_relaxed);
+    unsigned cached_hash = atomic_load_explicit(&item->hash, memory_order_relaxed);
+    
+    /* 确保上面的字段读取先于版本号的二次读取完成 */
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&item->seq, memory_order_relaxed) != seq)
+    {
+        return false;
+    }
+    
+    if (cached_original != original || cached_hash != hash)
+    {
+        return false;
+    }
+    
+    *translation = cached_translation;
+    return true;
+}
+
+/**
+ * @brief 写入缓存项
+ * 
+ * @note 只有抢到版本号的线程才会写入，竞争失败时直接放弃，缓存只是加速手段。
+ */
+static void mo_cache_store(mo_cache_item_t* item, const char* original,
+                           uint32_t hash, const char* translation)
+{
+    unsigned seq = atomic_load_explicit(&item->seq, memory_order_relaxed);
+    if ((seq & 1u) ||
+        !atomic_compare_exchange_strong_explicit(&item->seq, &seq, seq + 1u,
+                                                 memory_order_relaxed,
+                                                 memory_order_relaxed))
+    {
+        return;
+    }
+    
+    /* 版本号置为奇数后才写入字段 */
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&item->original, original, memory_order_relaxed);
+    atomic_store_explicit(&item->translation, translation, memory_order_relaxed);
+    atomic_store_explicit(&item->hash, hash, memory_order_relaxed);
+    atomic_store_explicit(&item->seq, seq + 2u, memory_order_release);
+}
+
+/**
+ * @brief 经过缓存查找翻译（哈希值已算出）
+ */
+static const char* mo_lookup_cached(mo_context_t* context, const char* original,
+                                    size_t original_len, uint32_t hash)
+{
+    const char* result = original;
+    uint32_t index = MO_INDEX_NONE;
+    uint32_t cache_slot;
+    
+    MO_STAT_INC(context, total_lookups);
+    
+    /* 分页读取的翻译位于会被覆盖的结果缓冲区中，不能缓存指针 */
+    if (context->paged)
+    {
+        mo_lookup_key_t key = { original, original_len, NULL, 0 };
+        uint32_t len;
+        
+        index = mo_search_find(context, &key, hash);
+        return index != MO_INDEX_NONE ? mo_entry_translation(context, index, &len) : original;
+    }
+    
+    /* 检查缓存 */
+    if (context->search->hash)
+    {
+        /* 哈希策略：使用哈希值作为缓存键的一部分 */
+        cache_slot = hash & (MO_CACHE_SIZE - 1);
+    }
+    else
+    {
+        /* 线性/二分策略：直接比较指针 */
+        cache_slot = (uintptr_t)original & (MO_CACHE_SIZE - 1);
+    }
+    
+    if (mo_cache_lookup(&context->cache[cache_slot], original, hash, &result))
+    {
+        MO_STAT_INC(context, cache_hits);
+        return result ? result : original;
+    }
+    
+    MO_STAT_INC(context, cache_misses);
+    
+    /* 使用上下文选定的查找策略进行查找，返回条目序号 */
+    mo_lookup_key_t key = { original, original_len, NULL, 0 };
+    index = mo_search_find(context, &key, hash);
+    
+    if (index != MO_INDEX_NONE)
+    {
+        uint32_t len;
+        result = mo_entry_translation(context, index, &len);
+        
+        /* 更新缓存 */
+        mo_cache_store(&context->cache[cache_slot], original, hash, result);
+    }
+    else
+    {
+        result = original;
+    }
+    
+    return result;
+}
+
 /**
  * @brief 翻译字符串（带长度参数）
  */
 const char* mo_translate_n(mo_context_t* context, 
                           const char* original, size_t original_len)
 {
-    uint32_t index = 0xFFFFFFFF;
     const char* result = original;
     
     /* 参数检查 */
-    if (!context || !context->pairs || !original)
+    if (!context || !original)
     {
         return original;
     }
     
-    #ifdef MO_ENABLE_STATS
-    context->stats.total_lookups++;
-    #endif
+    mo_read_begin();
+    mo_context_t* current = mo_context_current(context);
+    if (current->search)
+    {
+        uint32_t hash = current->search->hash ? 
+                        current->search->hash(original, original_len) : 0;
+        result = mo_lookup_cached(current, original, original_len, hash);
+    }
+    mo_read_end();
+    return result;
+}
+
+/**
+ * @brief 取得目录代号，首次调用时分配
+ *
+ * @note 代号在所有目录之间唯一（跳过0），翻译键的绑定缓存以它判断是否仍然有效。
+ *       编译进程序的目录由静态初始化为0，同样在首次使用时分配。
+ */
+static uint32_t mo_context_generation(mo_context_t* ctx)
+{
+    uint32_t generation = atomic_load_explicit(&ctx->generation, memory_order_relaxed);
+    uint32_t assigned;
     
-    /* 检查缓存 */
-    #ifdef MO_SEARCH_METHOD_HASH
-    /* 哈希表模式：使用哈希值作为缓存键的一部分 */
-    uint32_t hash = mo_hash_string(original, original_len);
-    uint32_t cache_slot = hash & (MO_CACHE_SIZE - 1);
-    if (context->cache[cache_slot].original == original &&
-        context->cache[cache_slot].hash == hash)
-    {
-        #ifdef MO_ENABLE_STATS
-        context->stats.cache_hits++;
-        #endif
-        return context->cache[cache_slot].translation ? 
-               context->cache[cache_slot].translation : original;
+    if (generation != 0)
+    {
+        return generation;
     }
-    #else
-    /* 线性/二分模式：直接比较指针 */
-    uint32_t cache_slot = (uintptr_t)original & (MO_CACHE_SIZE - 1);
-    if (context->cache[cache_slot].original == original)
+    
+    do
+    {
+        assigned = atomic_fetch_add_explicit(&g_generation, 1u, memory_order_relaxed) + 1u;
+    } while (assigned == 0);
+    
+    /* 并发分配时以先写入者为准 */
+    if (atomic_compare_exchange_strong(&ctx->generation, &generation, assigned))
     {
-        #ifdef MO_ENABLE_STATS
-        context->stats.cache_hits++;
-        #endif
-        return context->cache[cache_slot].translation ? 
-               context->cache[cache_slot].translation : original;
+        generation = assigned;
     }
-    #endif
+    return generation;
+}
+
+/**
+ * @brief 获取上下文当前目录的代号
+ */
+uint32_t mo_get_generation(const mo_context_t* context)
+{
+    /* 只读取句柄自身的字段，句柄在重载期间不会被释放，无需进入读取区间 */
+    return context ? mo_context_generation((mo_context_t*)context) : 0;
+}
+
+/**
+ * @brief 为句柄的目录数据建立索引并发布
+ *
+ * @note 新目录只复制字符串表指针、复数规则、头部字段和Bloom过滤器，与句柄共用目录
+ *       数据，条目序号也相同。目录内容没有变化，新目录沿用句柄的代号，已绑定的翻译键
+ *       和I18N_T的缓存继续有效。
+ */
+void mo_context_publish_index(mo_context_t* ctx, const mo_search_ops_t* search)
+{
+    mo_context_t* next = (mo_context_t*)calloc(1, sizeof(mo_context_t));
+    mo_error_t result;
     
-    #ifdef MO_ENABLE_STATS
-    context->stats.cache_misses++;
-    #endif
+    if (!next)
+    {
+        mo_log(ctx, "Background index build failed: %s", mo_error_string(MO_ERROR_MEMORY));
+        return;
+    }
     
-    /* 根据编译时选择的查找策略进行查找 */
-    #if defined(MO_SEARCH_METHOD_LINEAR)
-    index = mo_find_string_linear(context, original, original_len);
-    #elif defined(MO_SEARCH_METHOD_BINARY)
-    index = mo_find_string_binary(context, original, original_len);
-    #elif defined(MO_SEARCH_METHOD_HASH)
-    index = mo_find_string_hash(context, original, original_len, hash);
-    #else
-    #error "No search method defined! Use -DMO_SEARCH_METHOD_LINEAR, -DMO_SEARCH_METHOD_BINARY, or -DMO_SEARCH_METHOD_HASH"
-    #endif
+    next->data = ctx->data;
+    next->size = ctx->size;
+    next->is_mapped = ctx->is_mapped;
+    next->shares_data = true;
+    next->need_swap = ctx->need_swap;
+    next->header = ctx->header;
+    next->orig_table = ctx->orig_table;
+    next->trans_table = ctx->trans_table;
+    next->trans_data = ctx->trans_data;
+    next->num_strings = ctx->num_strings;
+    next->plural = ctx->plural;
+    next->header_index = ctx->header_index;
+    next->metadata = ctx->metadata;
+    next->bloom = ctx->bloom;
+    next->bloom_blocks = ctx->bloom_blocks;
+    next->logging_enabled = ctx->logging_enabled;
+    next->build_threads = ctx->build_threads;
+    next->search = search;
+    
+    result = search->build(next);
+    if (result != MO_SUCCESS)
+    {
+        /* 句柄继续使用当前的查找方式，查找结果不受影响 */
+        mo_log(ctx, "Background index build failed: %s", mo_error_string(result));
+        mo_context_free(next);
+        return;
+    }
+    
+    atomic_store(&next->generation, mo_context_generation(ctx));
+    atomic_store(&ctx->current, next);
+    mo_log(ctx, "Background index ready: method=%s", next->search->name);
+}
+
+/**
+ * @brief 创建翻译键
+ */
+mo_key_t mo_key_make(const char* str, size_t len)
+{
+    mo_key_t key;
+    
+    key.str = str;
+    key.len = str ? len : 0;
+    key.hash = str ? mo_hash_bytes(str, len) : 0;
+    key.binding = 0;
+    return key;
+}
+
+/* 绑定缓存按64位原子访问，32位平台上也须自然对齐 */
+_Static_assert(offsetof(mo_key_t, binding) % 8 == 0, "mo_key_t.binding must be 8-byte aligned");
+
+/**
+ * @brief 使用预先计算的键获取翻译字符串
+ */
+const char* mo_translate_key(mo_context_t* context, mo_key_t* key)
+{
+    const char* result;
+    uint64_t bound;
+    uint32_t generation;
+    uint32_t index;
     
-    if (index != 0xFFFFFFFF)
+    if (!key)
     {
-        #if defined(MO_SEARCH_METHOD_HASH)
-        /* 哈希表模式：索引指向哈希表槽位 */
-        result = context->hash_table[index].translation;
-        #else
-        /* 线性/二分模式：索引指向pairs数组 */
-        result = context->pairs[index].translation;
-        #endif
-        
-        /* 更新缓存 */
-        context->cache[cache_slot].original = original;
-        context->cache[cache_slot].translation = result;
-        #ifdef MO_SEARCH_METHOD_HASH
-        context->cache[cache_slot].hash = hash;
-        #endif
+        return NULL;
+    }
+    if (!context || !key->str)
+    {
+        return key->str;
     }
     
+    result = key->str;
+    
+    mo_read_begin();
+    mo_context_t* current = mo_context_current(context);
+    if (current->search)
+    {
+        MO_STAT_INC(current, total_lookups);
+        generation = mo_context_generation(current);
+        bound = MO_ATOMIC_LOAD_U64(&key->binding, RELAXED);
+    
+        if ((uint32_t)(bound >> 32) == generation)
+        {
+            MO_STAT_INC(current, cache_hits);
+            index = (uint32_t)bound;
+        }
+        else
+        {
+            /* 键中的哈希值与HASH/MPH策略相同，其他策略按自己的哈希函数计算 */
+            uint32_t hash = key->hash;
+            if (current->search->hash != mo_hash_bytes)
+            {
+                hash = current->search->hash ? current->search->hash(key->str, key->len) : 0;
+            }
+    
+            mo_lookup_key_t lookup = { key->str, key->len, NULL, 0 };
+            MO_STAT_INC(current, cache_misses);
+            index = mo_search_find(current, &lookup, hash);
+            MO_ATOMIC_STORE_U64(&key->binding, ((uint64_t)generation << 32) | index, RELAXED);
+        }
+    
+        if (index != MO_INDEX_NONE)
+        {
+            uint32_t len;
+            result = mo_entry_translation(current, index, &len);
+        }
+    }
+    mo_read_end();
     return result;
 }
 
+/**
+ * @brief 批量翻译字符串
+ * 
+ * @note 按MO_BATCH_GROUP个键为一组分阶段执行：先计算整组的哈希并预取起始槽位，
+ *       再逐层预取槽位指向的字符串表项和文件中的键字节，最后逐个比较。组内各键的
+ *       缓存未命中延迟在每一层相互重叠。
+ */
+size_t mo_translate_batch(mo_context_t* context, const char** keys, const size_t* lens,
+                          const char** out, size_t n)
+{
+    size_t found;
+    
+    if (!keys || !out)
+    {
+        return 0;
+    }
+    
+    mo_read_begin();
+    found = mo_do_translate_batch(context ? mo_context_current(context) : NULL,
+                                  keys, lens, out, n);
+    mo_read_end();
+    return found;
+}
+
+/**
+ * @brief 在当前生效的目录中批量查找（调用者已进入读取区间）
+ */
+static size_t mo_do_translate_batch(mo_context_t* context, const char** keys,
+                                    const size_t* lens, const char** out, size_t n)
+{
+    uint32_t hashes[MO_BATCH_GROUP];
+    size_t key_lens[MO_BATCH_GROUP];
+    size_t found = 0;
+    
+    /* 分页读取的翻译位于环形结果缓冲区中，同一批的结果会相互覆盖，不支持批量查找 */
+    if (!context || !context->search || context->paged)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            out[i] = keys[i];
+        }
+        return 0;
+    }
+    
+    const mo_search_ops_t* search = context->search;
+    
+    for (size_t base = 0; base < n; base += MO_BATCH_GROUP)
+    {
+        size_t count = n - base < MO_BATCH_GROUP ? n - base : MO_BATCH_GROUP;
+        size_t i;
+        
+        /* 阶段1：计算哈希并预取起始槽位 */
+        for (i = 0; i < count; i++)
+        {
+            const char* key = keys[base + i];
+            key_lens[i] = 0;
+            hashes[i] = 0;
+            if (!key)
+            {
+                continue;
+            }
+            
+            if (lens)
+            {
+                key_lens[i] = lens[base + i];
+                hashes[i] = search->hash ? search->hash(key, key_lens[i]) : 0;
+            }
+            else if (search->hash_cstr)
+            {
+                hashes[i] = search->hash_cstr(key, &key_lens[i]);
+            }
+            else
+            {
+                key_lens[i] = strlen(key);
+            }
+            
+            if (context->bloom && search->hash == mo_hash_bytes)
+            {
+                MO_PREFETCH(mo_bloom_block(context, hashes[i]));
+            }
+            if (search->prefetch)
+            {
+                search->prefetch(context, hashes[i], 0);
+            }
+        }
+        
+        /* 阶段2：逐层预取槽位指向的字符串表项和键字节，每层读取的是上一层已预取的数据 */
+        for (int stage = 1; search->prefetch && stage < MO_PREFETCH_STAGES; stage++)
+        {
+            for (i = 0; i < count; i++)
+            {
+                if (keys[base + i])
+                {
+                    search->prefetch(context, hashes[i], stage);
+                }
+            }
+        }
+        
+        /* 阶段3：比较并输出结果 */
+        for (i = 0; i < count; i++)
+        {
+            const char* key = keys[base + i];
+            uint32_t index = MO_INDEX_NONE;
+            
+            if (key)
+            {
+                mo_lookup_key_t lookup = { key, key_lens[i], NULL, 0 };
+                MO_STAT_INC(context, total_lookups);
+                index = mo_search_find(context, &lookup, hashes[i]);
+            }
+            
+            if (index != MO_INDEX_NONE)
+            {
+                uint32_t len;
+                out[base + i] = mo_entry_translation(context, index, &len);
+                found++;
+            }
+            else
+            {
+                out[base + i] = key;
+            }
+        }
+    }
+    
+    return found;
+}
+
 /**
  * @brief 翻译字符串
  */
 const char* mo_translate(mo_context_t* context, const char* original)
 {
-    return mo_translate_n(context, original, original ? strlen(original) : 0);
+    const char* result = original;
+    size_t len = 0;
+    uint32_t hash = 0;
+    
+    if (!context || !original)
+    {
+        return original;
+    }
+    
+    mo_read_begin();
+    mo_context_t* current = mo_context_current(context);
+    if (current->search)
+    {
+        /* 哈希策略在计算哈希的同一次遍历中求出长度，无需单独调用strlen */
+        if (current->search->hash_cstr)
+        {
+            hash = current->search->hash_cstr(original, &len);
+        }
+        else
+        {
+            len = strlen(original);
+        }
+        
+        result = mo_lookup_cached(current, original, len, hash);
+    }
+    mo_read_end();
+    return result;
+}
+
+/**
+ * @brief 不经过缓存直接查找，返回条目序号
+ * 
+ * @note 用于带上下文的查找键，这类键没有可作为缓存键的单一指针。
+ */
+static uint32_t mo_find_index(const mo_context_t* ctx, const mo_lookup_key_t* key)
+{
+    const mo_search_ops_t* search = ctx->search;
+    uint32_t hash = search->hash_key ? search->hash_key(key) : 0;
+    
+    MO_STAT_INC(ctx, total_lookups);
+    return mo_search_find(ctx, key, hash);
+}
+
+/**
+ * @brief 经Bloom过滤器调用查找策略
+ * 
+ * @note 策略的哈希函数为mo_hash_bytes时直接复用hash，否则为过滤器单独计算一次。
+ *       未启用过滤器时只多一次指针判断。
+ */
+static uint32_t mo_search_find(const mo_context_t* ctx, const mo_lookup_key_t* key,
+                               uint32_t hash)
+{
+    uint32_t index;
+    
+    if (ctx->bloom)
+    {
+        uint32_t bloom_hash = ctx->search->hash == mo_hash_bytes ? hash : mo_hash_key(key);
+        if (!mo_bloom_may_contain(ctx, bloom_hash))
+        {
+            MO_STAT_INC(ctx, bloom_rejects);
+            MO_STAT_INC(ctx, lookup_misses);
+            return MO_INDEX_NONE;
+        }
+    }
+    
+    index = ctx->search->find(ctx, key, hash);
+    if (index == MO_INDEX_NONE)
+    {
+        MO_STAT_INC(ctx, lookup_misses);
+    }
+    return index;
+}
+
+/**
+ * @brief 按Plural-Forms规则选择翻译形式
+ * 
+ * @note 不为复数条目预存各形式的偏移，查找时沿NUL分隔符跳到msgstr[form]，
+ *       只有复数查找才需要这次扫描。
+ */
+const char* mo_select_plural(const mo_context_t* ctx, uint32_t index, unsigned long n)
+{
+    uint32_t form = mo_plural_eval(ctx->plural, n);
+    uint32_t len;
+    const char* translation = mo_entry_translation(ctx, index, &len);
+    const char* end = translation + len;
+    const char* p = translation;
+    
+    while (form > 0)
+    {
+        const char* nul = (const char*)memchr(p, '\0', (size_t)(end - p));
+        
+        /* 条目缺少该形式时使用msgstr[0] */
+        if (!nul)
+        {
+            return translation;
+        }
+        p = nul + 1;
+        form--;
+    }
+    
+    return p;
 }
 
 /**
@@ -872,63 +1490,126 @@ const char* mo_translate_cp(mo_context_t* context,
                            const char* plural,
                            unsigned long n)
 {
-    char key[MO_MAX_STRING_LENGTH];
-    const char* result = singular;
-    size_t key_len;
+    const char* result;
     
     if (!context || !singular)
     {
         return singular;
     }
     
-    /* 构建带上下文的键 */
-    if (context_str)
+    mo_read_begin();
+    result = mo_do_translate_cp(mo_context_current(context), context_str, singular, plural, n);
+    mo_read_end();
+    return result;
+}
+
+/**
+ * @brief 在当前生效的目录中查找（调用者已进入读取区间）
+ */
+static const char* mo_do_translate_cp(mo_context_t* context, const char* context_str,
+                                      const char* singular, const char* plural,
+                                      unsigned long n)
+{
+    mo_lookup_key_t key;
+    uint32_t index = MO_INDEX_NONE;
+    
+    if (!context->search)
     {
-        key_len = snprintf(key, sizeof(key), "%s\004%s", context_str, singular);
+        return singular;
     }
-    else
+    
+    /* 上下文与msgid分段哈希和比较，不拼接"context\004singular"，也没有长度上限 */
+    key.str = singular;
+    key.len = strlen(singular);
+    key.context = context_str;
+    key.context_len = context_str ? strlen(context_str) : 0;
+    
+    /* 查找翻译，复数条目同样以单数形式msgid为键 */
+    index = mo_find_index(context, &key);
+    
+    /* 如果找不到带上下文的，尝试查找不带上下文的 */
+    if (index == MO_INDEX_NONE && context_str)
     {
-        key_len = snprintf(key, sizeof(key), "%s", singular);
+        key.context = NULL;
+        key.context_len = 0;
+        index = mo_find_index(context, &key);
     }
     
-    if (key_len >= sizeof(key))
+    if (index == MO_INDEX_NONE)
     {
-        return singular;
+        /* 未翻译时按英语规则返回原文 */
+        return (plural && n != 1) ? plural : singular;
     }
     
-    /* 查找翻译 */
-    result = mo_translate_n(context, key, key_len);
-    
-    /* 如果找不到带上下文的，尝试查找不带上下文的 */
-    if (result == key && context_str)
+    if (!plural)
     {
-        result = mo_translate(context, singular);
+        uint32_t len;
+        return mo_entry_translation(context, index, &len);
     }
     
     /* 处理复数形式 */
-    if (plural && n != 1)
+    return mo_select_plural(context, index, n);
+}
+
+/**
+ * @brief 枚举以指定前缀开头的条目
+ */
+size_t mo_foreach_prefix(mo_context_t* context, const char* prefix, size_t prefix_len,
+                         mo_entry_callback_t callback, void* user_data)
+{
+    mo_context_t* current;
+    size_t count = 0;
+    
+    if (!context || !callback || (!prefix && prefix_len > 0))
+    {
+        return 0;
+    }
+    if (!prefix)
+    {
+        prefix = "";
+    }
+    
+    mo_read_begin();
+    current = mo_context_current(context);
+    if (current->search && current->search->foreach_prefix)
     {
-        /* 查找复数形式翻译 */
-        const char* plural_translation = NULL;
+        count = current->search->foreach_prefix(current, prefix, prefix_len, callback, user_data);
+    }
+    else if (current->search)
+    {
+        count = mo_scan_prefix(current, prefix, prefix_len, callback, user_data);
+    }
+    mo_read_end();
+    return count;
+}
+
+/**
+ * @brief 索引无序时按文件中的顺序扫描全部条目
+ */
+static size_t mo_scan_prefix(const mo_context_t* ctx, const char* prefix, size_t prefix_len,
+                             mo_entry_callback_t callback, void* user_data)
+{
+    size_t count = 0;
+    uint32_t i;
+    
+    for (i = 0; i < ctx->num_strings; i++)
+    {
+        uint32_t len;
+        uint32_t trans_len;
+        const char* key = mo_entry_key(ctx, i, &len);
         
-        if (context_str)
+        if (len == 0 || len < prefix_len || memcmp(key, prefix, prefix_len) != 0)
         {
-            key_len = snprintf(key, sizeof(key), "%s\004%s", context_str, plural);
-            if (key_len < sizeof(key))
-            {
-                plural_translation = mo_translate_n(context, key, key_len);
-            }
+            continue;
         }
         
-        if (!plural_translation || plural_translation == key)
+        count++;
+        if (!callback(key, len, mo_entry_translation(ctx, i, &trans_len), user_data))
         {
-            plural_translation = mo_translate(context, plural);
+            break;
         }
-        
-        result = plural_translation;
     }
-    
-    return result;
+    return count;
 }
 
 /**
@@ -936,7 +1617,15 @@ const char* mo_translate_cp(mo_context_t* context,
  */
 uint32_t mo_get_string_count(const mo_context_t* context)
 {
-    return context ? context->num_strings : 0;
+    uint32_t count = 0;
+    
+    if (context)
+    {
+        mo_read_begin();
+        count = mo_context_current(context)->num_strings;
+        mo_read_end();
+    }
+    return count;
 }
 
 /**
@@ -944,13 +1633,34 @@ uint32_t mo_get_string_count(const mo_context_t* context)
  */
 bool mo_get_stats(const mo_context_t* context, mo_stats_t* stats)
 {
-    #ifdef MO_ENABLE_STATS
+    bool result;
+    
     if (!context || !stats)
     {
         return false;
     }
     
-    *stats = context->stats;
+    mo_read_begin();
+    result = mo_copy_stats(mo_context_current(context), stats);
+    mo_read_end();
+    return result;
+}
+
+/**
+ * @brief 读取指定目录的统计计数
+ */
+static bool mo_copy_stats(const mo_context_t* context, mo_stats_t* stats)
+{
+    #ifdef MO_ENABLE_STATS
+    stats->total_lookups = atomic_load_explicit(&context->stats.total_lookups, memory_order_relaxed);
+    stats->cache_hits = atomic_load_explicit(&context->stats.cache_hits, memory_order_relaxed);
+    stats->cache_misses = atomic_load_explicit(&context->stats.cache_misses, memory_order_relaxed);
+    stats->hash_collisions = atomic_load_explicit(&context->stats.hash_collisions, memory_order_relaxed);
+    stats->comparisons = atomic_load_explicit(&context->stats.comparisons, memory_order_relaxed);
+    stats->page_hits = atomic_load_explicit(&context->stats.page_hits, memory_order_relaxed);
+    stats->page_misses = atomic_load_explicit(&context->stats.page_misses, memory_order_relaxed);
+    stats->lookup_misses = atomic_load_explicit(&context->stats.lookup_misses, memory_order_relaxed);
+    stats->bloom_rejects = atomic_load_explicit(&context->stats.bloom_rejects, memory_order_relaxed);
     return true;
     #else
     (void)context;
@@ -959,6 +1669,38 @@ bool mo_get_stats(const mo_context_t* context, mo_stats_t* stats)
     #endif
 }
 
+/**
+ * @brief 获取内存占用明细
+ */
+bool mo_get_memory_usage(const mo_context_t* context, mo_memory_usage_t* usage)
+{
+    if (!context || !usage)
+    {
+        return false;
+    }
+    
+    mo_read_begin();
+    context = mo_context_current(context);
+    memset(usage, 0, sizeof(mo_memory_usage_t));
+    usage->context_bytes = sizeof(mo_context_t) + context->metadata_size;
+    usage->data_bytes = context->size + context->trans_arena_size;
+    usage->data_on_heap = !context->is_mapped && !context->is_static;
+    if (context->search && context->search->memory)
+    {
+        usage->index_bytes = context->search->memory(context);
+    }
+    usage->index_bytes += (size_t)context->bloom_blocks * MO_BLOOM_WORDS * sizeof(uint64_t);
+    
+    /* 静态目录的上下文和数据都不在堆上 */
+    if (!context->is_static)
+    {
+        usage->heap_bytes = usage->context_bytes + usage->index_bytes +
+                            (usage->data_on_heap ? context->size : 0) + context->trans_arena_size;
+    }
+    mo_read_end();
+    return true;
+}
+
 /**
  * @brief 启用/禁用日志
  */
@@ -972,5 +1714,17 @@ void mo_enable_logging(bool enable)
  */
 const char* mo_get_search_method(const mo_context_t* context)
 {
-    return context ? context->search_method : "INVALID_CONTEXT";
+    const char* name = "INVALID_CONTEXT";
+    
+    if (context)
+    {
+        mo_read_begin();
+        const mo_search_ops_t* search = mo_context_current(context)->search;
+        if (search)
+        {
+            name = search->name;
+        }
+        mo_read_end();
+    }
+    return name;
 }
@@ -0,0 +1,500 @@
+/**
+ * @file mo_plural.c
+ * @brief Plural-Forms表达式编译与求值
+ *
+ * 加载时将目录头部的plural=表达式编译为后缀字节码，求值时只使用栈上的
+ * 固定大小数组，不分配内存。
+ */
+
+#include "mo_internal.h"
+#include <string.h>
+
+/* 字节码操作码 */
+enum {
+    MO_PLURAL_OP_N = 0,     /**< 压入n */
+    MO_PLURAL_OP_CONST,     /**< 压入常量arg */
+    MO_PLURAL_OP_NOT,
+    MO_PLURAL_OP_MUL,
+    MO_PLURAL_OP_DIV,
+    MO_PLURAL_OP_MOD,
+    MO_PLURAL_OP_ADD,
+    MO_PLURAL_OP_SUB,
+    MO_PLURAL_OP_LT,
+    MO_PLURAL_OP_GT,
+    MO_PLURAL_OP_LE,
+    MO_PLURAL_OP_GE,
+    MO_PLURAL_OP_EQ,
+    MO_PLURAL_OP_NE,
+    MO_PLURAL_OP_AND,
+    MO_PLURAL_OP_OR,
+    MO_PLURAL_OP_JZ,        /**< 弹出栈顶，为0时跳转到arg */
+    MO_PLURAL_OP_JMP        /**< 无条件跳转到arg */
+};
+
+/* 编译器状态 */
+typedef struct {
+    const char* pos;
+    const char* end;
+    mo_plural_expr_t* expr;
+    uint32_t depth;         /**< 当前模拟栈深度 */
+    uint32_t nesting;       /**< 当前括号和'!'的嵌套层数，限制解析的递归深度 */
+    bool error;
+} mo_plural_compiler_t;
+
+static void mo_plural_ternary(mo_plural_compiler_t* c);
+
+/**
+ * @brief 跳过空白字符
+ */
+static void mo_plural_skip_space(mo_plural_compiler_t* c)
+{
+    while (c->pos < c->end && (*c->pos == ' ' || *c->pos == '\t' ||
+                               *c->pos == '\r' || *c->pos == '\n'))
+    {
+        c->pos++;
+    }
+}
+
+/**
+ * @brief 尝试匹配一个运算符
+ */
+static bool mo_plural_accept(mo_plural_compiler_t* c, const char* token)
+{
+    size_t len = strlen(token);
+
+    mo_plural_skip_space(c);
+    if ((size_t)(c->end - c->pos) < len || memcmp(c->pos, token, len) != 0)
+    {
+        return false;
+    }
+
+    /* 避免把"<="识别为"<"、把"!="识别为"!" */
+    if (len == 1 && c->pos + 1 < c->end && c->pos[1] == '=' &&
+        (token[0] == '<' || token[0] == '>' || token[0] == '!' || token[0] == '='))
+    {
+        return false;
+    }
+
+    c->pos += len;
+    return true;
+}
+
+/**
+ * @brief 追加一条指令并更新模拟栈深度
+ *
+ * @return uint32_t 指令位置，供跳转回填使用
+ */
+static uint32_t mo_plural_emit(mo_plural_compiler_t* c, uint8_t op, uint32_t arg, int stack_delta)
+{
+    mo_plural_expr_t* expr = c->expr;
+
+    if (c->error || expr->code_len >= MO_PLURAL_MAX_CODE)
+    {
+        c->error = true;
+        return 0;
+    }
+
+    expr->code[expr->code_len].op = op;
+    expr->code[expr->code_len].arg = arg;
+
+    c->depth = (uint32_t)((int)c->depth + stack_delta);
+    if (c->depth > MO_PLURAL_MAX_STACK)
+    {
+        c->error = true;
+    }
+
+    return expr->code_len++;
+}
+
+/**
+ * @brief 进入一层括号或'!'
+ *
+ * @note 解析每遇到一个'('或'!'递归一次，字节码和栈深度的限制在递归返回后才检查，
+ *       因此嵌套层数单独限制，异常的头部不会耗尽调用栈。
+ */
+static bool mo_plural_enter(mo_plural_compiler_t* c)
+{
+    if (c->error || ++c->nesting > MO_PLURAL_MAX_STACK)
+    {
+        c->error = true;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief primary := 'n' | number | '(' ternary ')'
+ */
+static void mo_plural_primary(mo_plural_compiler_t* c)
+{
+    if (c->error)
+    {
+        return;
+    }
+
+    mo_plural_skip_space(c);
+    if (c->pos >= c->end)
+    {
+        c->error = true;
+        return;
+    }
+
+    if (*c->pos == 'n')
+    {
+        c->pos++;
+        mo_plural_emit(c, MO_PLURAL_OP_N, 0, 1);
+    }
+    else if (*c->pos >= '0' && *c->pos <= '9')
+    {
+        uint32_t value = 0;
+        while (c->pos < c->end && *c->pos >= '0' && *c->pos <= '9')
+        {
+            value = value * 10 + (uint32_t)(*c->pos - '0');
+            c->pos++;
+        }
+        mo_plural_emit(c, MO_PLURAL_OP_CONST, value, 1);
+    }
+    else if (*c->pos == '(')
+    {
+        c->pos++;
+        if (!mo_plural_enter(c))
+        {
+            return;
+        }
+        mo_plural_ternary(c);
+        c->nesting--;
+        if (!mo_plural_accept(c, ")"))
+        {
+            c->error = true;
+        }
+    }
+    else
+    {
+        c->error = true;
+    }
+}
+
+/**
+ * @brief unary := '!' unary | primary
+ */
+static void mo_plural_unary(mo_plural_compiler_t* c)
+{
+    if (c->error)
+    {
+        return;
+    }
+
+    if (mo_plural_accept(c, "!"))
+    {
+        if (!mo_plural_enter(c))
+        {
+            return;
+        }
+        mo_plural_unary(c);
+        c->nesting--;
+        mo_plural_emit(c, MO_PLURAL_OP_NOT, 0, 0);
+    }
+    else
+    {
+        mo_plural_primary(c);
+    }
+}
+
+/* 二元运算符优先级表，同一级别内左结合 */
+typedef struct {
+    const char* token;
+    uint8_t op;
+} mo_plural_binop_t;
+
+static const mo_plural_binop_t s_mul_ops[] = {
+    { "*", MO_PLURAL_OP_MUL }, { "/", MO_PLURAL_OP_DIV }, { "%", MO_PLURAL_OP_MOD }, { NULL, 0 }
+};
+static const mo_plural_binop_t s_add_ops[] = {
+    { "+", MO_PLURAL_OP_ADD }, { "-", MO_PLURAL_OP_SUB }, { NULL, 0 }
+};
+static const mo_plural_binop_t s_rel_ops[] = {
+    { "<=", MO_PLURAL_OP_LE }, { ">=", MO_PLURAL_OP_GE },
+    { "<", MO_PLURAL_OP_LT }, { ">", MO_PLURAL_OP_GT }, { NULL, 0 }
+};
+static const mo_plural_binop_t s_eq_ops[] = {
+    { "==", MO_PLURAL_OP_EQ }, { "!=", MO_PLURAL_OP_NE }, { NULL, 0 }
+};
+static const mo_plural_binop_t s_and_ops[] = {
+    { "&&", MO_PLURAL_OP_AND }, { NULL, 0 }
+};
+static const mo_plural_binop_t s_or_ops[] = {
+    { "||", MO_PLURAL_OP_OR }, { NULL, 0 }
+};
+
+/* 各优先级从高到低排列 */
+static const mo_plural_binop_t* const s_binop_levels[] = {
+    s_mul_ops, s_add_ops, s_rel_ops, s_eq_ops, s_and_ops, s_or_ops
+};
+
+#define MO_PLURAL_BINOP_LEVELS (sizeof(s_binop_levels) / sizeof(s_binop_levels[0]))
+
+/**
+ * @brief 按优先级解析二元表达式
+ */
+static void mo_plural_binary(mo_plural_compiler_t* c, size_t level)
+{
+    if (level == 0)
+    {
+        mo_plural_unary(c);
+    }
+    else
+    {
+        mo_plural_binary(c, level - 1);
+    }
+
+    while (!c->error)
+    {
+        const mo_plural_binop_t* ops = s_binop_levels[level];
+        const mo_plural_binop_t* matched = NULL;
+
+        for (; ops->token; ops++)
+        {
+            if (mo_plural_accept(c, ops->token))
+            {
+                matched = ops;
+                break;
+            }
+        }
+
+        if (!matched)
+        {
+            break;
+        }
+
+        if (level == 0)
+        {
+            mo_plural_unary(c);
+        }
+        else
+        {
+            mo_plural_binary(c, level - 1);
+        }
+        mo_plural_emit(c, matched->op, 0, -1);
+    }
+}
+
+/**
+ * @brief ternary := or ['?' ternary ':' ternary]
+ */
+static void mo_plural_ternary(mo_plural_compiler_t* c)
+{
+    if (c->error)
+    {
+        return;
+    }
+
+    mo_plural_binary(c, MO_PLURAL_BINOP_LEVELS - 1);
+
+    if (!c->error && mo_plural_accept(c, "?"))
+    {
+        uint32_t jz = mo_plural_emit(c, MO_PLURAL_OP_JZ, 0, -1);
+        uint32_t depth = c->depth;
+
+        mo_plural_ternary(c);
+        uint32_t jmp = mo_plural_emit(c, MO_PLURAL_OP_JMP, 0, 0);
+
+        if (!mo_plural_accept(c, ":"))
+        {
+            c->error = true;
+            return;
+        }
+
+        /* 两个分支从相同的栈深度开始 */
+        c->depth = depth;
+        c->expr->code[jz].arg = c->expr->code_len;
+        mo_plural_ternary(c);
+        c->expr->code[jmp].arg = c->expr->code_len;
+    }
+}
+
+/**
+ * @brief 编译plural表达式
+ */
+bool mo_plural_compile(const char* expr_str, size_t len, uint32_t nplurals,
+                       mo_plural_expr_t* expr)
+{
+    mo_plural_compiler_t c;
+
+    memset(expr, 0, sizeof(mo_plural_expr_t));
+    c.pos = expr_str;
+    c.end = expr_str + len;
+    c.expr = expr;
+    c.depth = 0;
+    c.nesting = 0;
+    c.error = false;
+
+    mo_plural_ternary(&c);
+    mo_plural_skip_space(&c);
+
+    if (c.error || c.pos != c.end || c.depth != 1 || nplurals == 0)
+    {
+        memset(expr, 0, sizeof(mo_plural_expr_t));
+        return false;
+    }
+
+    expr->nplurals = nplurals;
+    return true;
+}
+
+/**
+ * @brief 对n求值，返回翻译形式索引
+ */
+uint32_t mo_plural_eval(const mo_plural_expr_t* expr, unsigned long n)
+{
+    unsigned long stack[MO_PLURAL_MAX_STACK];
+    uint32_t sp = 0;
+    uint32_t pc = 0;
+
+    if (expr->code_len == 0)
+    {
+        /* 无表达式时按日耳曼语系规则处理 */
+        return n != 1 ? 1 : 0;
+    }
+
+    while (pc < expr->code_len)
+    {
+        const mo_plural_op_t* ins = &expr->code[pc++];
+        unsigned long rhs;
+
+        switch (ins->op)
+        {
+            case MO_PLURAL_OP_N:
+                stack[sp++] = n;
+                continue;
+            case MO_PLURAL_OP_CONST:
+                stack[sp++] = ins->arg;
+                continue;
+            case MO_PLURAL_OP_NOT:
+                stack[sp - 1] = !stack[sp - 1];
+                continue;
+            case MO_PLURAL_OP_JZ:
+                if (stack[--sp] == 0)
+                {
+                    pc = ins->arg;
+                }
+                continue;
+            case MO_PLURAL_OP_JMP:
+                pc = ins->arg;
+                continue;
+            default:
+                break;
+        }
+
+        /* 其余均为二元运算 */
+        rhs = stack[--sp];
+        unsigned long* lhs = &stack[sp - 1];
+        switch (ins->op)
+        {
+            case MO_PLURAL_OP_MUL: *lhs = *lhs * rhs; break;
+            case MO_PLURAL_OP_DIV: *lhs = rhs ? *lhs / rhs : 0; break;
+            case MO_PLURAL_OP_MOD: *lhs = rhs ? *lhs % rhs : 0; break;
+            case MO_PLURAL_OP_ADD: *lhs = *lhs + rhs; break;
+            case MO_PLURAL_OP_SUB: *lhs = *lhs - rhs; break;
+            case MO_PLURAL_OP_LT:  *lhs = *lhs < rhs; break;
+            case MO_PLURAL_OP_GT:  *lhs = *lhs > rhs; break;
+            case MO_PLURAL_OP_LE:  *lhs = *lhs <= rhs; break;
+            case MO_PLURAL_OP_GE:  *lhs = *lhs >= rhs; break;
+            case MO_PLURAL_OP_EQ:  *lhs = *lhs == rhs; break;
+            case MO_PLURAL_OP_NE:  *lhs = *lhs != rhs; break;
+            case MO_PLURAL_OP_AND: *lhs = *lhs && rhs; break;
+            case MO_PLURAL_OP_OR:  *lhs = *lhs || rhs; break;
+            default: break;
+        }
+    }
+
+    unsigned long form = stack[0];
+    return form < expr->nplurals ? (uint32_t)form : 0;
+}
+
+/**
+ * @brief 在头部条目中查找指定字段的值
+ *
+ * @return const char* 字段值起始位置（跳过"Name:"），不存在时返回NULL；
+ *         value_len输出到行尾的长度
+ */
+static const char* mo_header_field(const char* header, size_t header_len,
+                                   const char* name, size_t* value_len)
+{
+    size_t name_len = strlen(name);
+    const char* line = header;
+    const char* end = header + header_len;
+
+    while (line < end)
+    {
+        const char* eol = memchr(line, '\n', (size_t)(end - line));
+        if (!eol)
+        {
+            eol = end;
+        }
+
+        if ((size_t)(eol - line) >= name_len && memcmp(line, name, name_len) == 0)
+        {
+            *value_len = (size_t)(eol - line) - name_len;
+            return line + name_len;
+        }
+
+        line = eol + 1;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief 从目录头部解析Plural-Forms
+ *
+ * @note 格式为"Plural-Forms: nplurals=N; plural=EXPR;"。
+ */
+bool mo_plural_parse_header(const char* header, size_t header_len, mo_plural_expr_t* expr)
+{
+    size_t len = 0;
+    const char* value = mo_header_field(header, header_len, "Plural-Forms:", &len);
+    const char* end;
+    const char* p;
+    uint32_t nplurals = 0;
+
+    if (!value)
+    {
+        return false;
+    }
+    end = value + len;
+
+    /* nplurals=N */
+    for (p = value; p + 9 <= end && memcmp(p, "nplurals=", 9) != 0; p++)
+    {
+    }
+    if (p + 9 > end)
+    {
+        return false;
+    }
+    for (p += 9; p < end && *p == ' '; p++)
+    {
+    }
+    while (p < end && *p >= '0' && *p <= '9')
+    {
+        nplurals = nplurals * 10 + (uint32_t)(*p - '0');
+        p++;
+    }
+
+    /* plural=EXPR，表达式以';'或行尾结束 */
+    for (p = value; p + 7 <= end && memcmp(p, "plural=", 7) != 0; p++)
+    {
+    }
+    if (p + 7 > end)
+    {
+        return false;
+    }
+    p += 7;
+
+    const char* expr_end = memchr(p, ';', (size_t)(end - p));
+    if (!expr_end)
+    {
+        expr_end = end;
+    }
+
+    return mo_plural_compile(p, (size_t)(expr_end - p), nplurals, expr);
+}
@@ -0,0 +1,518 @@
+/**
+ * @file mo_po.c
+ * @brief 直接加载.po文件 - 单遍解析为内存中的MO数据
+ *
+ * 逐行扫描.po文本，字符串去掉引号、解开转义后直接写入一块输出缓冲区，各字段的
+ * 排列方式与MO文件中的字符串相同（"msgctxt\004msgid\0msgid_plural"与以NUL分隔的
+ * msgstr[n]）。解析结束后按原文排序条目，在缓冲区末尾追加原文/翻译字符串表并
+ * 填写头部，得到的数据与msgfmt生成的MO文件（不含哈希表）等价，之后与.mo文件走
+ * 同一条加载路径：校验、头部元数据、字符集转换和建立索引。
+ *
+ * 与msgfmt相同，标记为fuzzy的条目（头部除外）和msgstr为空的条目不会加入目录，
+ * 注释（包括#~开头的废弃条目）全部忽略。
+ */
+
+#include "mo_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* 当前正在读取的字段 */
+typedef enum {
+    MO_PO_NONE,                 /**< 条目之间 */
+    MO_PO_MSGCTXT,
+    MO_PO_MSGID,
+    MO_PO_MSGID_PLURAL,
+    MO_PO_MSGSTR,
+} mo_po_field_t;
+
+/* 已完成的条目，偏移相对于输出缓冲区 */
+typedef struct {
+    const char* original;       /**< 排序时使用的原文指针 */
+    uint32_t orig_offset;
+    uint32_t orig_len;
+    uint32_t trans_offset;
+    uint32_t trans_len;
+} mo_po_entry_t;
+
+/* 解析状态 */
+typedef struct {
+    const mo_context_t* ctx;    /**< 仅用于日志 */
+    uint8_t* out;               /**< 输出缓冲区，前部预留MO头部 */
+    size_t pos;                 /**< 已写入的字节数 */
+    mo_po_entry_t* entries;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t line;              /**< 当前行号，用于错误日志 */
+
+    /* 当前条目 */
+    mo_po_field_t field;
+    size_t entry_start;         /**< 原文在输出缓冲区中的起始位置 */
+    size_t trans_start;         /**< 翻译的起始位置 */
+    uint32_t next_form;         /**< 下一个msgstr[n]应有的n */
+    bool fuzzy;                 /**< 条目之前的#,注释中带有fuzzy标记 */
+} mo_po_parser_t;
+
+static bool mo_po_keyword(const char** p, const char* end, const char* keyword, size_t len);
+static mo_error_t mo_po_string(mo_po_parser_t* parser, const char** p, const char* end);
+static mo_error_t mo_po_finish_entry(mo_po_parser_t* parser);
+static mo_error_t mo_po_begin_field(mo_po_parser_t* parser, const char** p, const char* end);
+static bool mo_po_has_fuzzy(const char* line, const char* eol);
+static int mo_po_compare(const void* a, const void* b);
+static mo_error_t mo_po_build_image(mo_po_parser_t* parser, uint8_t** image, size_t* image_size);
+
+/**
+ * @brief 若*p处是keyword且其后为空白或'['，跳过关键字并返回true
+ */
+static bool mo_po_keyword(const char** p, const char* end, const char* keyword, size_t len)
+{
+    if ((size_t)(end - *p) < len || memcmp(*p, keyword, len) != 0)
+    {
+        return false;
+    }
+    if (*p + len < end && (*p)[len] != ' ' && (*p)[len] != '\t' &&
+        (*p)[len] != '"' && (*p)[len] != '[')
+    {
+        return false;
+    }
+    *p += len;
+    return true;
+}
+
+/**
+ * @brief 读取一个带引号的字符串，解开转义后追加到输出缓冲区
+ *
+ * @note 字符串之后只允许空白，*p停在行尾。
+ */
+static mo_error_t mo_po_string(mo_po_parser_t* parser, const char** p, const char* end)
+{
+    const char* s = *p;
+    uint8_t* out = parser->out + parser->pos;
+    
+    while (s < end && (*s == ' ' || *s == '\t'))
+    {
+        s++;
+    }
+    if (s >= end || *s != '"')
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    s++;
+    
+    for (;;)
+    {
+        /* 普通字符直接复制，只有引号、反斜杠和换行需要处理 */
+        while (s < end && *s != '"' && *s != '\\' && *s != '\n')
+        {
+            *out++ = (uint8_t)*s++;
+        }
+        if (s >= end || *s == '\n')
+        {
+            return MO_ERROR_INVALID_FORMAT;
+        }
+        if (*s == '"')
+        {
+            s++;
+            break;
+        }
+    
+        /* 转义序列 */
+        if (++s >= end)
+        {
+            return MO_ERROR_INVALID_FORMAT;
+        }
+        switch (*s)
+        {
+            case 'n':  *out++ = '\n'; s++; break;
+            case 't':  *out++ = '\t'; s++; break;
+            case 'r':  *out++ = '\r'; s++; break;
+            case 'a':  *out++ = '\a'; s++; break;
+            case 'b':  *out++ = '\b'; s++; break;
+            case 'f':  *out++ = '\f'; s++; break;
+            case 'v':  *out++ = '\v'; s++; break;
+            case '\\': *out++ = '\\'; s++; break;
+            case '"':  *out++ = '"';  s++; break;
+            case '\'': *out++ = '\''; s++; break;
+            case '?':  *out++ = '?';  s++; break;
+            case 'x':
+            {
+                unsigned value = 0;
+                int digits = 0;
+                for (s++; s < end && digits < 2; s++, digits++)
+                {
+                    char c = *s;
+                    if (c >= '0' && c <= '9')
+                    {
+                        value = value * 16 + (unsigned)(c - '0');
+                    }
+                    else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+                    {
+                        value = value * 16 + (unsigned)((c | 0x20) - 'a' + 10);
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+                if (digits == 0)
+                {
+                    return MO_ERROR_INVALID_FORMAT;
+                }
+                *out++ = (uint8_t)value;
+                break;
+            }
+            default:
+            {
+                unsigned value = 0;
+                int digits = 0;
+                for (; s < end && digits < 3 && *s >= '0' && *s <= '7'; s++, digits++)
+                {
+                    value = value * 8 + (unsigned)(*s - '0');
+                }
+                if (digits == 0)
+                {
+                    return MO_ERROR_INVALID_FORMAT;
+                }
+                *out++ = (uint8_t)value;
+                break;
+            }
+        }
+    }
+    
+    while (s < end && (*s == ' ' || *s == '\t' || *s == '\r'))
+    {
+        s++;
+    }
+    if (s < end && *s != '\n')
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    
+    parser->pos = (size_t)(out - parser->out);
+    *p = s;
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 结束当前条目：写入翻译的结尾NUL，决定是否加入目录
+ */
+static mo_error_t mo_po_finish_entry(mo_po_parser_t* parser)
+{
+    size_t orig_len = parser->trans_start - 1 - parser->entry_start;
+    size_t trans_len = parser->pos - parser->trans_start;
+    
+    parser->out[parser->pos++] = '\0';
+    parser->field = MO_PO_NONE;
+    
+    /* 与msgfmt相同：跳过fuzzy条目（头部除外）和未翻译的条目，已写入的字节直接丢弃 */
+    if ((parser->fuzzy && orig_len > 0) || parser->out[parser->trans_start] == '\0')
+    {
+        parser->fuzzy = false;
+        parser->pos = parser->entry_start;
+        return MO_SUCCESS;
+    }
+    parser->fuzzy = false;
+    
+    if (parser->count == parser->capacity)
+    {
+        uint32_t capacity = parser->capacity ? parser->capacity * 2 : 64;
+        mo_po_entry_t* entries = (mo_po_entry_t*)realloc(parser->entries,
+                                                         capacity * sizeof(mo_po_entry_t));
+        if (!entries)
+        {
+            return MO_ERROR_MEMORY;
+        }
+        parser->entries = entries;
+        parser->capacity = capacity;
+    }
+    
+    mo_po_entry_t* entry = &parser->entries[parser->count++];
+    entry->original = NULL;
+    entry->orig_offset = (uint32_t)parser->entry_start;
+    entry->orig_len = (uint32_t)orig_len;
+    entry->trans_offset = (uint32_t)parser->trans_start;
+    entry->trans_len = (uint32_t)trans_len;
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 处理以关键字开头的行，按字段写入分隔符后读取字符串
+ */
+static mo_error_t mo_po_begin_field(mo_po_parser_t* parser, const char** p, const char* end)
+{
+    if (mo_po_keyword(p, end, "msgctxt", 7))
+    {
+        if (parser->field != MO_PO_NONE)
+        {
+            return MO_ERROR_INVALID_FORMAT;
+        }
+        parser->entry_start = parser->pos;
+        parser->field = MO_PO_MSGCTXT;
+    }
+    else if (mo_po_keyword(p, end, "msgid_plural", 12))
+    {
+        if (parser->field != MO_PO_MSGID)
+        {
+            return MO_ERROR_INVALID_FORMAT;
+        }
+        parser->out[parser->pos++] = '\0';
+        parser->field = MO_PO_MSGID_PLURAL;
+    }
+    else if (mo_po_keyword(p, end, "msgid", 5))
+    {
+        if (parser->field == MO_PO_MSGCTXT)
+        {
+            parser->out[parser->pos++] = MO_CONTEXT_SEPARATOR;
+        }
+        else if (parser->field == MO_PO_NONE)
+        {
+            parser->entry_start = parser->pos;
+        }
+        else
+        {
+            return MO_ERROR_INVALID_FORMAT;
+        }
+        parser->field = MO_PO_MSGID;
+    }
+    else if (mo_po_keyword(p, end, "msgstr", 6))
+    {
+        uint32_t form = 0;
+    
+        /* msgstr[n]必须从0开始依次出现 */
+        if (*p < end && **p == '[')
+        {
+            for ((*p)++; *p < end && **p >= '0' && **p <= '9'; (*p)++)
+            {
+                form = form * 10 + (uint32_t)(**p - '0');
+            }
+            if (*p >= end || **p != ']')
+            {
+                return MO_ERROR_INVALID_FORMAT;
+            }
+            (*p)++;
+        }
+    
+        if (form == 0 && (parser->field == MO_PO_MSGID || parser->field == MO_PO_MSGID_PLURAL))
+        {
+            /* 原文结束，翻译从下一个字节开始 */
+            parser->out[parser->pos++] = '\0';
+            parser->trans_start = parser->pos;
+        }
+        else if (form > 0 && form == parser->next_form && parser->field == MO_PO_MSGSTR)
+        {
+            parser->out[parser->pos++] = '\0';
+        }
+        else
+        {
+            return MO_ERROR_INVALID_FORMAT;
+        }
+        parser->next_form = form + 1;
+        parser->field = MO_PO_MSGSTR;
+    }
+    else
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    
+    return mo_po_string(parser, p, end);
+}
+
+/**
+ * @brief "#,"注释行中是否带有fuzzy标记
+ */
+static bool mo_po_has_fuzzy(const char* line, const char* eol)
+{
+    for (const char* s = line + 2; s + 5 <= eol; s++)
+    {
+        if (memcmp(s, "fuzzy", 5) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 按原文排序，与msgfmt相同（逐字节比较，查找键在第一个NUL处结束）
+ */
+static int mo_po_compare(const void* a, const void* b)
+{
+    const mo_po_entry_t* x = (const mo_po_entry_t*)a;
+    const mo_po_entry_t* y = (const mo_po_entry_t*)b;
+    return strcmp(x->original, y->original);
+}
+
+/**
+ * @brief 排序条目并在输出缓冲区末尾追加字符串表，填写MO头部
+ */
+static mo_error_t mo_po_build_image(mo_po_parser_t* parser, uint8_t** image, size_t* image_size)
+{
+    size_t table_offset = (parser->pos + 3) & ~(size_t)3;
+    size_t table_bytes = (size_t)parser->count * sizeof(mo_string_entry_t);
+    size_t total = table_offset + 2 * table_bytes;
+    mo_header_t header;
+    uint32_t i;
+    
+    if (total > UINT32_MAX)
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    
+    for (i = 0; i < parser->count; i++)
+    {
+        parser->entries[i].original = (const char*)parser->out + parser->entries[i].orig_offset;
+    }
+    qsort(parser->entries, parser->count, sizeof(mo_po_entry_t), mo_po_compare);
+    
+    /* 同一个键出现两次时msgfmt同样报错 */
+    for (i = 1; i < parser->count; i++)
+    {
+        if (strcmp(parser->entries[i - 1].original, parser->entries[i].original) == 0)
+        {
+            mo_log(parser->ctx, "Duplicate message definition: \"%s\"", parser->entries[i].original);
+            return MO_ERROR_INVALID_FORMAT;
+        }
+    }
+    
+    uint8_t* out = (uint8_t*)realloc(parser->out, total);
+    if (!out)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    parser->out = out;
+    memset(out + parser->pos, 0, table_offset - parser->pos);
+    
+    mo_string_entry_t* orig_table = (mo_string_entry_t*)(out + table_offset);
+    mo_string_entry_t* trans_table = (mo_string_entry_t*)(out + table_offset + table_bytes);
+    for (i = 0; i < parser->count; i++)
+    {
+        const mo_po_entry_t* entry = &parser->entries[i];
+        mo_string_entry_t orig = { entry->orig_len, entry->orig_offset };
+        mo_string_entry_t trans = { entry->trans_len, entry->trans_offset };
+        memcpy(&orig_table[i], &orig, sizeof(orig));
+        memcpy(&trans_table[i], &trans, sizeof(trans));
+    }
+    
+    header.magic = MO_MAGIC;
+    header.revision = 0;
+    header.num_strings = parser->count;
+    header.orig_table_offset = (uint32_t)table_offset;
+    header.trans_table_offset = (uint32_t)(table_offset + table_bytes);
+    header.hash_table_size = 0;
+    header.hash_table_offset = (uint32_t)total;
+    memcpy(out, &header, sizeof(header));
+    
+    *image = out;
+    *image_size = total;
+    parser->out = NULL;
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 把.po文本编译为内存中的MO数据
+ */
+mo_error_t mo_po_compile(const mo_context_t* ctx, const char* text, size_t size,
+                         uint8_t** image, size_t* image_size)
+{
+    mo_po_parser_t parser;
+    mo_error_t result = MO_SUCCESS;
+    const char* p = text;
+    const char* end = text + size;
+    
+    memset(&parser, 0, sizeof(parser));
+    parser.ctx = ctx;
+    parser.field = MO_PO_NONE;
+    
+    /* 解开转义后的字符串和分隔符不会比原文本长（每个分隔符对应至少5字节的关键字，
+     * 每个字符串还去掉了两个引号），预先分配即可，写入时不再检查容量 */
+    parser.out = (uint8_t*)malloc(sizeof(mo_header_t) + size + 1);
+    if (!parser.out)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    parser.pos = sizeof(mo_header_t);
+    
+    while (p < end)
+    {
+        const char* eol = (const char*)memchr(p, '\n', (size_t)(end - p));
+        if (!eol)
+        {
+            eol = end;
+        }
+        parser.line++;
+    
+        while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r'))
+        {
+            p++;
+        }
+    
+        if (p < eol && *p == '"')
+        {
+            /* 续行：追加到当前字段 */
+            if (parser.field == MO_PO_NONE)
+            {
+                result = MO_ERROR_INVALID_FORMAT;
+                break;
+            }
+            result = mo_po_string(&parser, &p, eol);
+        }
+        else
+        {
+            /* 注释、空行和新条目的关键字结束上一条目的最后一个msgstr */
+            bool continues = p < eol && *p == 'm' &&
+                             (size_t)(eol - p) >= 6 && memcmp(p, "msgstr", 6) == 0;
+            if (parser.field == MO_PO_MSGSTR && !continues)
+            {
+                result = mo_po_finish_entry(&parser);
+                if (result != MO_SUCCESS)
+                {
+                    break;
+                }
+            }
+    
+            if (p < eol && *p == '#')
+            {
+                if (eol - p >= 2 && p[1] == ',' && mo_po_has_fuzzy(p, eol))
+                {
+                    parser.fuzzy = true;
+                }
+            }
+            else if (p < eol)
+            {
+                result = mo_po_begin_field(&parser, &p, eol);
+            }
+        }
+    
+        if (result != MO_SUCCESS)
+        {
+            break;
+        }
+        p = eol + 1;
+    }
+    
+    if (result == MO_SUCCESS && parser.field == MO_PO_MSGSTR)
+    {
+        result = mo_po_finish_entry(&parser);
+    }
+    else if (result == MO_SUCCESS && parser.field != MO_PO_NONE)
+    {
+        /* 文件在msgstr之前结束 */
+        result = MO_ERROR_INVALID_FORMAT;
+    }
+    
+    if (result == MO_SUCCESS)
+    {
+        result = mo_po_build_image(&parser, image, image_size);
+    }
+    else if (result == MO_ERROR_INVALID_FORMAT)
+    {
+        mo_log(ctx, "Invalid .po syntax at line %u", parser.line);
+    }
+    
+    if (result == MO_SUCCESS)
+    {
+        mo_log(ctx, "Compiled .po: %u messages, %zu bytes", parser.count, *image_size);
+    }
+    free(parser.out);
+    free(parser.entries);
+    return result;
+}
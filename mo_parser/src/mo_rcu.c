@@ -0,0 +1,277 @@
+/**
+ * @file mo_rcu.c
+ * @brief 基于纪元的读者登记与延迟回收
+ *
+ * 读者进入读取区间时把观察到的全局纪元写入本线程的槽位，离开时清零，整个过程
+ * 只有原子读写，不加锁也不会阻塞。重载在原子替换目录指针之后推进纪元，并等待
+ * 每个槽位清零或进入新纪元：替换之后才登记的读者一定能看到新指针，之前登记的
+ * 读者离开后旧目录就不会再被访问，可以安全释放。
+ *
+ * 槽位在线程首次查找时分配，线程退出时由线程局部存储的析构回调归还；每个槽位
+ * 独占一条缓存行，读者之间没有伪共享。同时存在的线程超出槽位数量时改用共享计数
+ * 登记，仍然无锁，只是宽限期需要等待该计数归零；有槽位归还后再改回独立槽位。
+ */
+
+#include "mo_internal.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#define MO_THREAD_LOCAL __declspec(thread)
+#else
+#include <pthread.h>
+#include <sched.h>
+#define MO_THREAD_LOCAL _Thread_local
+#endif
+
+#define MO_RCU_MAX_READERS 128      /**< 独立槽位数量 */
+#define MO_RCU_LINE_SIZE 64         /**< 缓存行大小，每个槽位独占一条 */
+#define MO_RCU_SLOT_UNASSIGNED (-1) /**< 线程尚未分配槽位 */
+#define MO_RCU_SLOT_SHARED (-2)     /**< 槽位已用完，使用共享计数 */
+
+/* 读者槽位 */
+typedef struct {
+    _Alignas(MO_RCU_LINE_SIZE) atomic_uint epoch; /**< 登记的纪元，0表示不在读取区间内 */
+    atomic_bool used;                             /**< 是否已分配给某个线程 */
+} mo_rcu_slot_t;
+
+/* 全局纪元，从1开始（槽位值0表示不在读取区间内） */
+static atomic_uint g_epoch = 1;
+
+/* 各读者槽位 */
+static mo_rcu_slot_t g_readers[MO_RCU_MAX_READERS];
+
+/* 曾经分配过的最大槽位序号+1，宽限期只需检查这之前的槽位 */
+static atomic_uint g_reader_count;
+
+/* 已分配给线程的槽位数 */
+static atomic_uint g_readers_used;
+
+/* 使用共享计数登记、正在读取的线程数 */
+static atomic_uint g_shared_readers;
+
+/* 线程退出时归还槽位的线程局部存储键 */
+#ifdef _WIN32
+static INIT_ONCE g_exit_once = INIT_ONCE_STATIC_INIT;
+static DWORD g_exit_key = FLS_OUT_OF_INDEXES;
+#else
+static pthread_once_t g_exit_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_exit_key;
+static bool g_exit_key_valid;
+#endif
+
+/* 本线程的槽位与读取区间嵌套深度 */
+static MO_THREAD_LOCAL int t_slot = MO_RCU_SLOT_UNASSIGNED;
+static MO_THREAD_LOCAL unsigned int t_depth;
+
+/* 内部函数声明 */
+static void mo_rcu_yield(void);
+static int mo_rcu_claim(void);
+static void mo_rcu_release_slot(int slot);
+static void mo_rcu_watch_exit(int slot);
+#ifdef _WIN32
+static BOOL CALLBACK mo_rcu_init_exit_key(PINIT_ONCE once, PVOID param, PVOID* context);
+static void WINAPI mo_rcu_thread_exit(PVOID value);
+#else
+static void mo_rcu_init_exit_key(void);
+static void mo_rcu_thread_exit(void* value);
+#endif
+
+/**
+ * @brief 让出处理器，等待读者离开
+ */
+static void mo_rcu_yield(void)
+{
+#ifdef _WIN32
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+/**
+ * @brief 分配一个空闲槽位
+ *
+ * @return int 槽位序号，没有空闲槽位时返回MO_RCU_SLOT_SHARED
+ */
+static int mo_rcu_claim(void)
+{
+    for (unsigned int i = 0; i < MO_RCU_MAX_READERS; i++)
+    {
+        bool expected = false;
+        if (atomic_load_explicit(&g_readers[i].used, memory_order_relaxed) ||
+            !atomic_compare_exchange_strong(&g_readers[i].used, &expected, true))
+        {
+            continue;
+        }
+    
+        /* 先扩大宽限期的检查范围，再登记纪元：重载线程读到旧的范围时，本线程的登记
+           必然晚于目录指针的替换，读到的一定是新目录 */
+        unsigned int count = atomic_load(&g_reader_count);
+        while (count <= i && !atomic_compare_exchange_weak(&g_reader_count, &count, i + 1))
+        {
+        }
+        atomic_fetch_add(&g_readers_used, 1u);
+        mo_rcu_watch_exit((int)i);
+        return (int)i;
+    }
+    return MO_RCU_SLOT_SHARED;
+}
+
+/**
+ * @brief 归还槽位
+ */
+static void mo_rcu_release_slot(int slot)
+{
+    atomic_store_explicit(&g_readers[slot].epoch, 0u, memory_order_release);
+    atomic_store_explicit(&g_readers[slot].used, false, memory_order_release);
+    atomic_fetch_sub(&g_readers_used, 1u);
+}
+
+#ifdef _WIN32
+/**
+ * @brief 分配线程退出回调使用的纤程局部存储索引
+ */
+static BOOL CALLBACK mo_rcu_init_exit_key(PINIT_ONCE once, PVOID param, PVOID* context)
+{
+    (void)once;
+    (void)param;
+    (void)context;
+    g_exit_key = FlsAlloc(mo_rcu_thread_exit);
+    return TRUE;
+}
+
+/**
+ * @brief 线程退出回调：归还槽位
+ */
+static void WINAPI mo_rcu_thread_exit(PVOID value)
+{
+    if (value)
+    {
+        mo_rcu_release_slot((int)((INT_PTR)value - 1));
+    }
+}
+#else
+/**
+ * @brief 创建线程退出回调使用的线程局部存储键
+ */
+static void mo_rcu_init_exit_key(void)
+{
+    g_exit_key_valid = pthread_key_create(&g_exit_key, mo_rcu_thread_exit) == 0;
+}
+
+/**
+ * @brief 线程退出回调：归还槽位
+ */
+static void mo_rcu_thread_exit(void* value)
+{
+    if (value)
+    {
+        mo_rcu_release_slot((int)((intptr_t)value - 1));
+    }
+}
+#endif
+
+/**
+ * @brief 登记线程退出时归还槽位（无法登记时槽位不回收，与线程数量不大时的行为相同）
+ */
+static void mo_rcu_watch_exit(int slot)
+{
+#ifdef _WIN32
+    InitOnceExecuteOnce(&g_exit_once, mo_rcu_init_exit_key, NULL, NULL);
+    if (g_exit_key != FLS_OUT_OF_INDEXES)
+    {
+        FlsSetValue(g_exit_key, (PVOID)(INT_PTR)(slot + 1));
+    }
+#else
+    pthread_once(&g_exit_once, mo_rcu_init_exit_key);
+    if (g_exit_key_valid)
+    {
+        pthread_setspecific(g_exit_key, (void*)(intptr_t)(slot + 1));
+    }
+#endif
+}
+
+/**
+ * @brief 进入读取区间
+ */
+void mo_read_begin(void)
+{
+    if (t_depth++ > 0)
+    {
+        return;
+    }
+    
+    /* 使用共享计数的线程在有槽位归还后改用独立槽位 */
+    if (t_slot == MO_RCU_SLOT_UNASSIGNED ||
+        (t_slot == MO_RCU_SLOT_SHARED &&
+         atomic_load_explicit(&g_readers_used, memory_order_relaxed) < MO_RCU_MAX_READERS))
+    {
+        t_slot = mo_rcu_claim();
+    }
+    
+    /* 登记须在读取目录指针之前对重载线程可见，使用顺序一致的存储 */
+    if (t_slot >= 0)
+    {
+        atomic_store(&g_readers[t_slot].epoch, atomic_load(&g_epoch));
+    }
+    else
+    {
+        atomic_fetch_add(&g_shared_readers, 1u);
+    }
+}
+
+/**
+ * @brief 离开读取区间
+ */
+void mo_read_end(void)
+{
+    if (t_depth == 0 || --t_depth > 0)
+    {
+        return;
+    }
+    
+    if (t_slot >= 0)
+    {
+        atomic_store_explicit(&g_readers[t_slot].epoch, 0u, memory_order_release);
+    }
+    else
+    {
+        atomic_fetch_sub_explicit(&g_shared_readers, 1u, memory_order_release);
+    }
+}
+
+/**
+ * @brief 当前线程是否处于读取区间内
+ */
+bool mo_rcu_in_read(void)
+{
+    return t_depth > 0;
+}
+
+/**
+ * @brief 等待宽限期
+ */
+void mo_rcu_synchronize(void)
+{
+    unsigned int target = atomic_fetch_add(&g_epoch, 1u) + 1u;
+    unsigned int count = atomic_load(&g_reader_count);
+    
+    /* 槽位为0表示不在读取区间内（含空闲槽位）；纪元不小于target的读者在替换之后才登记 */
+    for (unsigned int i = 0; i < count; i++)
+    {
+        for (;;)
+        {
+            unsigned int epoch = atomic_load(&g_readers[i].epoch);
+            if (epoch == 0 || (int)(epoch - target) >= 0)
+            {
+                break;
+            }
+            mo_rcu_yield();
+        }
+    }
+    
+    while (atomic_load(&g_shared_readers) != 0)
+    {
+        mo_rcu_yield();
+    }
+}
@@ -0,0 +1,744 @@
+/**
+ * @file mo_search_binary.c
+ * @brief 有序索引策略 - 加载时按原文字节序排序，支持按前缀枚举
+ *
+ * BINARY只保存排好序的条目序号（每条目4字节），EYTZINGER把排好序的键按
+ * 层序（BFS）存放，节点内联键长度和前8字节，多数比较不访问字符串本身。
+ */
+
+#include "mo_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Eytzinger节点数组的对齐字节数（缓存行） */
+#define MO_EYTZINGER_ALIGN 64
+
+/* 排序时使用的临时键，索引建立后释放 */
+typedef struct {
+    const char* key;
+    uint32_t len;
+    uint32_t index;
+} mo_binary_key_t;
+
+/* 并行排序的任务：各份先排序自己的范围，再逐轮两两归并相邻的有序段 */
+typedef struct {
+    const mo_context_t* ctx;
+    mo_binary_key_t* src;       /**< 本轮的输入 */
+    mo_binary_key_t* dst;       /**< 本轮的输出 */
+    uint32_t bounds[MO_PARALLEL_MAX_PARTS + 1]; /**< 各有序段的边界 */
+    uint32_t runs;              /**< 有序段数量 */
+} mo_sort_job_t;
+
+static int mo_compare_keys(const void* a, const void* b);
+static int mo_compare_segment(const char* original, uint32_t orig_len, size_t pos,
+                              const char* seg, size_t seg_len);
+static int mo_compare_entry(const mo_context_t* ctx, uint32_t index,
+                            const mo_lookup_key_t* key);
+static bool mo_entry_has_prefix(const mo_context_t* ctx, uint32_t index,
+                                const char* prefix, size_t prefix_len,
+                                mo_entry_callback_t callback, void* user_data,
+                                size_t* count);
+static mo_binary_key_t* mo_sort_keys(const mo_context_t* ctx);
+static void mo_sort_part(void* arg, uint32_t part, uint32_t parts);
+static void mo_merge_part(void* arg, uint32_t part, uint32_t parts);
+static uint32_t mo_merge_corank(uint32_t d, const mo_binary_key_t* a, uint32_t na,
+                                const mo_binary_key_t* b, uint32_t nb);
+static void mo_prefix_append(uint64_t* prefix, uint32_t* filled,
+                             const char* str, size_t len);
+static uint64_t mo_lookup_prefix(const mo_lookup_key_t* key, size_t* len);
+static int mo_eytzinger_compare(const mo_context_t* ctx, const mo_eytzinger_node_t* node,
+                                uint64_t prefix, size_t len, const mo_lookup_key_t* key);
+static size_t mo_eytzinger_fill(mo_eytzinger_node_t* nodes, const mo_binary_key_t* keys,
+                                size_t i, size_t k, size_t n);
+
+/**
+ * @brief 比较查找键（用于排序），按字节序，较短的前缀排在前面
+ *
+ * @note 键相同时按条目序号排列，排序结果唯一，并行排序与单线程排序的结果相同。
+ */
+static int mo_compare_keys(const void* a, const void* b)
+{
+    const mo_binary_key_t* key1 = (const mo_binary_key_t*)a;
+    const mo_binary_key_t* key2 = (const mo_binary_key_t*)b;
+    uint32_t n = key1->len < key2->len ? key1->len : key2->len;
+    int cmp = memcmp(key1->key, key2->key, n);
+    
+    if (cmp != 0)
+        return cmp;
+    
+    if (key1->len < key2->len)
+        return -1;
+    else if (key1->len > key2->len)
+        return 1;
+    
+    if (key1->index < key2->index)
+        return -1;
+    else if (key1->index > key2->index)
+        return 1;
+    
+    return 0;
+}
+
+/**
+ * @brief 比较条目从pos开始的部分与一段查找键，返回0表示这一段相同
+ */
+static int mo_compare_segment(const char* original, uint32_t orig_len, size_t pos,
+                              const char* seg, size_t seg_len)
+{
+    size_t avail = orig_len - pos;
+    size_t n = seg_len < avail ? seg_len : avail;
+    int cmp = memcmp(original + pos, seg, n);
+    
+    if (cmp != 0)
+        return cmp;
+    
+    return seg_len > avail ? -1 : 0;
+}
+
+/**
+ * @brief 比较条目的查找键与key，返回值的符号与(条目 - key)一致
+ *
+ * @note 条目的查找键以NUL结尾，比较到key末尾时检查条目在该位置是否结束即可，
+ *       无需预先求出复数条目单数部分的长度。带上下文的键逐段比较，
+ *       结果与比较拼接后的"msgctxt\004msgid"相同。
+ */
+static int mo_compare_entry(const mo_context_t* ctx, uint32_t index,
+                            const mo_lookup_key_t* key)
+{
+    static const char separator = MO_CONTEXT_SEPARATOR;
+    uint32_t orig_len;
+    const char* original = mo_entry_original(ctx, index, &orig_len);
+    size_t pos = 0;
+    int cmp;
+    
+    if (key->context)
+    {
+        cmp = mo_compare_segment(original, orig_len, pos, key->context, key->context_len);
+        if (cmp != 0)
+            return cmp;
+        pos += key->context_len;
+        
+        cmp = mo_compare_segment(original, orig_len, pos, &separator, 1);
+        if (cmp != 0)
+            return cmp;
+        pos++;
+    }
+    
+    cmp = mo_compare_segment(original, orig_len, pos, key->str, key->len);
+    if (cmp != 0)
+        return cmp;
+    pos += key->len;
+    
+    if (pos < orig_len)
+        return original[pos] == '\0' ? 0 : 1;
+    
+    return 0;
+}
+
+/**
+ * @brief 条目的键以prefix开头时调用回调（跳过头部条目）
+ * @return 是否继续枚举：键不以prefix开头（已越过前缀范围）或回调要求停止时返回false
+ */
+static bool mo_entry_has_prefix(const mo_context_t* ctx, uint32_t index,
+                                const char* prefix, size_t prefix_len,
+                                mo_entry_callback_t callback, void* user_data,
+                                size_t* count)
+{
+    uint32_t len;
+    uint32_t trans_len;
+    const char* key = mo_entry_key(ctx, index, &len);
+    
+    if (len < prefix_len || memcmp(key, prefix, prefix_len) != 0)
+    {
+        return false;
+    }
+    if (len == 0)
+    {
+        return true;
+    }
+    
+    (*count)++;
+    return callback(key, len, mo_entry_translation(ctx, index, &trans_len), user_data);
+}
+
+/**
+ * @brief 取出一份条目的键并排序
+ */
+static void mo_sort_part(void* arg, uint32_t part, uint32_t parts)
+{
+    mo_sort_job_t* job = (mo_sort_job_t*)arg;
+    uint32_t begin = job->bounds[part];
+    uint32_t end = job->bounds[part + 1];
+    uint32_t i;
+    
+    (void)parts;
+    
+    for (i = begin; i < end; i++)
+    {
+        job->src[i].key = mo_entry_key(job->ctx, i, &job->src[i].len);
+        job->src[i].index = i;
+    }
+    
+    qsort(job->src + begin, end - begin, sizeof(mo_binary_key_t), mo_compare_keys);
+}
+
+/**
+ * @brief 求归并结果的前d项中有多少项来自a
+ *
+ * @note 键按全序排列，没有相同的键，结果唯一。
+ */
+static uint32_t mo_merge_corank(uint32_t d, const mo_binary_key_t* a, uint32_t na,
+                                const mo_binary_key_t* b, uint32_t nb)
+{
+    uint32_t lo = d > nb ? d - nb : 0;
+    uint32_t hi = d < na ? d : na;
+    
+    /* 找最小的i，使b[d-i-1]小于a[i] */
+    while (lo < hi)
+    {
+        uint32_t i = lo + (hi - lo) / 2;
+        uint32_t j = d - i;
+        
+        if (j > 0 && mo_compare_keys(&b[j - 1], &a[i]) > 0)
+        {
+            lo = i + 1;
+        }
+        else
+        {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief 归并一轮中输出位置落在第part份内的部分
+ *
+ * @note 按输出位置而不是按段对划分工作，段对数少于线程数的最后几轮仍能用满所有线程。
+ */
+static void mo_merge_part(void* arg, uint32_t part, uint32_t parts)
+{
+    mo_sort_job_t* job = (mo_sort_job_t*)arg;
+    uint32_t count = job->bounds[job->runs];
+    uint32_t begin;
+    uint32_t end;
+    uint32_t r;
+    
+    mo_parallel_range(count, part, parts, &begin, &end);
+    
+    for (r = 0; r < job->runs; r += 2)
+    {
+        uint32_t lo = job->bounds[r];
+        uint32_t mid = job->bounds[r + 1];
+        uint32_t hi = r + 2 <= job->runs ? job->bounds[r + 2] : mid;
+        const mo_binary_key_t* a = job->src + lo;
+        const mo_binary_key_t* b = job->src + mid;
+        mo_binary_key_t* out;
+        uint32_t d0, d1, i, i1, j, j1;
+        
+        if (hi <= begin || lo >= end)
+        {
+            continue;
+        }
+        
+        /* 段对内的输出范围[d0, d1)，分别求出两段中对应的起止位置 */
+        d0 = (begin > lo ? begin : lo) - lo;
+        d1 = (end < hi ? end : hi) - lo;
+        i = mo_merge_corank(d0, a, mid - lo, b, hi - mid);
+        i1 = mo_merge_corank(d1, a, mid - lo, b, hi - mid);
+        j = d0 - i;
+        j1 = d1 - i1;
+        out = job->dst + lo + d0;
+        
+        while (i < i1 && j < j1)
+        {
+            if (mo_compare_keys(&a[i], &b[j]) < 0)
+                *out++ = a[i++];
+            else
+                *out++ = b[j++];
+        }
+        while (i < i1)
+        {
+            *out++ = a[i++];
+        }
+        while (j < j1)
+        {
+            *out++ = b[j++];
+        }
+    }
+}
+
+/**
+ * @brief 取出所有条目的键并按字节序排序，返回的数组由调用者释放
+ *
+ * @note 大目录且允许多线程时各线程先排序自己的范围，再逐轮并行归并。
+ */
+static mo_binary_key_t* mo_sort_keys(const mo_context_t* ctx)
+{
+    mo_sort_job_t job;
+    mo_binary_key_t* spare = NULL;
+    uint32_t parts = mo_parallel_parts(ctx, ctx->num_strings);
+    uint32_t i;
+    
+    job.ctx = ctx;
+    job.src = (mo_binary_key_t*)malloc(ctx->num_strings * sizeof(mo_binary_key_t));
+    if (!job.src)
+    {
+        return NULL;
+    }
+    
+    /* 归并缓冲分配失败时单线程排序 */
+    if (parts > 1)
+    {
+        spare = (mo_binary_key_t*)malloc(ctx->num_strings * sizeof(mo_binary_key_t));
+        if (!spare)
+        {
+            parts = 1;
+        }
+    }
+    
+    job.runs = parts;
+    for (i = 0; i <= parts; i++)
+    {
+        job.bounds[i] = (uint32_t)((uint64_t)ctx->num_strings * i / parts);
+    }
+    mo_parallel_run(parts, mo_sort_part, &job);
+    
+    job.dst = spare;
+    while (job.runs > 1)
+    {
+        mo_binary_key_t* merged = job.dst;
+        
+        mo_parallel_run(parts, mo_merge_part, &job);
+        
+        /* 下一轮的段边界为本轮段对的边界 */
+        for (i = 0; 2 * i < job.runs; i++)
+        {
+            job.bounds[i] = job.bounds[2 * i];
+        }
+        job.bounds[i] = job.bounds[job.runs];
+        job.runs = i;
+        job.dst = job.src;
+        job.src = merged;
+    }
+    
+    free(job.dst);
+    return job.src;
+}
+
+/**
+ * @brief 建立排序索引，每个条目只保存4字节序号
+ */
+static mo_error_t mo_binary_build(mo_context_t* ctx)
+{
+    mo_binary_key_t* keys = NULL;
+    uint32_t i;
+    
+    if (ctx->num_strings == 0)
+    {
+        return MO_SUCCESS;
+    }
+    
+    ctx->sorted_index = (uint32_t*)malloc(ctx->num_strings * sizeof(uint32_t));
+    keys = mo_sort_keys(ctx);
+    if (!ctx->sorted_index || !keys)
+    {
+        free(keys);
+        return MO_ERROR_MEMORY;
+    }
+    
+    for (i = 0; i < ctx->num_strings; i++)
+    {
+        ctx->sorted_index[i] = keys[i].index;
+    }
+    free(keys);
+    
+    mo_log(ctx, "Sorted %u entries for binary search", ctx->num_strings);
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 二分查找字符串索引
+ */
+static uint32_t mo_find_string_binary(const mo_context_t* ctx, 
+                                     const mo_lookup_key_t* key,
+                                     uint32_t hash)
+{
+    uint32_t left = 0;
+    uint32_t right = 0;
+    
+    (void)hash;
+    
+    if (!ctx || !ctx->sorted_index || mo_key_is_header(key))
+    {
+        return MO_INDEX_NONE;
+    }
+    
+    right = ctx->num_strings;
+    
+    /* 在[left, right)区间内查找 */
+    while (left < right)
+    {
+        uint32_t mid = left + (right - left) / 2;
+        uint32_t index = ctx->sorted_index[mid];
+        
+        MO_STAT_INC(ctx, comparisons);
+        
+        int cmp = mo_compare_entry(ctx, index, key);
+        if (cmp == 0)
+        {
+            return index;
+        }
+        else if (cmp < 0)
+        {
+            left = mid + 1;
+        }
+        else
+        {
+            right = mid;
+        }
+    }
+    
+    return MO_INDEX_NONE;
+}
+
+/**
+ * @brief 在排序索引中定位第一个不小于prefix的条目，依次枚举前缀范围内的条目
+ */
+static size_t mo_binary_foreach_prefix(const mo_context_t* ctx, const char* prefix,
+                                       size_t prefix_len, mo_entry_callback_t callback,
+                                       void* user_data)
+{
+    mo_lookup_key_t key;
+    uint32_t left = 0;
+    uint32_t right = ctx->num_strings;
+    size_t count = 0;
+    
+    if (!ctx->sorted_index)
+    {
+        return 0;
+    }
+    
+    key.str = prefix;
+    key.len = prefix_len;
+    key.context = NULL;
+    key.context_len = 0;
+    
+    while (left < right)
+    {
+        uint32_t mid = left + (right - left) / 2;
+        
+        if (mo_compare_entry(ctx, ctx->sorted_index[mid], &key) < 0)
+        {
+            left = mid + 1;
+        }
+        else
+        {
+            right = mid;
+        }
+    }
+    
+    for (; left < ctx->num_strings; left++)
+    {
+        if (!mo_entry_has_prefix(ctx, ctx->sorted_index[left], prefix, prefix_len,
+                                 callback, user_data, &count))
+        {
+            break;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 释放排序索引
+ */
+static void mo_binary_release(mo_context_t* ctx)
+{
+    free(ctx->sorted_index);
+    ctx->sorted_index = NULL;
+}
+
+/**
+ * @brief 排序索引占用的堆内存
+ */
+static size_t mo_binary_memory(const mo_context_t* ctx)
+{
+    return ctx->sorted_index ? (size_t)ctx->num_strings * sizeof(uint32_t) : 0;
+}
+
+const mo_search_ops_t mo_search_binary = {
+    MO_SEARCH_BINARY,
+    "BINARY",
+    mo_binary_build,
+    NULL,
+    NULL,
+    NULL,
+    mo_find_string_binary,
+    mo_binary_release,
+    NULL,
+    mo_binary_memory,
+    mo_binary_foreach_prefix
+};
+
+/**
+ * @brief 把一段字节追加到键前缀中，前缀已满8字节时忽略
+ */
+static void mo_prefix_append(uint64_t* prefix, uint32_t* filled,
+                             const char* str, size_t len)
+{
+    while (*filled < 8 && len > 0)
+    {
+        *prefix |= (uint64_t)(uint8_t)*str << (56 - 8 * *filled);
+        (*filled)++;
+        str++;
+        len--;
+    }
+}
+
+/**
+ * @brief 计算查找键的前缀和拼接后的总长度
+ */
+static uint64_t mo_lookup_prefix(const mo_lookup_key_t* key, size_t* len)
+{
+    static const char separator = MO_CONTEXT_SEPARATOR;
+    uint64_t prefix = 0;
+    uint32_t filled = 0;
+    
+    *len = key->len;
+    if (key->context)
+    {
+        mo_prefix_append(&prefix, &filled, key->context, key->context_len);
+        mo_prefix_append(&prefix, &filled, &separator, 1);
+        *len += key->context_len + 1;
+    }
+    mo_prefix_append(&prefix, &filled, key->str, key->len);
+    return prefix;
+}
+
+/**
+ * @brief 比较节点与查找键，返回值的符号与(节点 - key)一致
+ *
+ * @note 前缀按大端拼成，整数大小关系与前8字节的字节序一致。条目的键不含NUL，
+ *       前缀相同且两个键都不超过8字节时，较短的键是较长者的前缀（或两者相同），
+ *       只比较长度即可；否则回退为逐段比较字符串。
+ */
+static int mo_eytzinger_compare(const mo_context_t* ctx, const mo_eytzinger_node_t* node,
+                                uint64_t prefix, size_t len, const mo_lookup_key_t* key)
+{
+    if (node->prefix != prefix)
+    {
+        return node->prefix < prefix ? -1 : 1;
+    }
+    if (node->len <= 8 && len <= 8)
+    {
+        if (node->len == len)
+            return 0;
+        return node->len < len ? -1 : 1;
+    }
+    
+    return mo_compare_entry(ctx, node->index, key);
+}
+
+/**
+ * @brief 按中序遍历的顺序把排好序的键填入层序数组
+ * @return 下一个要填入的键下标
+ */
+static size_t mo_eytzinger_fill(mo_eytzinger_node_t* nodes, const mo_binary_key_t* keys,
+                                size_t i, size_t k, size_t n)
+{
+    if (k <= n)
+    {
+        uint32_t filled = 0;
+        
+        i = mo_eytzinger_fill(nodes, keys, i, 2 * k, n);
+        nodes[k].prefix = 0;
+        mo_prefix_append(&nodes[k].prefix, &filled, keys[i].key, keys[i].len);
+        nodes[k].len = keys[i].len;
+        nodes[k].index = keys[i].index;
+        i = mo_eytzinger_fill(nodes, keys, i + 1, 2 * k + 1, n);
+    }
+    return i;
+}
+
+/**
+ * @brief 建立Eytzinger有序索引，每个条目16字节
+ *
+ * @note 节点k的子节点为2k和2k+1，数组按缓存行对齐后，同一节点往下第三层的8个
+ *       后代（8k..8k+7）正好占两条缓存行，查找时提前预取。
+ */
+static mo_error_t mo_eytzinger_build(mo_context_t* ctx)
+{
+    mo_binary_key_t* keys = NULL;
+    mo_eytzinger_node_t* nodes;
+    uintptr_t aligned;
+    
+    if (ctx->num_strings == 0)
+    {
+        return MO_SUCCESS;
+    }
+    
+    ctx->eytzinger_block = malloc(((size_t)ctx->num_strings + 1) * sizeof(mo_eytzinger_node_t)
+                                  + MO_EYTZINGER_ALIGN);
+    keys = mo_sort_keys(ctx);
+    if (!ctx->eytzinger_block || !keys)
+    {
+        free(keys);
+        return MO_ERROR_MEMORY;
+    }
+    
+    aligned = ((uintptr_t)ctx->eytzinger_block + MO_EYTZINGER_ALIGN - 1)
+              & ~(uintptr_t)(MO_EYTZINGER_ALIGN - 1);
+    nodes = (mo_eytzinger_node_t*)aligned;
+    memset(&nodes[0], 0, sizeof(nodes[0]));
+    mo_eytzinger_fill(nodes, keys, 0, 1, ctx->num_strings);
+    ctx->eytzinger_nodes = nodes;
+    free(keys);
+    
+    mo_log(ctx, "Built Eytzinger layout for %u entries", ctx->num_strings);
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 在Eytzinger有序索引中查找
+ */
+static uint32_t mo_find_string_eytzinger(const mo_context_t* ctx,
+                                         const mo_lookup_key_t* key,
+                                         uint32_t hash)
+{
+    const mo_eytzinger_node_t* nodes;
+    uint64_t prefix;
+    size_t len;
+    size_t k = 1;
+    
+    (void)hash;
+    
+    if (!ctx || !ctx->eytzinger_nodes || mo_key_is_header(key))
+    {
+        return MO_INDEX_NONE;
+    }
+    
+    nodes = ctx->eytzinger_nodes;
+    prefix = mo_lookup_prefix(key, &len);
+    
+    while (k <= ctx->num_strings)
+    {
+        /* 按整数计算地址，越过数组末尾的预取不会访问内存 */
+        uintptr_t ahead = (uintptr_t)nodes + (uintptr_t)k * 8 * sizeof(mo_eytzinger_node_t);
+        int cmp;
+        
+        MO_PREFETCH((const void*)ahead);
+        MO_PREFETCH((const void*)(ahead + MO_EYTZINGER_ALIGN));
+        MO_STAT_INC(ctx, comparisons);
+        
+        cmp = mo_eytzinger_compare(ctx, &nodes[k], prefix, len, key);
+        if (cmp == 0)
+        {
+            return nodes[k].index;
+        }
+        k = 2 * k + (cmp < 0);
+    }
+    
+    return MO_INDEX_NONE;
+}
+
+/**
+ * @brief 定位第一个不小于prefix的节点，按中序后继依次枚举前缀范围内的条目
+ */
+static size_t mo_eytzinger_foreach_prefix(const mo_context_t* ctx, const char* prefix,
+                                          size_t prefix_len, mo_entry_callback_t callback,
+                                          void* user_data)
+{
+    const mo_eytzinger_node_t* nodes = ctx->eytzinger_nodes;
+    mo_lookup_key_t key;
+    uint64_t key_prefix;
+    size_t len;
+    size_t n = ctx->num_strings;
+    size_t k = 1;
+    size_t count = 0;
+    
+    if (!nodes)
+    {
+        return 0;
+    }
+    
+    key.str = prefix;
+    key.len = prefix_len;
+    key.context = NULL;
+    key.context_len = 0;
+    key_prefix = mo_lookup_prefix(&key, &len);
+    
+    /* 一直走到叶子之下，再去掉末尾向右走的步数，得到下界节点（0表示不存在） */
+    while (k <= n)
+    {
+        k = 2 * k + (mo_eytzinger_compare(ctx, &nodes[k], key_prefix, len, &key) < 0);
+    }
+    while (k & 1)
+    {
+        k >>= 1;
+    }
+    k >>= 1;
+    
+    while (k != 0)
+    {
+        if (!mo_entry_has_prefix(ctx, nodes[k].index, prefix, prefix_len,
+                                 callback, user_data, &count))
+        {
+            break;
+        }
+        
+        /* 中序后继：有右子树时取右子树的最左节点，否则上溯到第一个从左侧进入的祖先 */
+        if (2 * k + 1 <= n)
+        {
+            k = 2 * k + 1;
+            while (2 * k <= n)
+            {
+                k = 2 * k;
+            }
+        }
+        else
+        {
+            while (k & 1)
+            {
+                k >>= 1;
+            }
+            k >>= 1;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief 释放Eytzinger有序索引
+ */
+static void mo_eytzinger_release(mo_context_t* ctx)
+{
+    free(ctx->eytzinger_block);
+    ctx->eytzinger_block = NULL;
+    ctx->eytzinger_nodes = NULL;
+}
+
+/**
+ * @brief Eytzinger有序索引占用的堆内存
+ */
+static size_t mo_eytzinger_memory(const mo_context_t* ctx)
+{
+    if (!ctx->eytzinger_block)
+    {
+        return 0;
+    }
+    return ((size_t)ctx->num_strings + 1) * sizeof(mo_eytzinger_node_t) + MO_EYTZINGER_ALIGN;
+}
+
+const mo_search_ops_t mo_search_eytzinger = {
+    MO_SEARCH_EYTZINGER,
+    "EYTZINGER",
+    mo_eytzinger_build,
+    NULL,
+    NULL,
+    NULL,
+    mo_find_string_eytzinger,
+    mo_eytzinger_release,
+    NULL,
+    mo_eytzinger_memory,
+    mo_eytzinger_foreach_prefix
+};
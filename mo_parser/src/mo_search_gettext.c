@@ -0,0 +1,212 @@
+/**
+ * @file mo_search_gettext.c
+ * @brief 内嵌哈希表查找策略 - 直接使用msgfmt写入MO文件的哈希表
+ */
+
+#include "mo_internal.h"
+#include <string.h>
+
+/**
+ * @brief 在已有的hashpjw哈希值之后继续追加字节（算法与GNU gettext写入MO文件的哈希表一致）
+ */
+static uint32_t mo_hash_feed_pjw(uint32_t hash, const char* str, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        uint32_t g;
+        
+        hash = (hash << 4) + (uint8_t)str[i];
+        g = hash & 0xF0000000u;
+        if (g != 0)
+        {
+            hash ^= g >> 24;
+            hash ^= g;
+        }
+    }
+    return hash;
+}
+
+/**
+ * @brief 计算字符串的哈希值（hashpjw）
+ */
+uint32_t mo_hash_string_pjw(const char* str, size_t len)
+{
+    return mo_hash_feed_pjw(0, str, len);
+}
+
+/**
+ * @brief 计算以NUL结尾的字符串的hashpjw哈希值，同时求出长度
+ */
+static uint32_t mo_hash_cstr_pjw(const char* str, size_t* len)
+{
+    const char* p = str;
+    uint32_t hash = 0;
+    
+    while (*p)
+    {
+        uint32_t g;
+        
+        hash = (hash << 4) + (uint8_t)*p++;
+        g = hash & 0xF0000000u;
+        if (g != 0)
+        {
+            hash ^= g >> 24;
+            hash ^= g;
+        }
+    }
+    
+    *len = (size_t)(p - str);
+    return hash;
+}
+
+/**
+ * @brief 逐段计算带上下文的查找键的hashpjw哈希值
+ */
+static uint32_t mo_hash_key_pjw(const mo_lookup_key_t* key)
+{
+    uint32_t hash = 0;
+    
+    if (key->context)
+    {
+        static const char separator = MO_CONTEXT_SEPARATOR;
+        hash = mo_hash_feed_pjw(hash, key->context, key->context_len);
+        hash = mo_hash_feed_pjw(hash, &separator, 1);
+    }
+    return mo_hash_feed_pjw(hash, key->str, key->len);
+}
+
+/**
+ * @brief 文件是否带有可用的内嵌哈希表
+ */
+bool mo_gettext_usable(const mo_context_t* ctx)
+{
+    const mo_header_t* header = &ctx->header;
+    
+    /* 双重哈希的步长计算要求表大小至少为3 */
+    return header->hash_table_size >= 3 && (header->hash_table_offset & 3) == 0 &&
+           (uint64_t)header->hash_table_offset + 
+               (uint64_t)header->hash_table_size * sizeof(uint32_t) <= ctx->size;
+}
+
+/**
+ * @brief 校验并启用MO文件内嵌的哈希表
+ * 
+ * @note 文件不含可用的哈希表时（如msgfmt --no-hash生成），
+ *       将上下文切换为哈希查找策略并构建哈希表。
+ */
+static mo_error_t mo_load_file_hash_table(mo_context_t* ctx)
+{
+    const mo_header_t* header = &ctx->header;
+    
+    if (!mo_gettext_usable(ctx))
+    {
+        mo_log(ctx, "No usable embedded hash table, falling back to HASH");
+        ctx->search = &mo_search_hash;
+        return ctx->search->build(ctx);
+    }
+    
+    ctx->file_hash_table = (const uint32_t*)(ctx->data + header->hash_table_offset);
+    ctx->file_hash_size = header->hash_table_size;
+    
+    mo_log(ctx, "Using embedded hash table: size=%u, items=%u",
+           ctx->file_hash_size, ctx->num_strings);
+    
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 使用MO文件内嵌的哈希表查找字符串索引
+ * 
+ * @note 探测序列与GNU gettext相同：起始位置为hash % size，
+ *       步长为1 + hash % (size - 2)。表项存放的是字符串序号加1，0表示空槽位。
+ */
+static uint32_t mo_find_string_gettext(const mo_context_t* ctx,
+                                      const mo_lookup_key_t* key,
+                                      uint32_t hash)
+{
+    if (!ctx || !ctx->file_hash_table || !key->str || mo_key_is_header(key))
+    {
+        return MO_INDEX_NONE;
+    }
+    
+    uint32_t size = ctx->file_hash_size;
+    uint32_t index = hash % size;
+    uint32_t incr = 1 + (hash % (size - 2));
+    
+    for (uint32_t probes = 0; probes < size; probes++)
+    {
+        uint32_t entry = mo_swap_uint32(ctx->file_hash_table[index], ctx->need_swap);
+        
+        if (entry == 0)
+        {
+            /* 找到空槽位，说明字符串不存在 */
+            return MO_INDEX_NONE;
+        }
+        
+        entry--;
+        if (entry < ctx->num_strings && mo_entry_matches(ctx, entry, key))
+        {
+            return entry;
+        }
+        
+        MO_STAT_INC(ctx, hash_collisions);
+        
+        /* 双重哈希探测下一个槽位 */
+        if (index >= size - incr)
+        {
+            index -= size - incr;
+        }
+        else
+        {
+            index += incr;
+        }
+    }
+    
+    return MO_INDEX_NONE;
+}
+
+/**
+ * @brief 预取探测起始槽位、其字符串表项和键字节
+ */
+static void mo_prefetch_gettext(const mo_context_t* ctx, uint32_t hash, int stage)
+{
+    if (!ctx->file_hash_table)
+    {
+        return;
+    }
+    
+    const uint32_t* slot = &ctx->file_hash_table[hash % ctx->file_hash_size];
+    if (stage == 0)
+    {
+        MO_PREFETCH(slot);
+        return;
+    }
+    
+    uint32_t entry = mo_swap_uint32(*slot, ctx->need_swap);
+    if (entry == 0 || entry - 1 >= ctx->num_strings)
+    {
+        return;
+    }
+    if (stage == 1)
+    {
+        MO_PREFETCH(&ctx->orig_table[entry - 1]);
+    }
+    else if (stage == 2)
+    {
+        mo_entry_prefetch_key(ctx, entry - 1);
+    }
+}
+
+const mo_search_ops_t mo_search_gettext = {
+    MO_SEARCH_GETTEXT,
+    "GETTEXT",
+    mo_load_file_hash_table,
+    mo_hash_string_pjw,
+    mo_hash_cstr_pjw,
+    mo_hash_key_pjw,
+    mo_find_string_gettext,
+    NULL,
+    mo_prefetch_gettext,
+    NULL,
+    NULL
+};
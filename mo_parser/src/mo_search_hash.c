@@ -0,0 +1,329 @@
+/**
+ * @file mo_search_hash.c
+ * @brief 哈希查找策略 - 加载时构建分组控制字节哈希表
+ *
+ * 表由两个数组组成：每槽1字节的控制字节（空槽位为0x80，已占用为哈希值低7位），
+ * 以及每槽4字节的条目序号。哈希值的其余位选择起始组，每次用SIMD比较一组
+ * 16个控制字节，只有指纹相同的槽位才会访问键数据。组内存在空槽位即可判定未命中，
+ * 绝大多数未命中只访问一条缓存行。
+ *
+ * 最大装载因子7/8，表大小取2的幂次，每个条目占用5到约11.4字节。
+ */
+
+#include "mo_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MO_HASH_USE_SSE2 1
+#endif
+
+#define MO_HASH_TABLE_LOAD_FACTOR 0.875f
+
+/**
+ * @brief 获取大于等于n的最小2的幂次
+ */
+static uint32_t mo_next_power_of_two(uint32_t n)
+{
+    n--;
+    n |= n >> 1;
+    n |= n >> 2;
+    n |= n >> 4;
+    n |= n >> 8;
+    n |= n >> 16;
+    n++;
+    return n;
+}
+
+/**
+ * @brief 哈希值低7位作为控制字节中的指纹
+ */
+static inline uint8_t mo_hash_h2(uint32_t hash)
+{
+    return (uint8_t)(hash & 0x7F);
+}
+
+/**
+ * @brief 哈希值其余位选择起始组
+ */
+static inline uint32_t mo_hash_h1(uint32_t hash)
+{
+    return hash >> 7;
+}
+
+/**
+ * @brief 返回组内控制字节等于value的槽位掩码（第i位对应第i个槽位）
+ */
+static inline uint32_t mo_group_match(const uint8_t* group, uint8_t value)
+{
+#ifdef MO_HASH_USE_SSE2
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)value)));
+#else
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < MO_HASH_GROUP_WIDTH; i++)
+    {
+        mask |= (uint32_t)(group[i] == value) << i;
+    }
+    return mask;
+#endif
+}
+
+/**
+ * @brief 返回掩码中最低位的位置
+ */
+static inline uint32_t mo_lowest_bit(uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (uint32_t)__builtin_ctz(mask);
+#else
+    uint32_t i = 0;
+    while (!(mask & 1u))
+    {
+        mask >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+/* 并行计算哈希值的任务 */
+typedef struct {
+    const mo_context_t* ctx;
+    uint32_t* hashes;
+} mo_hash_job_t;
+
+/**
+ * @brief 计算一份条目的哈希值
+ */
+static void mo_hash_entries(void* arg, uint32_t part, uint32_t parts)
+{
+    mo_hash_job_t* job = (mo_hash_job_t*)arg;
+    uint32_t begin;
+    uint32_t end;
+    
+    mo_parallel_range(job->ctx->num_strings, part, parts, &begin, &end);
+    for (uint32_t i = begin; i < end; i++)
+    {
+        uint32_t len;
+        const char* key = mo_entry_key(job->ctx, i, &len);
+        job->hashes[i] = mo_hash_bytes(key, len);
+    }
+}
+
+/**
+ * @brief 构建哈希表
+ *
+ * @note 大目录且允许多线程时先并行算出所有哈希值（读取键数据是建表的主要开销），
+ *       再按条目序号依次插入并预取后续条目的起始组。插入顺序与单线程相同，
+ *       得到的表完全一致。
+ */
+static mo_error_t mo_build_hash_table(mo_context_t* ctx)
+{
+    if (!ctx || ctx->num_strings == 0)
+    {
+        return MO_SUCCESS;
+    }
+    
+    /* 计算哈希表大小（2的幂次，至少一组） */
+    uint32_t target_size = (uint32_t)(ctx->num_strings / MO_HASH_TABLE_LOAD_FACTOR) + 1;
+    if (target_size < MO_HASH_GROUP_WIDTH)
+    {
+        target_size = MO_HASH_GROUP_WIDTH;
+    }
+    ctx->hash_table_size = mo_next_power_of_two(target_size);
+    ctx->hash_group_mask = ctx->hash_table_size / MO_HASH_GROUP_WIDTH - 1;
+    ctx->hash_table_count = 0;
+    
+    /* 分配控制字节与索引数组 */
+    ctx->hash_ctrl = (uint8_t*)malloc(ctx->hash_table_size);
+    ctx->hash_slots = (uint32_t*)malloc(ctx->hash_table_size * sizeof(uint32_t));
+    if (!ctx->hash_ctrl || !ctx->hash_slots)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    
+    /* 初始化所有槽位为空 */
+    memset(ctx->hash_ctrl, MO_HASH_CTRL_EMPTY, ctx->hash_table_size);
+    
+    /* 并行计算哈希值，临时数组分配失败时退回逐条计算 */
+    mo_hash_job_t job = { ctx, NULL };
+    uint32_t parts = mo_parallel_parts(ctx, ctx->num_strings);
+    if (parts > 1)
+    {
+        job.hashes = (uint32_t*)malloc(ctx->num_strings * sizeof(uint32_t));
+        if (job.hashes)
+        {
+            mo_parallel_run(parts, mo_hash_entries, &job);
+        }
+    }
+    
+    /* 插入头部以外所有条目的序号到哈希表 */
+    for (uint32_t i = 0; i < ctx->num_strings; i++)
+    {
+        uint32_t hash;
+        if (i == ctx->header_index)
+        {
+            continue;
+        }
+        if (job.hashes)
+        {
+            hash = job.hashes[i];
+            if (i + MO_BATCH_GROUP < ctx->num_strings)
+            {
+                uint32_t ahead = mo_hash_h1(job.hashes[i + MO_BATCH_GROUP]) & ctx->hash_group_mask;
+                MO_PREFETCH(ctx->hash_ctrl + ahead * MO_HASH_GROUP_WIDTH);
+            }
+        }
+        else
+        {
+            uint32_t len;
+            const char* key = mo_entry_key(ctx, i, &len);
+            hash = mo_hash_bytes(key, len);
+        }
+        uint32_t group = mo_hash_h1(hash) & ctx->hash_group_mask;
+        
+        /* 按组做三角数探测，找到第一个有空槽位的组 */
+        for (uint32_t step = 1; ; step++)
+        {
+            uint8_t* ctrl = ctx->hash_ctrl + group * MO_HASH_GROUP_WIDTH;
+            uint32_t empty = mo_group_match(ctrl, MO_HASH_CTRL_EMPTY);
+            if (empty)
+            {
+                uint32_t slot = group * MO_HASH_GROUP_WIDTH + mo_lowest_bit(empty);
+                ctx->hash_ctrl[slot] = mo_hash_h2(hash);
+                ctx->hash_slots[slot] = i;
+                ctx->hash_table_count++;
+                break;
+            }
+            group = (group + step) & ctx->hash_group_mask;
+        }
+    }
+    free(job.hashes);
+    
+    mo_log(ctx, "Hash table built: size=%u, groups=%u, items=%u, load=%.2f", 
+           ctx->hash_table_size, ctx->hash_group_mask + 1, ctx->hash_table_count,
+           (float)ctx->hash_table_count / ctx->hash_table_size);
+    
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 使用哈希表查找字符串索引
+ */
+static uint32_t mo_find_string_hash(const mo_context_t* ctx, 
+                                   const mo_lookup_key_t* key,
+                                   uint32_t hash)
+{
+    if (!ctx || !ctx->hash_ctrl || !key->str)
+    {
+        return MO_INDEX_NONE;
+    }
+    
+    uint8_t h2 = mo_hash_h2(hash);
+    uint32_t group = mo_hash_h1(hash) & ctx->hash_group_mask;
+    
+    /* 按组探测，组数为2的幂次，三角数步长可遍历所有组 */
+    for (uint32_t step = 1; step <= ctx->hash_group_mask + 1; step++)
+    {
+        const uint8_t* ctrl = ctx->hash_ctrl + group * MO_HASH_GROUP_WIDTH;
+        uint32_t match = mo_group_match(ctrl, h2);
+        
+        /* 只有指纹相同的槽位才比较键内容 */
+        while (match)
+        {
+            uint32_t slot = group * MO_HASH_GROUP_WIDTH + mo_lowest_bit(match);
+            if (mo_entry_matches(ctx, ctx->hash_slots[slot], key))
+            {
+                return ctx->hash_slots[slot];
+            }
+            
+            /* 记录哈希冲突（指纹相同但键不同） */
+            MO_STAT_INC(ctx, hash_collisions);
+            match &= match - 1;
+        }
+        
+        /* 组内存在空槽位，说明字符串不存在 */
+        if (mo_group_match(ctrl, MO_HASH_CTRL_EMPTY))
+        {
+            return MO_INDEX_NONE;
+        }
+        
+        group = (group + step) & ctx->hash_group_mask;
+    }
+    
+    return MO_INDEX_NONE;
+}
+
+/**
+ * @brief 释放哈希表
+ */
+static void mo_release_hash_table(mo_context_t* ctx)
+{
+    free(ctx->hash_ctrl);
+    free(ctx->hash_slots);
+    ctx->hash_ctrl = NULL;
+    ctx->hash_slots = NULL;
+    ctx->hash_table_size = 0;
+    ctx->hash_group_mask = 0;
+    ctx->hash_table_count = 0;
+}
+
+/**
+ * @brief 哈希表占用的堆内存：每槽1字节控制字节和4字节条目序号
+ */
+static size_t mo_hash_memory(const mo_context_t* ctx)
+{
+    return (size_t)ctx->hash_table_size * (sizeof(uint8_t) + sizeof(uint32_t));
+}
+
+/**
+ * @brief 预取起始组的控制字节，以及第一个指纹匹配槽位的字符串表项和键字节
+ */
+static void mo_prefetch_hash(const mo_context_t* ctx, uint32_t hash, int stage)
+{
+    if (!ctx->hash_ctrl)
+    {
+        return;
+    }
+    
+    uint32_t group = mo_hash_h1(hash) & ctx->hash_group_mask;
+    const uint8_t* ctrl = ctx->hash_ctrl + group * MO_HASH_GROUP_WIDTH;
+    if (stage == 0)
+    {
+        MO_PREFETCH(ctrl);
+        MO_PREFETCH(&ctx->hash_slots[group * MO_HASH_GROUP_WIDTH]);
+        return;
+    }
+    
+    uint32_t match = mo_group_match(ctrl, mo_hash_h2(hash));
+    if (!match)
+    {
+        return;
+    }
+    
+    uint32_t slot = group * MO_HASH_GROUP_WIDTH + mo_lowest_bit(match);
+    if (stage == 1)
+    {
+        MO_PREFETCH(&ctx->orig_table[ctx->hash_slots[slot]]);
+    }
+    else if (stage == 2)
+    {
+        mo_entry_prefetch_key(ctx, ctx->hash_slots[slot]);
+    }
+}
+
+const mo_search_ops_t mo_search_hash = {
+    MO_SEARCH_HASH,
+    "HASH",
+    mo_build_hash_table,
+    mo_hash_bytes,
+    mo_hash_cstr,
+    mo_hash_key,
+    mo_find_string_hash,
+    mo_release_hash_table,
+    mo_prefetch_hash,
+    mo_hash_memory,
+    NULL
+};
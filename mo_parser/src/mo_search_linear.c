@@ -0,0 +1,58 @@
+/**
+ * @file mo_search_linear.c
+ * @brief 线性查找策略 - 无索引，逐项比较
+ */
+
+#include "mo_internal.h"
+#include <string.h>
+
+/**
+ * @brief 线性查找无需建立索引
+ */
+static mo_error_t mo_linear_build(mo_context_t* ctx)
+{
+    (void)ctx;
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 线性查找字符串索引
+ */
+static uint32_t mo_find_string_linear(const mo_context_t* ctx, 
+                                     const mo_lookup_key_t* key,
+                                     uint32_t hash)
+{
+    (void)hash;
+    
+    if (!ctx || ctx->num_strings == 0 || mo_key_is_header(key))
+    {
+        return MO_INDEX_NONE;
+    }
+    
+    /* 顺序遍历文件中的字符串表，先比较长度再比较内容 */
+    for (uint32_t i = 0; i < ctx->num_strings; i++)
+    {
+        MO_STAT_INC(ctx, comparisons);
+        
+        if (mo_entry_matches(ctx, i, key))
+        {
+            return i;
+        }
+    }
+    
+    return MO_INDEX_NONE;
+}
+
+const mo_search_ops_t mo_search_linear = {
+    MO_SEARCH_LINEAR,
+    "LINEAR",
+    mo_linear_build,
+    NULL,
+    NULL,
+    NULL,
+    mo_find_string_linear,
+    NULL,
+    NULL,
+    NULL,
+    NULL
+};
@@ -0,0 +1,734 @@
+/**
+ * @file mo_search_mph.c
+ * @brief 最小完美哈希查找策略 - 使用构建期追加到MO文件末尾的哈希段
+ *
+ * 哈希段采用PTHash/CHD方式构建：键按哈希值偏斜地分入约n/6个桶，每个桶选定一个
+ * 16位位移参数，使桶内所有键落到互不冲突的槽位。槽位范围略大于n（约3%），
+ * 落在n之外的槽位通过重定向表映射到n以内的空闲槽位，最终每个键恰好占用
+ * [0, n)中的一个槽位。位移参数约占每键2.7位，另有每键4字节的字符串序号表。
+ *
+ * 键的哈希值与HASH策略相同（mo_hash_bytes），查找缓存和批量预取可直接复用。
+ * 32位哈希值与其他键完全相同的少数键无法被完美哈希区分，存放在溢出表中，
+ * 仅在槽位比较失败时线性检查。
+ *
+ * 文件布局（字节序与MO文件相同，段尾的魔数同时起字节序标记的作用）：
+ *   [MO数据][填充至4字节对齐][序号表 uint32 x n][重定向表 uint32 x (m-n)]
+ *   [溢出表 uint32 x k][位移表 uint16 x 桶数][填充至4字节对齐][段尾 mo_mph_footer_t]
+ */
+
+#include "mo_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MO_MPH_MAGIC 0x3248504D     /**< "MPH2" */
+#define MO_MPH_MAGIC_V1 0x3148504D  /**< "MPH1"：未记录哈希版本的旧格式，段尾少一个字 */
+#define MO_MPH_HASH_VERSION 2       /**< 键哈希算法版本：8字节块按小端读取的mo_hash_bytes */
+#define MO_MPH_BUCKET_SIZE 6        /**< 平均每桶键数 */
+#define MO_MPH_MAX_PILOT 0xFFFF     /**< 位移参数上限（16位） */
+#define MO_MPH_MAX_SEEDS 32         /**< 构建失败时更换种子的次数 */
+#define MO_MPH_DENSE_KEYS 0x99999999u /**< 落入密集桶的键比例（60%，32位定点） */
+#define MO_MPH_SEED_BASE 0x6d6f5f6d70685f31ULL
+
+/**
+ * @brief 哈希段尾部，位于文件最后
+ */
+typedef struct {
+    uint32_t section_offset;    /**< 哈希段起始偏移（即对齐后的MO数据大小） */
+    uint32_t num_keys;          /**< 完美哈希覆盖的键数量 */
+    uint32_t num_overflow;      /**< 溢出表项数，与num_keys之和等于字符串数量 */
+    uint32_t num_buckets;       /**< 桶数量 */
+    uint32_t num_slots;         /**< 位移后的槽位范围 */
+    uint32_t seed_lo;           /**< 哈希种子低32位 */
+    uint32_t seed_hi;           /**< 哈希种子高32位 */
+    uint32_t hash_version;      /**< 构建时的键哈希算法版本MO_MPH_HASH_VERSION */
+    uint32_t magic;             /**< 魔数MO_MPH_MAGIC */
+} mo_mph_footer_t;
+
+/**
+ * @brief 哈希值与字符串序号，构建时排序用
+ */
+typedef struct {
+    uint32_t hash;
+    uint32_t index;
+} mo_mph_key_t;
+
+/**
+ * @brief 64位混合函数（splitmix64的终结步骤）
+ */
+static inline uint64_t mo_mph_mix(uint64_t x)
+{
+    x ^= x >> 31;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief 将键的哈希值与种子混合为64位
+ */
+static inline uint64_t mo_mph_key_hash(uint32_t hash, uint64_t seed)
+{
+    return mo_mph_mix((uint64_t)hash ^ seed);
+}
+
+/**
+ * @brief 由混合后哈希值确定桶
+ *
+ * @note 与PTHash相同的偏斜分桶：高32位决定键落入前30%的桶（占60%的键）还是其余的桶，
+ *       低32位决定具体的桶。大桶先处理，最后剩下的都是小桶，空闲槽位很少时也容易放下。
+ */
+static inline uint32_t mo_mph_bucket(uint64_t h, uint32_t num_buckets)
+{
+    uint32_t dense = (uint32_t)((uint64_t)num_buckets * 3 / 10);
+    uint64_t lo = h & 0xFFFFFFFFu;
+    
+    if ((h >> 32) < MO_MPH_DENSE_KEYS)
+    {
+        return (uint32_t)((lo * dense) >> 32);
+    }
+    return dense + (uint32_t)((lo * (num_buckets - dense)) >> 32);
+}
+
+/**
+ * @brief 由混合后哈希值和桶的位移参数确定槽位
+ */
+static inline uint32_t mo_mph_position(uint64_t h, uint32_t pilot, uint32_t num_slots)
+{
+    uint64_t x = mo_mph_mix(h ^ ((uint64_t)pilot * 0x9e3779b97f4a7c15ULL));
+    return (uint32_t)(((x & 0xFFFFFFFFu) * num_slots) >> 32);
+}
+
+/**
+ * @brief 计算哈希值对应的最终槽位，MO_INDEX_NONE表示重定向表损坏
+ */
+static inline uint32_t mo_mph_slot(const mo_context_t* ctx, uint32_t hash)
+{
+    uint64_t h = mo_mph_key_hash(hash, ctx->mph_seed);
+    uint32_t bucket = mo_mph_bucket(h, ctx->mph_buckets);
+    uint32_t pilot = mo_swap_uint16(ctx->mph_pilots[bucket], ctx->need_swap);
+    uint32_t slot = mo_mph_position(h, pilot, ctx->mph_slots);
+    
+    if (slot >= ctx->mph_keys)
+    {
+        slot = mo_swap_uint32(ctx->mph_remap[slot - ctx->mph_keys], ctx->need_swap);
+        if (slot >= ctx->mph_keys)
+        {
+            return MO_INDEX_NONE;
+        }
+    }
+    
+    return slot;
+}
+
+/**
+ * @brief 读取并校验文件末尾的哈希段尾部
+ *
+ * @return bool 数据带有完整且与MO头部一致的哈希段时返回true
+ */
+static bool mo_mph_read_footer(const mo_context_t* ctx, mo_mph_footer_t* footer)
+{
+    if (ctx->size < sizeof(mo_mph_footer_t))
+    {
+        return false;
+    }
+    
+    const uint8_t* tail = ctx->data + ctx->size - sizeof(mo_mph_footer_t);
+    uint32_t* out = (uint32_t*)footer;
+    for (size_t i = 0; i < sizeof(mo_mph_footer_t) / sizeof(uint32_t); i++)
+    {
+        uint32_t word;
+        memcpy(&word, tail + i * sizeof(uint32_t), sizeof(word));
+        out[i] = mo_swap_uint32(word, ctx->need_swap);
+    }
+    
+    if (footer->magic != MO_MPH_MAGIC || footer->num_buckets == 0 ||
+        (uint64_t)footer->num_keys + footer->num_overflow != ctx->num_strings ||
+        footer->num_slots < footer->num_keys ||
+        footer->num_slots - footer->num_keys > footer->num_keys / 16 + 1 ||
+        (footer->section_offset & 3) != 0)
+    {
+        return false;
+    }
+    
+    /* 槽位和位移参数由键的哈希值决定，算法不同时整个段都不可用 */
+    if (footer->hash_version != MO_MPH_HASH_VERSION)
+    {
+        mo_log(ctx, "Perfect hash built with hash version %u, expected %u",
+               footer->hash_version, MO_MPH_HASH_VERSION);
+        return false;
+    }
+    
+    uint64_t pilots_size = ((uint64_t)footer->num_buckets * sizeof(uint16_t) + 3) & ~(uint64_t)3;
+    uint64_t expected = (uint64_t)footer->section_offset +
+                        ((uint64_t)footer->num_slots + footer->num_overflow) * sizeof(uint32_t) +
+                        pilots_size + sizeof(mo_mph_footer_t);
+    
+    return expected == ctx->size;
+}
+
+/**
+ * @brief 去掉哈希段后的MO数据大小（含旧格式的哈希段），不带哈希段时为整个数据
+ */
+static size_t mo_mph_data_size(const mo_context_t* ctx)
+{
+    mo_mph_footer_t footer;
+    uint32_t words[2];
+    
+    if (mo_mph_read_footer(ctx, &footer))
+    {
+        return footer.section_offset;
+    }
+    
+    /* 旧格式的段尾共8个字，第一个字为段起始偏移，最后一个字为魔数 */
+    if (ctx->size >= 8 * sizeof(uint32_t))
+    {
+        memcpy(&words[0], ctx->data + ctx->size - 8 * sizeof(uint32_t), sizeof(uint32_t));
+        memcpy(&words[1], ctx->data + ctx->size - sizeof(uint32_t), sizeof(uint32_t));
+        uint32_t offset = mo_swap_uint32(words[0], ctx->need_swap);
+        if (mo_swap_uint32(words[1], ctx->need_swap) == MO_MPH_MAGIC_V1 &&
+            offset >= sizeof(mo_header_t) && offset < ctx->size)
+        {
+            return offset;
+        }
+    }
+    return ctx->size;
+}
+
+/**
+ * @brief 文件是否带有最小完美哈希段
+ */
+bool mo_mph_usable(const mo_context_t* ctx)
+{
+    mo_mph_footer_t footer;
+    
+    return mo_mph_read_footer(ctx, &footer);
+}
+
+/**
+ * @brief 启用文件中的最小完美哈希段
+ *
+ * @note 文件不带哈希段（未经构建工具处理）或哈希段的哈希算法版本不符时，回退为内嵌
+ *       哈希表查找策略。
+ */
+static mo_error_t mo_load_mph(mo_context_t* ctx)
+{
+    mo_mph_footer_t footer;
+    
+    if (!mo_mph_read_footer(ctx, &footer))
+    {
+        mo_log(ctx, "No usable perfect hash section, falling back to GETTEXT");
+        ctx->search = &mo_search_gettext;
+        return ctx->search->build(ctx);
+    }
+    
+    ctx->mph_index = (const uint32_t*)(ctx->data + footer.section_offset);
+    ctx->mph_remap = ctx->mph_index + footer.num_keys;
+    ctx->mph_overflow = ctx->mph_index + footer.num_slots;
+    ctx->mph_pilots = (const uint16_t*)(ctx->mph_overflow + footer.num_overflow);
+    ctx->mph_keys = footer.num_keys;
+    ctx->mph_overflow_count = footer.num_overflow;
+    ctx->mph_buckets = footer.num_buckets;
+    ctx->mph_slots = footer.num_slots;
+    ctx->mph_seed = ((uint64_t)footer.seed_hi << 32) | footer.seed_lo;
+    
+    mo_log(ctx, "Using perfect hash: keys=%u, overflow=%u, buckets=%u, slots=%u",
+           footer.num_keys, footer.num_overflow, footer.num_buckets, footer.num_slots);
+    
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 比较条目的查找键
+ */
+static inline bool mo_mph_match(const mo_context_t* ctx, uint32_t index,
+                                const mo_lookup_key_t* key)
+{
+    if (index >= ctx->num_strings)
+    {
+        return false;
+    }
+    
+    MO_STAT_INC(ctx, comparisons);
+    
+    return mo_entry_matches(ctx, index, key);
+}
+
+/**
+ * @brief 使用最小完美哈希查找字符串索引
+ *
+ * @note 未知的键同样会落到某个槽位，由长度和内容比较排除。
+ */
+static uint32_t mo_find_string_mph(const mo_context_t* ctx,
+                                  const mo_lookup_key_t* key,
+                                  uint32_t hash)
+{
+    if (!ctx || !ctx->mph_index || !key->str || mo_key_is_header(key))
+    {
+        return MO_INDEX_NONE;
+    }
+    
+    if (ctx->mph_keys > 0)
+    {
+        uint32_t slot = mo_mph_slot(ctx, hash);
+        if (slot != MO_INDEX_NONE)
+        {
+            uint32_t index = mo_swap_uint32(ctx->mph_index[slot], ctx->need_swap);
+            if (mo_mph_match(ctx, index, key))
+            {
+                return index;
+            }
+        }
+    }
+    
+    /* 哈希值与其他键相同的键存放在溢出表中，通常为空 */
+    for (uint32_t i = 0; i < ctx->mph_overflow_count; i++)
+    {
+        uint32_t index = mo_swap_uint32(ctx->mph_overflow[i], ctx->need_swap);
+        if (mo_mph_match(ctx, index, key))
+        {
+            return index;
+        }
+    }
+    
+    return MO_INDEX_NONE;
+}
+
+/**
+ * @brief 释放哈希段引用（数据属于文件映射，无需释放）
+ */
+static void mo_release_mph(mo_context_t* ctx)
+{
+    ctx->mph_index = NULL;
+    ctx->mph_remap = NULL;
+    ctx->mph_overflow = NULL;
+    ctx->mph_pilots = NULL;
+    ctx->mph_keys = 0;
+    ctx->mph_overflow_count = 0;
+    ctx->mph_buckets = 0;
+    ctx->mph_slots = 0;
+}
+
+/**
+ * @brief 预取位移参数、哈希值对应槽位的字符串序号、其字符串表项和键字节
+ */
+static void mo_prefetch_mph(const mo_context_t* ctx, uint32_t hash, int stage)
+{
+    if (!ctx->mph_index || ctx->mph_keys == 0)
+    {
+        return;
+    }
+    
+    if (stage == 0)
+    {
+        uint64_t h = mo_mph_key_hash(hash, ctx->mph_seed);
+        MO_PREFETCH(&ctx->mph_pilots[mo_mph_bucket(h, ctx->mph_buckets)]);
+        return;
+    }
+    
+    uint32_t slot = mo_mph_slot(ctx, hash);
+    if (slot == MO_INDEX_NONE)
+    {
+        return;
+    }
+    if (stage == 1)
+    {
+        MO_PREFETCH(&ctx->mph_index[slot]);
+        return;
+    }
+    
+    uint32_t index = mo_swap_uint32(ctx->mph_index[slot], ctx->need_swap);
+    if (index >= ctx->num_strings)
+    {
+        return;
+    }
+    if (stage == 2)
+    {
+        MO_PREFETCH(&ctx->orig_table[index]);
+    }
+    else if (stage == 3)
+    {
+        mo_entry_prefetch_key(ctx, index);
+    }
+}
+
+/**
+ * @brief 按哈希值排序
+ */
+static int mo_mph_compare_keys(const void* a, const void* b)
+{
+    const mo_mph_key_t* ka = (const mo_mph_key_t*)a;
+    const mo_mph_key_t* kb = (const mo_mph_key_t*)b;
+    
+    if (ka->hash != kb->hash)
+    {
+        return ka->hash < kb->hash ? -1 : 1;
+    }
+    return ka->index < kb->index ? -1 : (ka->index > kb->index);
+}
+
+/**
+ * @brief 使用给定种子为所有键分配槽位
+ *
+ * @param[in] hashes 各键的哈希值
+ * @param[out] pilots 各桶的位移参数
+ * @param[out] slot_key 各槽位对应的键序号
+ * @return bool 所有桶都找到位移参数时返回true
+ */
+static bool mo_mph_assign(const uint64_t* hashes, uint32_t n, uint32_t num_buckets,
+                          uint32_t num_slots, uint16_t* pilots, uint32_t* slot_key)
+{
+    bool result = false;
+    uint32_t* bucket_start = NULL;
+    uint32_t* bucket_keys = NULL;
+    uint32_t* order = NULL;
+    uint32_t* size_start = NULL;
+    uint32_t* positions = NULL;
+    uint32_t max_size = 0;
+    
+    bucket_start = (uint32_t*)calloc((size_t)num_buckets + 1, sizeof(uint32_t));
+    bucket_keys = (uint32_t*)malloc(((size_t)n + 1) * sizeof(uint32_t));
+    order = (uint32_t*)malloc((size_t)num_buckets * sizeof(uint32_t));
+    if (!bucket_start || !bucket_keys || !order)
+    {
+        goto cleanup;
+    }
+    
+    /* 按桶分组（计数排序） */
+    for (uint32_t i = 0; i < n; i++)
+    {
+        bucket_start[mo_mph_bucket(hashes[i], num_buckets) + 1]++;
+    }
+    for (uint32_t b = 0; b < num_buckets; b++)
+    {
+        if (bucket_start[b + 1] > max_size)
+        {
+            max_size = bucket_start[b + 1];
+        }
+        bucket_start[b + 1] += bucket_start[b];
+    }
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t b = mo_mph_bucket(hashes[i], num_buckets);
+        bucket_keys[bucket_start[b]++] = i;
+    }
+    for (uint32_t b = num_buckets; b > 0; b--)
+    {
+        bucket_start[b] = bucket_start[b - 1];
+    }
+    bucket_start[0] = 0;
+    
+    /* 桶按大小降序处理，大桶在槽位空闲时更容易放下 */
+    size_start = (uint32_t*)calloc((size_t)max_size + 2, sizeof(uint32_t));
+    positions = (uint32_t*)malloc(((size_t)max_size + 1) * sizeof(uint32_t));
+    if (!size_start || !positions)
+    {
+        goto cleanup;
+    }
+    for (uint32_t b = 0; b < num_buckets; b++)
+    {
+        size_start[max_size - (bucket_start[b + 1] - bucket_start[b]) + 1]++;
+    }
+    for (uint32_t s = 0; s <= max_size; s++)
+    {
+        size_start[s + 1] += size_start[s];
+    }
+    for (uint32_t b = 0; b < num_buckets; b++)
+    {
+        order[size_start[max_size - (bucket_start[b + 1] - bucket_start[b])]++] = b;
+    }
+    
+    for (uint32_t s = 0; s < num_slots; s++)
+    {
+        slot_key[s] = MO_INDEX_NONE;
+    }
+    
+    for (uint32_t o = 0; o < num_buckets; o++)
+    {
+        uint32_t b = order[o];
+        uint32_t first = bucket_start[b];
+        uint32_t count = bucket_start[b + 1] - first;
+        uint32_t pilot;
+    
+        pilots[b] = 0;
+        if (count == 0)
+        {
+            continue;
+        }
+    
+        for (pilot = 0; pilot <= MO_MPH_MAX_PILOT; pilot++)
+        {
+            uint32_t k;
+    
+            for (k = 0; k < count; k++)
+            {
+                uint32_t pos = mo_mph_position(hashes[bucket_keys[first + k]], pilot, num_slots);
+                if (slot_key[pos] != MO_INDEX_NONE)
+                {
+                    break;
+                }
+    
+                /* 暂时占用，失败时撤销 */
+                slot_key[pos] = bucket_keys[first + k];
+                positions[k] = pos;
+            }
+    
+            if (k == count)
+            {
+                break;
+            }
+    
+            while (k > 0)
+            {
+                slot_key[positions[--k]] = MO_INDEX_NONE;
+            }
+        }
+    
+        if (pilot > MO_MPH_MAX_PILOT)
+        {
+            goto cleanup;
+        }
+        pilots[b] = (uint16_t)pilot;
+    }
+    
+    result = true;
+    
+cleanup:
+    free(bucket_start);
+    free(bucket_keys);
+    free(order);
+    free(size_start);
+    free(positions);
+    return result;
+}
+
+/**
+ * @brief 按目标字节序写出32位整数数组
+ */
+static bool mo_mph_write_words(FILE* file, const uint32_t* words, size_t count, bool swap)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t word = mo_swap_uint32(words[i], swap);
+        if (fwrite(&word, sizeof(word), 1, file) != 1)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 为目录构建最小完美哈希并写入新文件
+ */
+static mo_error_t mo_do_save_mph(const mo_context_t* context, const char* filename)
+{
+    mo_error_t result = MO_SUCCESS;
+    mo_mph_key_t* keys = NULL;
+    uint32_t* duplicates = NULL;
+    uint64_t* hashes = NULL;
+    uint16_t* pilots = NULL;
+    uint32_t* slot_key = NULL;
+    uint32_t* words = NULL;
+    FILE* file = NULL;
+    mo_mph_footer_t footer;
+    uint64_t seed = 0;
+    uint32_t attempt;
+    bool built = false;
+    
+    /* 分页读取的目录没有载入内存的数据可供复制 */
+    if (!context || !filename || context->paged)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    /* 已带有哈希段时只保留原MO数据 */
+    size_t mo_size = mo_mph_data_size(context);
+    if (mo_size > UINT32_MAX - 3)
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    uint32_t section_offset = (uint32_t)((mo_size + 3) & ~(size_t)3);
+    uint32_t total = context->num_strings;
+    
+    keys = (mo_mph_key_t*)malloc(((size_t)total + 1) * sizeof(mo_mph_key_t));
+    duplicates = (uint32_t*)malloc(((size_t)total + 1) * sizeof(uint32_t));
+    if (!keys || !duplicates)
+    {
+        result = MO_ERROR_MEMORY;
+        goto cleanup;
+    }
+    
+    for (uint32_t i = 0; i < total; i++)
+    {
+        uint32_t len;
+        const char* key = mo_entry_key(context, i, &len);
+        keys[i].hash = mo_hash_bytes(key, len);
+        keys[i].index = i;
+    }
+    
+    /* 哈希值相同的键只保留第一个参与完美哈希，其余放入溢出表 */
+    qsort(keys, total, sizeof(mo_mph_key_t), mo_mph_compare_keys);
+    uint32_t n = 0;
+    uint32_t num_overflow = 0;
+    for (uint32_t i = 0; i < total; i++)
+    {
+        if (n > 0 && keys[n - 1].hash == keys[i].hash)
+        {
+            duplicates[num_overflow++] = keys[i].index;
+            continue;
+        }
+        keys[n++] = keys[i];
+    }
+    
+    uint32_t num_buckets = n / MO_MPH_BUCKET_SIZE + 1;
+    uint32_t num_slots = n + n / 32 + 1;
+    
+    /* 序号表、重定向表和溢出表连续写出 */
+    hashes = (uint64_t*)malloc(((size_t)n + 1) * sizeof(uint64_t));
+    pilots = (uint16_t*)calloc((size_t)num_buckets + 1, sizeof(uint16_t));
+    slot_key = (uint32_t*)malloc((size_t)num_slots * sizeof(uint32_t));
+    words = (uint32_t*)malloc(((size_t)num_slots + num_overflow) * sizeof(uint32_t));
+    if (!hashes || !pilots || !slot_key || !words)
+    {
+        result = MO_ERROR_MEMORY;
+        goto cleanup;
+    }
+    
+    /* 种子不合适时（最后几个桶找不到空闲槽位）更换种子重试 */
+    for (attempt = 0; attempt < MO_MPH_MAX_SEEDS && !built; attempt++)
+    {
+        seed = mo_mph_mix(MO_MPH_SEED_BASE + attempt);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            hashes[i] = mo_mph_key_hash(keys[i].hash, seed);
+        }
+        built = mo_mph_assign(hashes, n, num_buckets, num_slots, pilots, slot_key);
+    }
+    
+    if (!built)
+    {
+        mo_log(context, "Failed to build perfect hash for %u keys", n);
+        result = MO_ERROR_INVALID_FORMAT;
+        goto cleanup;
+    }
+    
+    /* [0, n)内的槽位直接记录字符串序号，超出部分重定向到[0, n)内的空闲槽位 */
+    uint32_t* index = words;
+    uint32_t* remap = words + n;
+    uint32_t* overflow = words + num_slots;
+    uint32_t free_slot = 0;
+    for (uint32_t s = 0; s < n; s++)
+    {
+        index[s] = slot_key[s] != MO_INDEX_NONE ? keys[slot_key[s]].index : MO_INDEX_NONE;
+    }
+    for (uint32_t s = n; s < num_slots; s++)
+    {
+        remap[s - n] = 0;
+        if (slot_key[s] == MO_INDEX_NONE)
+        {
+            continue;
+        }
+        while (index[free_slot] != MO_INDEX_NONE)
+        {
+            free_slot++;
+        }
+        index[free_slot] = keys[slot_key[s]].index;
+        remap[s - n] = free_slot;
+    }
+    
+    memcpy(overflow, duplicates, (size_t)num_overflow * sizeof(uint32_t));
+    
+    file = fopen(filename, "wb");
+    if (!file)
+    {
+        result = MO_ERROR_IO;
+        goto cleanup;
+    }
+    
+    static const uint8_t padding[4] = {0, 0, 0, 0};
+    size_t pilots_size = (size_t)num_buckets * sizeof(uint16_t);
+    size_t pilots_padding = (4 - pilots_size % 4) % 4;
+    
+    for (uint32_t b = 0; b < num_buckets; b++)
+    {
+        pilots[b] = mo_swap_uint16(pilots[b], context->need_swap);
+    }
+    
+    footer.section_offset = section_offset;
+    footer.num_keys = n;
+    footer.num_overflow = num_overflow;
+    footer.num_buckets = num_buckets;
+    footer.num_slots = num_slots;
+    footer.seed_lo = (uint32_t)seed;
+    footer.seed_hi = (uint32_t)(seed >> 32);
+    footer.hash_version = MO_MPH_HASH_VERSION;
+    footer.magic = MO_MPH_MAGIC;
+    
+    if (fwrite(context->data, 1, mo_size, file) != mo_size ||
+        fwrite(padding, 1, section_offset - mo_size, file) != section_offset - mo_size ||
+        !mo_mph_write_words(file, words, (size_t)num_slots + num_overflow, context->need_swap) ||
+        fwrite(pilots, 1, pilots_size, file) != pilots_size ||
+        fwrite(padding, 1, pilots_padding, file) != pilots_padding ||
+        !mo_mph_write_words(file, (const uint32_t*)&footer,
+                            sizeof(footer) / sizeof(uint32_t), context->need_swap))
+    {
+        result = MO_ERROR_IO;
+        goto cleanup;
+    }
+    
+    mo_log(context, "Perfect hash written: keys=%u, overflow=%u, buckets=%u, slots=%u, attempts=%u",
+           n, num_overflow, num_buckets, num_slots, attempt);
+    
+cleanup:
+    if (file && fclose(file) != 0 && result == MO_SUCCESS)
+    {
+        result = MO_ERROR_IO;
+    }
+    if (file && result != MO_SUCCESS)
+    {
+        /* 不留下不完整的输出文件 */
+        remove(filename);
+    }
+    free(keys);
+    free(duplicates);
+    free(hashes);
+    free(pilots);
+    free(slot_key);
+    free(words);
+    return result;
+}
+
+/**
+ * @brief 为目录构建最小完美哈希并写入新文件（在读取区间内使用当前目录）
+ */
+mo_error_t mo_context_save_mph(const mo_context_t* context, const char* filename)
+{
+    mo_error_t result;
+    
+    if (!context || !filename)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    mo_read_begin();
+    result = mo_do_save_mph(mo_context_current(context), filename);
+    mo_read_end();
+    return result;
+}
+
+const mo_search_ops_t mo_search_mph = {
+    MO_SEARCH_MPH,
+    "MPH",
+    mo_load_mph,
+    mo_hash_bytes,
+    mo_hash_cstr,
+    mo_hash_key,
+    mo_find_string_mph,
+    mo_release_mph,
+    mo_prefetch_mph,
+    NULL,
+    NULL
+};
@@ -0,0 +1,235 @@
+/**
+ * @file mo_watch.c
+ * @brief 基于inotify的MO文件监视与自动重载
+ */
+
+#include "mo_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+/* 监视状态 */
+struct mo_watch {
+    mo_context_t* context;          /**< 被监视的上下文 */
+    mo_reload_callback_t callback;  /**< 重载完成回调 */
+    void* user_data;                /**< 回调用户数据 */
+    const char* name;               /**< 文件名（不含目录），指向context->filename */
+    int inotify_fd;                 /**< inotify实例 */
+    int stop_pipe[2];               /**< 通知监视线程退出 */
+    pthread_t thread;               /**< 监视线程 */
+};
+
+/**
+ * @brief 读出所有待处理事件，返回其中是否有被监视文件的变化
+ */
+static bool mo_watch_drain(const mo_watch_t* watch)
+{
+    union {
+        struct inotify_event event;
+        char bytes[4096];
+    } buffer;
+    bool changed = false;
+    
+    for (;;)
+    {
+        ssize_t len = read(watch->inotify_fd, buffer.bytes, sizeof(buffer.bytes));
+        if (len <= 0)
+        {
+            break;
+        }
+    
+        for (ssize_t pos = 0; pos < len; )
+        {
+            const struct inotify_event* event = (const struct inotify_event*)(buffer.bytes + pos);
+            if (event->len > 0 && strcmp(event->name, watch->name) == 0)
+            {
+                changed = true;
+            }
+            pos += (ssize_t)(sizeof(struct inotify_event) + event->len);
+        }
+    }
+    
+    return changed;
+}
+
+/**
+ * @brief 监视线程：等待文件变化并重载
+ */
+static void* mo_watch_thread(void* param)
+{
+    mo_watch_t* watch = (mo_watch_t*)param;
+    
+    for (;;)
+    {
+        struct pollfd fds[2] = {
+            { watch->inotify_fd, POLLIN, 0 },
+            { watch->stop_pipe[0], POLLIN, 0 },
+        };
+    
+        if (poll(fds, 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+    
+        if (fds[1].revents)
+        {
+            break;
+        }
+    
+        /* 一次写入可能产生多个事件，合并为一次重载 */
+        if ((fds[0].revents & POLLIN) && mo_watch_drain(watch))
+        {
+            mo_error_t result = mo_context_reload(watch->context);
+            if (watch->callback)
+            {
+                watch->callback(watch->context, result, watch->user_data);
+            }
+        }
+    }
+    
+    return NULL;
+}
+
+/**
+ * @brief 开始监视
+ */
+mo_error_t mo_watch_start(mo_context_t* context, mo_reload_callback_t callback,
+                          void* user_data, mo_watch_t** watch)
+{
+    mo_error_t result = MO_ERROR_IO;
+    mo_watch_t* w = NULL;
+    char* dir = NULL;
+    const char* slash;
+    
+    if (!context || context->is_static || !context->filename || !watch)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    w = (mo_watch_t*)calloc(1, sizeof(mo_watch_t));
+    if (!w)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    w->context = context;
+    w->callback = callback;
+    w->user_data = user_data;
+    w->inotify_fd = -1;
+    w->stop_pipe[0] = -1;
+    w->stop_pipe[1] = -1;
+    
+    /* 监视所在目录而不是文件本身，以便发现重命名替换 */
+    slash = strrchr(context->filename, '/');
+    if (slash)
+    {
+        size_t len = (size_t)(slash - context->filename);
+        dir = (char*)malloc(len + 2);
+        if (!dir)
+        {
+            result = MO_ERROR_MEMORY;
+            goto cleanup;
+        }
+        memcpy(dir, context->filename, len);
+        dir[len] = len == 0 ? '/' : '\0';
+        dir[len + 1] = '\0';
+        w->name = slash + 1;
+    }
+    else
+    {
+        w->name = context->filename;
+    }
+    
+    w->inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (w->inotify_fd < 0 ||
+        inotify_add_watch(w->inotify_fd, dir ? dir : ".", IN_CLOSE_WRITE | IN_MOVED_TO) < 0 ||
+        pipe(w->stop_pipe) != 0)
+    {
+        goto cleanup;
+    }
+    
+    if (pthread_create(&w->thread, NULL, mo_watch_thread, w) != 0)
+    {
+        goto cleanup;
+    }
+    
+    free(dir);
+    *watch = w;
+    return MO_SUCCESS;
+    
+cleanup:
+    if (w->inotify_fd >= 0)
+    {
+        close(w->inotify_fd);
+    }
+    if (w->stop_pipe[0] >= 0)
+    {
+        close(w->stop_pipe[0]);
+        close(w->stop_pipe[1]);
+    }
+    free(dir);
+    free(w);
+    return result;
+}
+
+/**
+ * @brief 停止监视
+ */
+void mo_watch_stop(mo_watch_t* watch)
+{
+    char signal = 1;
+    
+    if (!watch)
+    {
+        return;
+    }
+    
+    if (write(watch->stop_pipe[1], &signal, 1) == 1)
+    {
+        pthread_join(watch->thread, NULL);
+    }
+    else
+    {
+        pthread_cancel(watch->thread);
+        pthread_join(watch->thread, NULL);
+    }
+    
+    close(watch->inotify_fd);
+    close(watch->stop_pipe[0]);
+    close(watch->stop_pipe[1]);
+    free(watch);
+}
+
+#else
+
+/**
+ * @brief 开始监视（当前平台不支持inotify）
+ */
+mo_error_t mo_watch_start(mo_context_t* context, mo_reload_callback_t callback,
+                          void* user_data, mo_watch_t** watch)
+{
+    (void)context;
+    (void)callback;
+    (void)user_data;
+    (void)watch;
+    return MO_ERROR_IO;
+}
+
+/**
+ * @brief 停止监视
+ */
+void mo_watch_stop(mo_watch_t* watch)
+{
+    (void)watch;
+}
+
+#endif
@@ -0,0 +1,724 @@
+/**
+ * @file mo_writer.c
+ * @brief MO文件编译器实现
+ *
+ * 加入的条目以MO文件中的形式（"msgctxt\004msgid\0msgid_plural"与以NUL分隔的
+ * msgstr[n]）依次追加到一块字符串池中。写出时按查找键排序得到字符串表，用
+ * hashpjw建立与GNU gettext相同的双重哈希表，再把字符串按热度重新排列：标记为
+ * 常用的条目在前，每个条目的原文紧接着翻译，一次命中的查找（比较原文、返回
+ * 翻译）只访问同一段连续的字节。
+ */
+
+#include "mo_writer.h"
+#include "mo_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 哈希表大小的候选素数个数，取探测次数最少的一个 */
+#define MO_WRITER_HASH_CANDIDATES 8
+
+/* 已加入的条目，原文和翻译相邻存放在字符串池中 */
+typedef struct {
+    size_t offset;          /**< 原文在字符串池中的偏移，翻译紧随原文的结尾NUL */
+    uint32_t orig_len;      /**< 原文长度（含复数原文，不含结尾NUL） */
+    uint32_t key_len;       /**< 查找键长度（原文中第一个NUL之前的部分） */
+    uint32_t trans_len;     /**< 翻译长度（含各复数形式，不含结尾NUL） */
+} mo_writer_item_t;
+
+/* 常用条目的查找键，存放在字符串池中 */
+typedef struct {
+    size_t offset;
+    uint32_t len;
+} mo_writer_hot_t;
+
+/* 排序时使用的查找键 */
+typedef struct {
+    const char* key;
+    uint32_t len;
+    uint32_t item;          /**< 条目序号 */
+} mo_writer_key_t;
+
+/* MO文件编译器 */
+struct mo_writer {
+    char* pool;                 /**< 字符串池 */
+    size_t pool_size;
+    size_t pool_capacity;
+    mo_writer_item_t* items;    /**< 按加入顺序排列的条目 */
+    uint32_t count;
+    uint32_t capacity;
+    mo_writer_hot_t* hot;       /**< 按标记顺序排列的常用条目 */
+    uint32_t hot_count;
+    uint32_t hot_capacity;
+};
+
+static mo_error_t mo_writer_reserve(mo_writer_t* writer, size_t bytes);
+static mo_error_t mo_writer_commit(mo_writer_t* writer, size_t orig_len, size_t trans_len);
+static size_t mo_writer_strip_creation_date(char* header, size_t len);
+static int mo_writer_compare_keys(const void* a, const void* b);
+static uint32_t mo_writer_find_key(const mo_writer_key_t* keys, uint32_t count,
+                                   const char* key, uint32_t len);
+static bool mo_writer_is_prime(uint32_t value);
+static uint32_t mo_writer_hash_insert(uint32_t* table, uint32_t size, uint32_t hash, uint32_t value);
+static mo_error_t mo_writer_hash_size(const uint32_t* hashes, uint32_t count, uint32_t* size);
+
+/**
+ * @brief 确保字符串池末尾还有bytes字节的空间
+ */
+static mo_error_t mo_writer_reserve(mo_writer_t* writer, size_t bytes)
+{
+    if (bytes > SIZE_MAX - writer->pool_size)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    if (writer->pool_size + bytes <= writer->pool_capacity)
+    {
+        return MO_SUCCESS;
+    }
+    
+    size_t capacity = writer->pool_capacity ? writer->pool_capacity : 4096;
+    while (capacity < writer->pool_size + bytes)
+    {
+        capacity = capacity > SIZE_MAX / 2 ? writer->pool_size + bytes : capacity * 2;
+    }
+    
+    char* pool = (char*)realloc(writer->pool, capacity);
+    if (!pool)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    writer->pool = pool;
+    writer->pool_capacity = capacity;
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 删除头部中的POT-Creation-Date行，返回新的长度
+ *
+ * @note 与msgfmt相同：模板的生成时间与翻译无关，删去后由同一份翻译生成的文件
+ *       内容不随模板重新生成而改变。
+ */
+static size_t mo_writer_strip_creation_date(char* header, size_t len)
+{
+    static const char field[] = "POT-Creation-Date:";
+    size_t line = 0;
+    
+    while (line < len)
+    {
+        const char* eol = (const char*)memchr(header + line, '\n', len - line);
+        size_t next = eol ? (size_t)(eol - header) + 1 : len;
+    
+        if (next - line >= sizeof(field) - 1 && memcmp(header + line, field, sizeof(field) - 1) == 0)
+        {
+            memmove(header + line, header + next, len - next);
+            return len - (next - line);
+        }
+        line = next;
+    }
+    return len;
+}
+
+/**
+ * @brief 把已写到字符串池末尾的原文和翻译登记为一个条目
+ *
+ * @note 调用前原文（含结尾NUL）和翻译（含结尾NUL）已依次写入pool + pool_size。
+ *       msgstr[0]为空的条目不登记，写入的字节随之丢弃；头部条目删去POT-Creation-Date行。
+ */
+static mo_error_t mo_writer_commit(mo_writer_t* writer, size_t orig_len, size_t trans_len)
+{
+    const char* original = writer->pool + writer->pool_size;
+    const char* nul;
+    
+    if (orig_len > UINT32_MAX || trans_len > UINT32_MAX)
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    if (original[orig_len + 1] == '\0')
+    {
+        return MO_SUCCESS;
+    }
+    if (orig_len == 0)
+    {
+        char* header = writer->pool + writer->pool_size + 1;
+        trans_len = mo_writer_strip_creation_date(header, trans_len);
+        header[trans_len] = '\0';
+    }
+    
+    if (writer->count == writer->capacity)
+    {
+        uint32_t capacity = writer->capacity ? writer->capacity * 2 : 64;
+        mo_writer_item_t* items = (mo_writer_item_t*)realloc(writer->items,
+                                                             capacity * sizeof(mo_writer_item_t));
+        if (!items)
+        {
+            return MO_ERROR_MEMORY;
+        }
+        writer->items = items;
+        writer->capacity = capacity;
+    }
+    
+    mo_writer_item_t* item = &writer->items[writer->count++];
+    nul = (const char*)memchr(original, '\0', orig_len);
+    item->offset = writer->pool_size;
+    item->orig_len = (uint32_t)orig_len;
+    item->key_len = nul ? (uint32_t)(nul - original) : (uint32_t)orig_len;
+    item->trans_len = (uint32_t)trans_len;
+    writer->pool_size += orig_len + 1 + trans_len + 1;
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 创建空的编译器
+ */
+mo_error_t mo_writer_create(mo_writer_t** writer)
+{
+    if (!writer)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    *writer = (mo_writer_t*)calloc(1, sizeof(mo_writer_t));
+    return *writer ? MO_SUCCESS : MO_ERROR_MEMORY;
+}
+
+/**
+ * @brief 释放编译器
+ */
+void mo_writer_free(mo_writer_t* writer)
+{
+    if (!writer)
+    {
+        return;
+    }
+    
+    free(writer->pool);
+    free(writer->items);
+    free(writer->hot);
+    free(writer);
+}
+
+/**
+ * @brief 加入一个条目
+ */
+mo_error_t mo_writer_add(mo_writer_t* writer, const char* msgctxt, const char* msgid,
+                         const char* msgid_plural, const char* const* msgstr, uint32_t count)
+{
+    size_t ctxt_len = msgctxt ? strlen(msgctxt) : 0;
+    size_t id_len;
+    size_t plural_len = msgid_plural ? strlen(msgid_plural) : 0;
+    size_t orig_len;
+    size_t trans_len = 0;
+    mo_error_t result;
+    uint32_t i;
+    
+    if (!writer || !msgid || !msgstr || count == 0 || (!msgid_plural && count != 1))
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    for (i = 0; i < count; i++)
+    {
+        if (!msgstr[i])
+        {
+            return MO_ERROR_INVALID_CONTEXT;
+        }
+        trans_len += strlen(msgstr[i]) + 1;
+    }
+    trans_len--;
+    
+    id_len = strlen(msgid);
+    orig_len = (msgctxt ? ctxt_len + 1 : 0) + id_len + (msgid_plural ? plural_len + 1 : 0);
+    result = mo_writer_reserve(writer, orig_len + 1 + trans_len + 1);
+    if (result != MO_SUCCESS)
+    {
+        return result;
+    }
+    
+    char* out = writer->pool + writer->pool_size;
+    if (msgctxt)
+    {
+        memcpy(out, msgctxt, ctxt_len);
+        out += ctxt_len;
+        *out++ = MO_CONTEXT_SEPARATOR;
+    }
+    memcpy(out, msgid, id_len + 1);
+    out += id_len + 1;
+    if (msgid_plural)
+    {
+        memcpy(out, msgid_plural, plural_len + 1);
+        out += plural_len + 1;
+    }
+    for (i = 0; i < count; i++)
+    {
+        size_t len = strlen(msgstr[i]);
+        memcpy(out, msgstr[i], len + 1);
+        out += len + 1;
+    }
+    
+    return mo_writer_commit(writer, orig_len, trans_len);
+}
+
+/**
+ * @brief 加入已加载目录中的全部条目（在读取区间内使用当前目录）
+ */
+mo_error_t mo_writer_add_catalog(mo_writer_t* writer, const mo_context_t* context)
+{
+    mo_error_t result = MO_SUCCESS;
+    const mo_context_t* ctx;
+    const mo_string_entry_t* trans_table = NULL;
+    
+    if (!writer || !context)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    mo_read_begin();
+    ctx = mo_context_current(context);
+    
+    /* 分页读取的目录没有载入内存的数据可供复制 */
+    if (ctx->paged)
+    {
+        result = MO_ERROR_INVALID_CONTEXT;
+        goto cleanup;
+    }
+    
+    /* 转换过编码的目录从文件数据中取原始翻译，与头部声明的字符集保持一致 */
+    if (ctx->trans_data != ctx->data)
+    {
+        trans_table = (const mo_string_entry_t*)(ctx->data + ctx->header.trans_table_offset);
+    }
+    
+    for (uint32_t i = 0; i < ctx->num_strings && result == MO_SUCCESS; i++)
+    {
+        uint32_t orig_len;
+        uint32_t trans_len;
+        const char* original = mo_entry_original(ctx, i, &orig_len);
+        const char* translation;
+    
+        if (trans_table)
+        {
+            trans_len = mo_swap_uint32(trans_table[i].length, ctx->need_swap);
+            translation = (const char*)ctx->data + mo_swap_uint32(trans_table[i].offset, ctx->need_swap);
+        }
+        else
+        {
+            translation = mo_entry_translation(ctx, i, &trans_len);
+        }
+    
+        result = mo_writer_reserve(writer, (size_t)orig_len + 1 + (size_t)trans_len + 1);
+        if (result != MO_SUCCESS)
+        {
+            break;
+        }
+        char* out = writer->pool + writer->pool_size;
+        memcpy(out, original, orig_len);
+        out[orig_len] = '\0';
+        memcpy(out + orig_len + 1, translation, trans_len);
+        out[orig_len + 1 + trans_len] = '\0';
+        result = mo_writer_commit(writer, orig_len, trans_len);
+    }
+    
+cleanup:
+    mo_read_end();
+    return result;
+}
+
+/**
+ * @brief 解析.po文件并加入其中的全部条目
+ */
+mo_error_t mo_writer_add_po(mo_writer_t* writer, const char* filename)
+{
+    mo_options_t options;
+    mo_context_t* ctx = NULL;
+    mo_error_t result;
+    
+    if (!writer || !filename)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    /* 只需复制条目：不建立索引，也不转换编码 */
+    mo_options_init(&options);
+    options.search_method = MO_SEARCH_LINEAR;
+    options.keep_charset = true;
+    
+    result = mo_context_create_from_po(filename, &options, &ctx);
+    if (result == MO_SUCCESS)
+    {
+        result = mo_writer_add_catalog(writer, ctx);
+    }
+    mo_context_free(ctx);
+    return result;
+}
+
+/**
+ * @brief 标记一个常用条目
+ */
+mo_error_t mo_writer_add_hot(mo_writer_t* writer, const char* msgctxt, const char* msgid)
+{
+    size_t ctxt_len = msgctxt ? strlen(msgctxt) : 0;
+    size_t len;
+    mo_error_t result;
+    
+    if (!writer || !msgid)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    
+    len = (msgctxt ? ctxt_len + 1 : 0) + strlen(msgid);
+    if (len > UINT32_MAX)
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    
+    if (writer->hot_count == writer->hot_capacity)
+    {
+        uint32_t capacity = writer->hot_capacity ? writer->hot_capacity * 2 : 16;
+        mo_writer_hot_t* hot = (mo_writer_hot_t*)realloc(writer->hot, capacity * sizeof(mo_writer_hot_t));
+        if (!hot)
+        {
+            return MO_ERROR_MEMORY;
+        }
+        writer->hot = hot;
+        writer->hot_capacity = capacity;
+    }
+    
+    result = mo_writer_reserve(writer, len);
+    if (result != MO_SUCCESS)
+    {
+        return result;
+    }
+    
+    char* out = writer->pool + writer->pool_size;
+    if (msgctxt)
+    {
+        memcpy(out, msgctxt, ctxt_len);
+        out[ctxt_len] = MO_CONTEXT_SEPARATOR;
+        out += ctxt_len + 1;
+    }
+    memcpy(out, msgid, strlen(msgid));
+    
+    writer->hot[writer->hot_count].offset = writer->pool_size;
+    writer->hot[writer->hot_count].len = (uint32_t)len;
+    writer->hot_count++;
+    writer->pool_size += len;
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 返回已加入的条目数
+ */
+uint32_t mo_writer_count(const mo_writer_t* writer)
+{
+    return writer ? writer->count : 0;
+}
+
+/**
+ * @brief 按字节序比较查找键，与msgfmt的strcmp排序一致
+ */
+static int mo_writer_compare_keys(const void* a, const void* b)
+{
+    const mo_writer_key_t* x = (const mo_writer_key_t*)a;
+    const mo_writer_key_t* y = (const mo_writer_key_t*)b;
+    int cmp = memcmp(x->key, y->key, x->len < y->len ? x->len : y->len);
+    
+    if (cmp != 0)
+    {
+        return cmp;
+    }
+    return x->len < y->len ? -1 : (x->len > y->len ? 1 : 0);
+}
+
+/**
+ * @brief 在排好序的键中二分查找，返回位置，不存在时返回MO_INDEX_NONE
+ */
+static uint32_t mo_writer_find_key(const mo_writer_key_t* keys, uint32_t count,
+                                   const char* key, uint32_t len)
+{
+    mo_writer_key_t probe = { key, len, 0 };
+    const mo_writer_key_t* found = (const mo_writer_key_t*)bsearch(&probe, keys, count,
+                                                                   sizeof(mo_writer_key_t),
+                                                                   mo_writer_compare_keys);
+    return found ? (uint32_t)(found - keys) : MO_INDEX_NONE;
+}
+
+/**
+ * @brief 判断是否为素数（哈希表大小须为素数，双重哈希的探测序列才能遍历全表）
+ */
+static bool mo_writer_is_prime(uint32_t value)
+{
+    if (value < 4)
+    {
+        return value >= 2;
+    }
+    if (value % 2 == 0)
+    {
+        return false;
+    }
+    for (uint32_t d = 3; d <= value / d; d += 2)
+    {
+        if (value % d == 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 按GNU gettext的探测序列插入哈希表，返回探测的槽位数
+ */
+static uint32_t mo_writer_hash_insert(uint32_t* table, uint32_t size, uint32_t hash, uint32_t value)
+{
+    uint32_t index = hash % size;
+    uint32_t incr = 1 + (hash % (size - 2));
+    uint32_t probes = 1;
+    
+    while (table[index] != 0)
+    {
+        index = index >= size - incr ? index - (size - incr) : index + incr;
+        probes++;
+    }
+    table[index] = value;
+    return probes;
+}
+
+/**
+ * @brief 选定哈希表大小
+ *
+ * @note 与msgfmt相同，负载不超过3/4：取不小于条目数4/3的第一个素数，再在其后1/8
+ *       的范围内试插入至多若干个素数大小，取命中查找总探测次数最少的一个。
+ */
+static mo_error_t mo_writer_hash_size(const uint32_t* hashes, uint32_t count, uint32_t* size)
+{
+    uint64_t start = (uint64_t)count * 4 / 3;
+    uint32_t candidates[MO_WRITER_HASH_CANDIDATES];
+    uint64_t best_probes = UINT64_MAX;
+    uint32_t* table;
+    uint32_t candidate;
+    uint32_t limit = 0;
+    int found = 0;
+    
+    if (start > UINT32_MAX / 2)
+    {
+        return MO_ERROR_INVALID_FORMAT;
+    }
+    
+    for (candidate = start < 3 ? 3 : (uint32_t)start;
+         found < MO_WRITER_HASH_CANDIDATES && (found == 0 || candidate <= limit); candidate++)
+    {
+        if (mo_writer_is_prime(candidate))
+        {
+            /* 范围从第一个素数起算，不随之后找到的素数后移 */
+            if (found == 0)
+            {
+                limit = candidate + candidate / 8;
+            }
+            candidates[found++] = candidate;
+        }
+    }
+    
+    /* 只有一个候选大小时不必试插入 */
+    *size = candidates[0];
+    if (found == 1 || count < 2)
+    {
+        return MO_SUCCESS;
+    }
+    
+    table = (uint32_t*)malloc((size_t)candidates[found - 1] * sizeof(uint32_t));
+    if (!table)
+    {
+        return MO_ERROR_MEMORY;
+    }
+    
+    for (int c = 0; c < found; c++)
+    {
+        uint64_t probes = 0;
+    
+        memset(table, 0, (size_t)candidates[c] * sizeof(uint32_t));
+        for (uint32_t i = 0; i < count && probes < best_probes; i++)
+        {
+            probes += mo_writer_hash_insert(table, candidates[c], hashes[i], i + 1);
+        }
+        if (probes < best_probes)
+        {
+            best_probes = probes;
+            *size = candidates[c];
+        }
+    }
+    
+    mo_log(NULL, "Hash table size %u: %.3f probes per hit", *size, (double)best_probes / count);
+    free(table);
+    return MO_SUCCESS;
+}
+
+/**
+ * @brief 写出MO文件
+ */
+mo_error_t mo_writer_save(const mo_writer_t* writer, const char* filename)
+{
+    mo_error_t result = MO_SUCCESS;
+    mo_writer_key_t* keys = NULL;
+    uint32_t* hashes = NULL;
+    uint32_t* order = NULL;
+    uint8_t* placed = NULL;
+    uint8_t* image = NULL;
+    FILE* file = NULL;
+    uint32_t hash_size = 0;
+    uint32_t num_hot = 0;
+    uint32_t n;
+    uint32_t i;
+    
+    if (!writer || !filename)
+    {
+        return MO_ERROR_INVALID_CONTEXT;
+    }
+    n = writer->count;
+    
+    keys = (mo_writer_key_t*)malloc(((size_t)n + 1) * sizeof(mo_writer_key_t));
+    hashes = (uint32_t*)malloc(((size_t)n + 1) * sizeof(uint32_t));
+    order = (uint32_t*)malloc(((size_t)n + 1) * sizeof(uint32_t));
+    placed = (uint8_t*)calloc((size_t)n + 1, 1);
+    if (!keys || !hashes || !order || !placed)
+    {
+        result = MO_ERROR_MEMORY;
+        goto cleanup;
+    }
+    
+    /* 字符串表按查找键排序，同一个键出现两次时msgfmt同样报错 */
+    for (i = 0; i < n; i++)
+    {
+        keys[i].key = writer->pool + writer->items[i].offset;
+        keys[i].len = writer->items[i].key_len;
+        keys[i].item = i;
+    }
+    qsort(keys, n, sizeof(mo_writer_key_t), mo_writer_compare_keys);
+    for (i = 1; i < n; i++)
+    {
+        if (mo_writer_compare_keys(&keys[i - 1], &keys[i]) == 0)
+        {
+            mo_log(NULL, "Duplicate message definition: \"%.*s\"", (int)keys[i].len, keys[i].key);
+            result = MO_ERROR_INVALID_FORMAT;
+            goto cleanup;
+        }
+    }
+    
+    /* 字符串区的排列：常用条目按标记顺序在前，其余条目按字符串表顺序在后 */
+    for (i = 0; i < writer->hot_count; i++)
+    {
+        const mo_writer_hot_t* hot = &writer->hot[i];
+        uint32_t pos = mo_writer_find_key(keys, n, writer->pool + hot->offset, hot->len);
+        if (pos != MO_INDEX_NONE && !placed[pos])
+        {
+            placed[pos] = 1;
+            order[num_hot++] = pos;
+        }
+    }
+    uint32_t next = num_hot;
+    for (i = 0; i < n; i++)
+    {
+        if (!placed[i])
+        {
+            order[next++] = i;
+        }
+    }
+    
+    for (i = 0; i < n; i++)
+    {
+        hashes[i] = mo_hash_string_pjw(keys[i].key, keys[i].len);
+    }
+    result = mo_writer_hash_size(hashes, n, &hash_size);
+    if (result != MO_SUCCESS)
+    {
+        goto cleanup;
+    }
+    
+    /* 布局与msgfmt相同：头部、原文表、翻译表、哈希表、字符串区 */
+    uint64_t orig_table_offset = sizeof(mo_header_t);
+    uint64_t trans_table_offset = orig_table_offset + (uint64_t)n * sizeof(mo_string_entry_t);
+    uint64_t hash_table_offset = trans_table_offset + (uint64_t)n * sizeof(mo_string_entry_t);
+    uint64_t strings_offset = hash_table_offset + (uint64_t)hash_size * sizeof(uint32_t);
+    uint64_t total = strings_offset;
+    for (i = 0; i < n; i++)
+    {
+        const mo_writer_item_t* item = &writer->items[i];
+        total += (uint64_t)item->orig_len + 1 + (uint64_t)item->trans_len + 1;
+    }
+    if (total > UINT32_MAX)
+    {
+        result = MO_ERROR_INVALID_FORMAT;
+        goto cleanup;
+    }
+    
+    image = (uint8_t*)calloc(1, (size_t)total);
+    if (!image)
+    {
+        result = MO_ERROR_MEMORY;
+        goto cleanup;
+    }
+    
+    mo_header_t* header = (mo_header_t*)image;
+    mo_string_entry_t* orig_table = (mo_string_entry_t*)(image + orig_table_offset);
+    mo_string_entry_t* trans_table = (mo_string_entry_t*)(image + trans_table_offset);
+    uint32_t* hash_table = (uint32_t*)(image + hash_table_offset);
+    header->magic = MO_MAGIC;
+    header->revision = 0;
+    header->num_strings = n;
+    header->orig_table_offset = (uint32_t)orig_table_offset;
+    header->trans_table_offset = (uint32_t)trans_table_offset;
+    header->hash_table_size = hash_size;
+    header->hash_table_offset = (uint32_t)hash_table_offset;
+    
+    /* 每个条目的原文和翻译相邻写入，偏移记录到按键排序的字符串表中 */
+    size_t pos = (size_t)strings_offset;
+    for (i = 0; i < n; i++)
+    {
+        uint32_t sorted = order[i];
+        const mo_writer_item_t* item = &writer->items[keys[sorted].item];
+        const char* original = writer->pool + item->offset;
+        size_t bytes = (size_t)item->orig_len + 1 + item->trans_len + 1;
+    
+        orig_table[sorted].length = item->orig_len;
+        orig_table[sorted].offset = (uint32_t)pos;
+        trans_table[sorted].length = item->trans_len;
+        trans_table[sorted].offset = (uint32_t)(pos + item->orig_len + 1);
+        memcpy(image + pos, original, bytes);
+        pos += bytes;
+    }
+    
+    for (i = 0; i < n; i++)
+    {
+        mo_writer_hash_insert(hash_table, hash_size, hashes[i], i + 1);
+    }
+    
+    file = fopen(filename, "wb");
+    if (!file)
+    {
+        result = MO_ERROR_IO;
+        goto cleanup;
+    }
+    if (fwrite(image, 1, (size_t)total, file) != (size_t)total)
+    {
+        result = MO_ERROR_IO;
+        goto cleanup;
+    }
+    
+    mo_log(NULL, "MO file written: strings=%u, hash size=%u, hot=%u, bytes=%zu",
+           n, hash_size, num_hot, (size_t)total);
+    
+cleanup:
+    if (file && fclose(file) != 0 && result == MO_SUCCESS)
+    {
+        result = MO_ERROR_IO;
+    }
+    if (file && result != MO_SUCCESS)
+    {
+        /* 不留下不完整的输出文件 */
+        remove(filename);
+    }
+    free(keys);
+    free(hashes);
+    free(order);
+    free(placed);
+    free(image);
+    return result;
+}
@@ -0,0 +1,362 @@
+/**
+ * @file mo_gen_c.c
+ * @brief 构建期工具：将MO/PO文件编译为常量C表
+ *
+ * 用法：mo_gen_c <input.mo|input.po> <name> <output.c> <output.h>
+ * 按扩展名区分输入，.po文件直接解析（无需先用msgfmt编译）。
+ *
+ * 生成的源文件包含字符串池、原文/翻译字符串表（与MO文件相同的长度和偏移）、
+ * 编译好的Plural-Forms字节码、头部元数据和最小完美哈希表，全部为const数据
+ * （位于.rodata/Flash），以及一个静态初始化的上下文mo_catalog_<name>，上下文只保存
+ * 指向这些常量的指针和查找缓存等可写状态（位于.data）。程序启动时无需文件IO、
+ * 内存分配和索引构建即可直接查找。
+ *
+ * 哈希值按库中与主机字节序无关的定义计算，完美哈希表以整数形式输出，由目标平台的
+ * 编译器决定字节序，生成的源文件可以交叉编译到字节序不同的平台。
+ *
+ * 生成的源文件依赖库的内部结构定义（mo_internal.h），必须与同一版本的库
+ * 一起编译，CMake函数mo_parser_add_catalog会处理这些依赖。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mo_internal.h"
+
+#define MO_GEN_BYTES_PER_LINE 16
+#define MO_GEN_WORDS_PER_LINE 8
+
+/**
+ * @brief 输出字节数组内容
+ */
+static void mo_gen_bytes(FILE* out, const uint8_t* data, size_t size)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        fprintf(out, "%s0x%02x,%s",
+                (i % MO_GEN_BYTES_PER_LINE) == 0 ? "    " : "",
+                data[i],
+                (i % MO_GEN_BYTES_PER_LINE) == MO_GEN_BYTES_PER_LINE - 1 || i + 1 == size ? "\n" : " ");
+    }
+}
+
+/**
+ * @brief 输出整数数组（C不允许空数组，为空时输出一个0）
+ */
+static void mo_gen_words(FILE* out, const char* type, const char* name, const char* suffix,
+                         const uint32_t* words, size_t count)
+{
+    fprintf(out, "static const %s mo_catalog_%s_%s[] = {\n", type, name, suffix);
+    if (count == 0)
+    {
+        fprintf(out, "    0\n");
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        fprintf(out, "%s%uu,%s",
+                (i % MO_GEN_WORDS_PER_LINE) == 0 ? "    " : "",
+                words[i],
+                (i % MO_GEN_WORDS_PER_LINE) == MO_GEN_WORDS_PER_LINE - 1 || i + 1 == count ? "\n" : " ");
+    }
+    fprintf(out, "};\n\n");
+}
+
+/**
+ * @brief 输出字符串表（长度和字符串在池中的偏移）
+ */
+static void mo_gen_table(FILE* out, const char* name, const char* suffix,
+                         const uint32_t* lengths, const uint32_t* offsets, size_t count)
+{
+    fprintf(out, "static const mo_string_entry_t mo_catalog_%s_%s[] = {\n", name, suffix);
+    if (count == 0)
+    {
+        fprintf(out, "    { 0, 0 }\n");
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        fprintf(out, "    { %uu, %uu },\n", lengths[i], offsets[i]);
+    }
+    fprintf(out, "};\n\n");
+}
+
+/**
+ * @brief 输出mo_metadata_t的一个字段（字符串字面量，非ASCII和特殊字符按八进制转义）
+ */
+static void mo_gen_field(FILE* out, const char* field, const char* value)
+{
+    fprintf(out, "    .%s = \"", field);
+    for (const unsigned char* p = (const unsigned char*)value; *p; p++)
+    {
+        if (*p < 0x20 || *p >= 0x7F || *p == '"' || *p == '\\' || *p == '?')
+        {
+            fprintf(out, "\\%03o", *p);
+        }
+        else
+        {
+            fputc(*p, out);
+        }
+    }
+    fprintf(out, "\",\n");
+}
+
+/**
+ * @brief 按主机字节序读出文件中的数组
+ */
+static uint32_t* mo_gen_load_words(const mo_context_t* ctx, const void* data, size_t count,
+                                   size_t width)
+{
+    uint32_t* words = (uint32_t*)malloc((count + 1) * sizeof(uint32_t));
+    if (!words)
+    {
+        return NULL;
+    }
+    
+    for (size_t i = 0; i < count; i++)
+    {
+        if (width == sizeof(uint16_t))
+        {
+            words[i] = mo_swap_uint16(((const uint16_t*)data)[i], ctx->need_swap);
+        }
+        else
+        {
+            words[i] = mo_swap_uint32(((const uint32_t*)data)[i], ctx->need_swap);
+        }
+    }
+    return words;
+}
+
+/**
+ * @brief 生成C源文件
+ *
+ * @param[in] ctx 已按MPH策略加载的上下文
+ */
+static int mo_gen_source(const mo_context_t* ctx, const char* name, FILE* out)
+{
+    int result = 1;
+    size_t table_size = ((size_t)ctx->num_strings + 1) * sizeof(uint32_t);
+    uint32_t* orig_lengths = NULL;
+    uint32_t* orig_offsets = NULL;
+    uint32_t* trans_lengths = NULL;
+    uint32_t* trans_offsets = NULL;
+    uint32_t* index = NULL;
+    uint32_t* overflow = NULL;
+    uint32_t* pilots = NULL;
+    size_t pool_size = 0;
+    uint32_t i;
+    
+    orig_lengths = (uint32_t*)malloc(table_size);
+    orig_offsets = (uint32_t*)malloc(table_size);
+    trans_lengths = (uint32_t*)malloc(table_size);
+    trans_offsets = (uint32_t*)malloc(table_size);
+    if (!orig_lengths || !orig_offsets || !trans_lengths || !trans_offsets)
+    {
+        goto cleanup;
+    }
+    
+    fprintf(out, "/* 由mo_gen_c生成，请勿手动修改 */\n\n");
+    fprintf(out, "#include \"mo_internal.h\"\n\n");
+    
+    /* 字符串池：各条目的完整msgid（含复数部分）和翻译依次存放，均以NUL结尾 */
+    fprintf(out, "static const char mo_catalog_%s_pool[] = {\n", name);
+    for (i = 0; i < ctx->num_strings; i++)
+    {
+        const char* original = mo_entry_original(ctx, i, &orig_lengths[i]);
+        const char* translation = mo_entry_translation(ctx, i, &trans_lengths[i]);
+    
+        orig_offsets[i] = (uint32_t)pool_size;
+        mo_gen_bytes(out, (const uint8_t*)original, (size_t)orig_lengths[i] + 1);
+        pool_size += (size_t)orig_lengths[i] + 1;
+    
+        trans_offsets[i] = (uint32_t)pool_size;
+        mo_gen_bytes(out, (const uint8_t*)translation, (size_t)trans_lengths[i] + 1);
+        pool_size += (size_t)trans_lengths[i] + 1;
+    }
+    if (pool_size == 0)
+    {
+        fprintf(out, "    0\n");
+    }
+    fprintf(out, "};\n\n");
+    
+    /* 字符串表按文件顺序排列（完美哈希表中的序号指向这里），使用主机字节序 */
+    mo_gen_table(out, name, "orig_table", orig_lengths, orig_offsets, ctx->num_strings);
+    mo_gen_table(out, name, "trans_table", trans_lengths, trans_offsets, ctx->num_strings);
+    
+    /* 完美哈希表，转换为主机整数后输出，由目标平台的编译器决定字节序 */
+    index = mo_gen_load_words(ctx, ctx->mph_index, ctx->mph_slots, sizeof(uint32_t));
+    overflow = mo_gen_load_words(ctx, ctx->mph_overflow, ctx->mph_overflow_count, sizeof(uint32_t));
+    pilots = mo_gen_load_words(ctx, ctx->mph_pilots, ctx->mph_buckets, sizeof(uint16_t));
+    if (!index || !overflow || !pilots)
+    {
+        goto cleanup;
+    }
+    mo_gen_words(out, "uint32_t", name, "mph_index", index, ctx->mph_slots);
+    mo_gen_words(out, "uint32_t", name, "mph_overflow", overflow, ctx->mph_overflow_count);
+    mo_gen_words(out, "uint16_t", name, "mph_pilots", pilots, ctx->mph_buckets);
+    
+    /* 复数规则和头部元数据是单独的常量，上下文只保存指向它们的指针 */
+    fprintf(out, "static const mo_plural_expr_t mo_catalog_%s_plural = {\n", name);
+    if (ctx->plural->code_len > 0)
+    {
+        fprintf(out, "    .code = {\n");
+        for (i = 0; i < ctx->plural->code_len; i++)
+        {
+            fprintf(out, "        { %u, %uu },\n", ctx->plural->code[i].op, ctx->plural->code[i].arg);
+        }
+        fprintf(out, "    },\n");
+    }
+    fprintf(out, "    .code_len = %uu,\n", ctx->plural->code_len);
+    fprintf(out, "    .nplurals = %uu,\n", ctx->plural->nplurals);
+    fprintf(out, "};\n\n");
+    
+    fprintf(out, "static const mo_metadata_t mo_catalog_%s_metadata = {\n", name);
+    mo_gen_field(out, "project_id_version", ctx->metadata->project_id_version);
+    mo_gen_field(out, "po_revision_date", ctx->metadata->po_revision_date);
+    mo_gen_field(out, "last_translator", ctx->metadata->last_translator);
+    mo_gen_field(out, "language_team", ctx->metadata->language_team);
+    mo_gen_field(out, "language", ctx->metadata->language);
+    mo_gen_field(out, "content_type", ctx->metadata->content_type);
+    mo_gen_field(out, "charset", ctx->metadata->charset);
+    mo_gen_field(out, "plural_forms", ctx->metadata->plural_forms);
+    fprintf(out, "    .nplurals = %uu,\n", ctx->metadata->nplurals);
+    fprintf(out, "};\n\n");
+    
+    /* 静态初始化的上下文，其余数据都由指针引用，可写内存中只有查找缓存、统计计数等状态 */
+    fprintf(out, "mo_context_t mo_catalog_%s = {\n", name);
+    fprintf(out, "    .data = (const uint8_t*)mo_catalog_%s_pool,\n", name);
+    fprintf(out, "    .size = sizeof(mo_catalog_%s_pool),\n", name);
+    fprintf(out, "    .is_static = true,\n");
+    fprintf(out, "    .orig_table = mo_catalog_%s_orig_table,\n", name);
+    fprintf(out, "    .trans_table = mo_catalog_%s_trans_table,\n", name);
+    fprintf(out, "    .trans_data = (const uint8_t*)mo_catalog_%s_pool,\n", name);
+    fprintf(out, "    .num_strings = %uu,\n", ctx->num_strings);
+    fprintf(out, "    .plural = &mo_catalog_%s_plural,\n", name);
+    fprintf(out, "    .header_index = %uu,\n", ctx->header_index);
+    fprintf(out, "    .metadata = &mo_catalog_%s_metadata,\n", name);
+    fprintf(out, "    .search = &mo_search_mph,\n");
+    fprintf(out, "    .mph_index = mo_catalog_%s_mph_index,\n", name);
+    fprintf(out, "    .mph_remap = mo_catalog_%s_mph_index + %uu,\n", name, ctx->mph_keys);
+    fprintf(out, "    .mph_overflow = mo_catalog_%s_mph_overflow,\n", name);
+    fprintf(out, "    .mph_pilots = mo_catalog_%s_mph_pilots,\n", name);
+    fprintf(out, "    .mph_keys = %uu,\n", ctx->mph_keys);
+    fprintf(out, "    .mph_overflow_count = %uu,\n", ctx->mph_overflow_count);
+    fprintf(out, "    .mph_buckets = %uu,\n", ctx->mph_buckets);
+    fprintf(out, "    .mph_slots = %uu,\n", ctx->mph_slots);
+    fprintf(out, "    .mph_seed = 0x%016llxull,\n", (unsigned long long)ctx->mph_seed);
+    fprintf(out, "};\n");
+    
+    result = ferror(out) ? 1 : 0;
+    
+cleanup:
+    free(orig_lengths);
+    free(orig_offsets);
+    free(trans_lengths);
+    free(trans_offsets);
+    free(index);
+    free(overflow);
+    free(pilots);
+    return result;
+}
+
+/**
+ * @brief 生成头文件
+ */
+static int mo_gen_header(const char* name, FILE* out)
+{
+    fprintf(out, "/* 由mo_gen_c生成，请勿手动修改 */\n\n");
+    fprintf(out, "#ifndef MO_CATALOG_%s_H\n", name);
+    fprintf(out, "#define MO_CATALOG_%s_H\n\n", name);
+    fprintf(out, "#include \"mo_parser.h\"\n\n");
+    fprintf(out, "#ifdef __cplusplus\nextern \"C\" {\n#endif\n\n");
+    fprintf(out, "/** @brief 编译进程序的翻译目录，无需创建和释放 */\n");
+    fprintf(out, "extern mo_context_t mo_catalog_%s;\n\n", name);
+    fprintf(out, "#ifdef __cplusplus\n}\n#endif\n\n");
+    fprintf(out, "#endif /* MO_CATALOG_%s_H */\n", name);
+    return ferror(out) ? 1 : 0;
+}
+
+/**
+ * @brief 加载输入目录，按扩展名区分.po和.mo
+ */
+static mo_error_t mo_gen_load(const char* filename, const mo_options_t* options,
+                              mo_context_t** ctx)
+{
+    size_t len = strlen(filename);
+    
+    if (len > 3 && strcmp(filename + len - 3, ".po") == 0)
+    {
+        return mo_context_create_from_po(filename, options, ctx);
+    }
+    return mo_context_create_ex(filename, options, ctx);
+}
+
+int main(int argc, char* argv[])
+{
+    mo_options_t options;
+    mo_context_t* ctx = NULL;
+    char mph_path[1024];
+    FILE* source = NULL;
+    FILE* header = NULL;
+    mo_error_t err;
+    int result = 1;
+    
+    if (argc != 5)
+    {
+        fprintf(stderr, "Usage: %s <input.mo|input.po> <name> <output.c> <output.h>\n", argv[0]);
+        return 1;
+    }
+    
+    /* 先为目录构建完美哈希，再按MPH策略加载得到全部索引数据 */
+    snprintf(mph_path, sizeof(mph_path), "%s.mph.tmp", argv[3]);
+    mo_options_init(&options);
+    options.search_method = MO_SEARCH_LINEAR;
+    err = mo_gen_load(argv[1], &options, &ctx);
+    if (err == MO_SUCCESS)
+    {
+        err = mo_context_save_mph(ctx, mph_path);
+        mo_context_free(ctx);
+        ctx = NULL;
+    }
+    if (err == MO_SUCCESS)
+    {
+        options.search_method = MO_SEARCH_MPH;
+        err = mo_context_create_ex(mph_path, &options, &ctx);
+    }
+    remove(mph_path);
+    if (err != MO_SUCCESS)
+    {
+        fprintf(stderr, "Failed to load %s: %s\n", argv[1], mo_error_string(err));
+        goto cleanup;
+    }
+    if (ctx->search != &mo_search_mph)
+    {
+        fprintf(stderr, "Failed to build perfect hash for %s\n", argv[1]);
+        goto cleanup;
+    }
+    
+    source = fopen(argv[3], "w");
+    header = fopen(argv[4], "w");
+    if (!source || !header)
+    {
+        fprintf(stderr, "Failed to open output files\n");
+        goto cleanup;
+    }
+    
+    result = mo_gen_source(ctx, argv[2], source) | mo_gen_header(argv[2], header);
+    
+cleanup:
+    if (source && fclose(source) != 0)
+    {
+        result = 1;
+    }
+    if (header && fclose(header) != 0)
+    {
+        result = 1;
+    }
+    if (result != 0)
+    {
+        remove(argv[3]);
+        remove(argv[4]);
+    }
+    mo_context_free(ctx);
+    return result;
+}
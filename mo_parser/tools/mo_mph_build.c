@@ -0,0 +1,47 @@
+/**
+ * @file mo_mph_build.c
+ * @brief 构建期工具：为MO文件生成最小完美哈希段
+ *
+ * 用法：mo_mph_build <input.mo> <output.mo>
+ * 输出文件为输入数据追加哈希段，可直接用MO_SEARCH_MPH策略加载。
+ */
+
+#include <stdio.h>
+#include "mo_parser.h"
+
+int main(int argc, char* argv[])
+{
+    mo_options_t options;
+    mo_context_t* ctx = NULL;
+    mo_error_t err;
+    
+    if (argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <input.mo> <output.mo>\n", argv[0]);
+        return 1;
+    }
+    
+    /* 只需读取字符串表，线性策略不构建任何索引 */
+    mo_options_init(&options);
+    options.search_method = MO_SEARCH_LINEAR;
+    
+    err = mo_context_create_ex(argv[1], &options, &ctx);
+    if (err != MO_SUCCESS)
+    {
+        fprintf(stderr, "Failed to load %s: %s\n", argv[1], mo_error_string(err));
+        return 1;
+    }
+    
+    err = mo_context_save_mph(ctx, argv[2]);
+    if (err != MO_SUCCESS)
+    {
+        fprintf(stderr, "Failed to write %s: %s\n", argv[2], mo_error_string(err));
+    }
+    else
+    {
+        printf("%s: %u strings\n", argv[2], mo_get_string_count(ctx));
+    }
+    
+    mo_context_free(ctx);
+    return err == MO_SUCCESS ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file mo_msgfmt.c
+ * @brief 构建期工具：把.po/.mo文件编译为为查找优化的MO文件（无需GNU gettext）
+ *
+ * 用法：mo_msgfmt [--hot <keys.txt>] <output.mo> <input.po|input.mo>...
+ * 多个输入合并为一个目录，重复的键视为错误。keys.txt每行一个常用的msgid，
+ * 带上下文时写作"msgctxt<TAB>msgid"，按行的顺序排在字符串区的最前面。
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "mo_writer.h"
+
+/**
+ * @brief 读取常用条目列表
+ */
+static mo_error_t read_hot_keys(mo_writer_t* writer, const char* filename)
+{
+    char line[4096];
+    mo_error_t err = MO_SUCCESS;
+    FILE* file = fopen(filename, "r");
+    
+    if (!file)
+    {
+        return MO_ERROR_FILE_NOT_FOUND;
+    }
+    
+    while (err == MO_SUCCESS && fgets(line, sizeof(line), file))
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0')
+        {
+            continue;
+        }
+    
+        char* tab = strchr(line, '\t');
+        if (tab)
+        {
+            *tab = '\0';
+            err = mo_writer_add_hot(writer, line, tab + 1);
+        }
+        else
+        {
+            err = mo_writer_add_hot(writer, NULL, line);
+        }
+    }
+    
+    fclose(file);
+    return err;
+}
+
+/**
+ * @brief 加入一个输入文件，按扩展名区分.po和.mo
+ */
+static mo_error_t add_input(mo_writer_t* writer, const char* filename)
+{
+    size_t len = strlen(filename);
+    mo_options_t options;
+    mo_context_t* ctx = NULL;
+    mo_error_t err;
+    
+    if (len > 3 && strcmp(filename + len - 3, ".po") == 0)
+    {
+        return mo_writer_add_po(writer, filename);
+    }
+    
+    /* 只需复制条目，线性策略不构建任何索引 */
+    mo_options_init(&options);
+    options.search_method = MO_SEARCH_LINEAR;
+    options.keep_charset = true;
+    err = mo_context_create_ex(filename, &options, &ctx);
+    if (err == MO_SUCCESS)
+    {
+        err = mo_writer_add_catalog(writer, ctx);
+    }
+    mo_context_free(ctx);
+    return err;
+}
+
+int main(int argc, char* argv[])
+{
+    mo_writer_t* writer = NULL;
+    const char* hot = NULL;
+    mo_error_t err;
+    int arg = 1;
+    
+    if (argc > 2 && strcmp(argv[1], "--hot") == 0)
+    {
+        hot = argv[2];
+        arg = 3;
+    }
+    if (argc - arg < 2)
+    {
+        fprintf(stderr, "Usage: %s [--hot <keys.txt>] <output.mo> <input.po|input.mo>...\n", argv[0]);
+        return 1;
+    }
+    
+    err = mo_writer_create(&writer);
+    if (err != MO_SUCCESS)
+    {
+        fprintf(stderr, "Failed to create writer: %s\n", mo_error_string(err));
+        return 1;
+    }
+    
+    for (int i = arg + 1; i < argc && err == MO_SUCCESS; i++)
+    {
+        err = add_input(writer, argv[i]);
+        if (err != MO_SUCCESS)
+        {
+            fprintf(stderr, "Failed to read %s: %s\n", argv[i], mo_error_string(err));
+        }
+    }
+    
+    if (err == MO_SUCCESS && hot)
+    {
+        err = read_hot_keys(writer, hot);
+        if (err != MO_SUCCESS)
+        {
+            fprintf(stderr, "Failed to read %s: %s\n", hot, mo_error_string(err));
+        }
+    }
+    
+    if (err == MO_SUCCESS)
+    {
+        err = mo_writer_save(writer, argv[arg]);
+        if (err != MO_SUCCESS)
+        {
+            fprintf(stderr, "Failed to write %s: %s\n", argv[arg], mo_error_string(err));
+        }
+        else
+        {
+            printf("%s: %u strings\n", argv[arg], mo_writer_count(writer));
+        }
+    }
+    
+    mo_writer_free(writer);
+    return err == MO_SUCCESS ? 0 : 1;
+}